@@ -80,6 +80,7 @@ namespace
 #endif
     bool plot_files_output;
     int  checkpoint_nfiles;
+    int  checkpoint_max_pending;
     int  regrid_on_restart;
     int  use_efficient_regrid;
     int  plotfile_on_restart;
@@ -116,6 +117,7 @@ Amr::Initialize ()
 #endif
     plot_files_output        = true;
     checkpoint_nfiles        = 64;
+    checkpoint_max_pending   = 2;
     regrid_on_restart        = 0;
     use_efficient_regrid     = 0;
     plotfile_on_restart      = 0;
@@ -740,6 +742,8 @@ Amr::deleteDeriveSmallPlotVar (const std::string& name)
 
 Amr::~Amr ()
 {
+    finishAsyncCheckPoints();
+
     levelbld->variableCleanUp();
 
     Amr::Finalize();
@@ -1710,6 +1714,17 @@ Amr::checkPoint ()
     BL_PROFILE_REGION_START("Amr::checkPoint()");
     BL_PROFILE("Amr::checkPoint()");
 
+    const std::string& ckfile = amrex::Concatenate(check_file_root,level_steps[0],file_name_digits);
+
+    if (AsyncOut::UseAsyncOut()) {
+        // Make room for this checkpoint, and finish the one with the same name.
+        int max_pending = checkpoint_max_pending-1;
+        for (auto const& ck : pending_checkpoints) {
+            if (ck.name == ckfile) { max_pending = 0; }
+        }
+        finishAsyncCheckPoints(max_pending);
+    }
+
     VisMF::SetNOutFiles(checkpoint_nfiles);
     //
     // In checkpoint files always write out FABs in NATIVE format.
@@ -1723,8 +1738,6 @@ Amr::checkPoint ()
 
     auto dCheckPointTime0 = amrex::second();
 
-    const std::string& ckfile = amrex::Concatenate(check_file_root,level_steps[0],file_name_digits);
-
     if(verbose > 0) {
         amrex::Print() << "CHECKPOINT: file = " << ckfile << "\n";
     }
@@ -1736,8 +1749,9 @@ Amr::checkPoint ()
   amrex::StreamRetry sretry(ckfile, abort_on_stream_retry_failure,
                              stream_max_tries);
 
-  // For AsyncOut, we need to turn off stream retry and write to ckfile directly.
-  const std::string ckfileTemp = (AsyncOut::UseAsyncOut()) ? ckfile : (ckfile + ".temp");
+  // For AsyncOut, we need to turn off stream retry.  The temporary directory
+  // is renamed by finishAsyncCheckPoints once it has been written.
+  const std::string ckfileTemp = ckfile + ".temp";
 
   while(sretry.TryFileOutput()) {
 
@@ -1862,6 +1876,7 @@ Amr::checkPoint ()
     }
 
     if (AsyncOut::UseAsyncOut()) {
+        pending_checkpoints.push_back({ckfile, ckfileTemp, AsyncOut::SubmitFence()});
         break;
     } else {
         ParallelDescriptor::Barrier("Amr::checkPoint::end");
@@ -1883,6 +1898,71 @@ Amr::checkPoint ()
   BL_PROFILE_REGION_STOP("Amr::checkPoint()");
 }
 
+void
+Amr::finishAsyncCheckPoints (int max_pending)
+{
+    if (pending_checkpoints.empty()) {
+        return;
+    }
+
+    BL_PROFILE("Amr::finishAsyncCheckPoints()");
+
+    while ( ! pending_checkpoints.empty())
+    {
+        PendingCheckPoint& ck = pending_checkpoints.front();
+
+        double dWaitTime = 0.0;
+        if (static_cast<int>(pending_checkpoints.size()) > max_pending) {
+            auto dWaitTime0 = amrex::second();
+            ck.fence.wait();
+            dWaitTime = amrex::second() - dWaitTime0;
+        }
+
+        // The checkpoint is complete once all the processes have written it.
+        bool ready = ck.fence.isReady();
+        ParallelDescriptor::ReduceBoolAnd(ready);
+        if ( ! ready) {
+            break;
+        }
+
+        if (ParallelDescriptor::IOProcessor()) {
+            std::rename(ck.tempname.c_str(), ck.name.c_str());
+        }
+
+        // The background work since the last finished checkpoint
+        const AsyncOut::Stats stats = AsyncOut::GetStats();
+        const Long njobs = stats.njobs - async_stats.njobs;
+        Long nbytes = stats.nbytes - async_stats.nbytes;
+        double dWriteTime = stats.write_time - async_stats.write_time;
+        const double dTurnTime = stats.wait_time - async_stats.wait_time;
+        async_stats = stats;
+
+#ifdef AMREX_TINY_PROFILING
+        TinyProfiler::AddTime("AsyncOut::write()", njobs, dWriteTime-dTurnTime);
+        TinyProfiler::AddTime("AsyncOut::Wait()", njobs, dTurnTime);
+#else
+        amrex::ignore_unused(njobs,dTurnTime);
+#endif
+
+        if (verbose > 0)
+        {
+            // The time the background writes overlapped with the computation
+            double dOverlapTime = std::max(dWriteTime - dWaitTime, 0.0);
+
+            ParallelDescriptor::ReduceLongSum(nbytes, ParallelDescriptor::IOProcessorNumber());
+            ParallelDescriptor::ReduceRealMax(dWriteTime, ParallelDescriptor::IOProcessorNumber());
+            ParallelDescriptor::ReduceRealMin(dOverlapTime, ParallelDescriptor::IOProcessorNumber());
+
+            amrex::Print() << "CHECKPOINT: finished " << ck.name << ": "
+                           << nbytes/1.e6 << " MB written in " << dWriteTime
+                           << " secs. in the background, " << dOverlapTime
+                           << " secs. overlapped with the computation" << '\n';
+        }
+
+        pending_checkpoints.pop_front();
+    }
+}
+
 void
 Amr::RegridOnly (Real time, bool do_io)
 {
@@ -2317,6 +2397,8 @@ Amr::coarseTimeStep (Real stop_time)
         writeSmallPlotFile();
     }
 
+    finishAsyncCheckPoints(checkpoint_max_pending);
+
     updateInSitu();
 
     bUserStopRequest = to_stop;
@@ -3188,6 +3270,11 @@ Amr::initPltAndChk ()
     //
     if (plot_nfiles       == -1) plot_nfiles       = ParallelDescriptor::NProcs();
     if (checkpoint_nfiles == -1) checkpoint_nfiles = ParallelDescriptor::NProcs();
+    //
+    // The number of asynchronous checkpoints that can be written at a time.
+    //
+    pp.queryAdd("async_checkpoint_max_pending", checkpoint_max_pending);
+    checkpoint_max_pending = std::max(checkpoint_max_pending, 1);
 
     check_file_root = "chk";
     pp.queryAdd("check_file",check_file_root);
@@ -4,6 +4,8 @@
 #include <AMReX_Cluster.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_ParallelDescriptor.H>
+
+#include <algorithm>
 #include <AMReX_Print.H>
 
 namespace amrex {
@@ -105,6 +107,7 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.queryAdd("n_proper",n_proper);
     pp.queryAdd("grid_eff",grid_eff);
+    pp.queryAdd("parallel_cluster",use_parallel_cluster);
     int cnt = pp.countval("n_error_buf");
     if (cnt > 0) {
         Vector<int> neb;
@@ -672,13 +675,23 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         tags.setVal(p_n_comp_ba[levc],TagBox::CLEAR);
         p_n_comp_ba[levc].clear();
         //
-        // Create initial cluster containing all tagged points.
+        // Create initial cluster containing all tagged points.  With
+        // parallel clustering, each process only keeps its own tags.
         //
         Gpu::PinnedVector<IntVect> tagvec;
-        tags.collate(tagvec);
+        Vector<int> tagoffset;
+        Long ntags;
+        if (use_parallel_cluster) {
+            tags.local_collate(tagvec, tagoffset);
+            ntags = tagvec.size();
+            ParallelDescriptor::ReduceLongSum(ntags);
+        } else {
+            tags.collate(tagvec);
+            ntags = tagvec.size();
+        }
         tags.clear();
 
-        if (tagvec.size() > 0)
+        if (ntags > 0)
         {
             //
             // Created new level, now generate efficient grids.
@@ -689,32 +702,91 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
 
             if (levf > useFixedUpToLevel()) {
                 BoxList new_bx;
-                if (ParallelDescriptor::IOProcessor()) {
-                    BL_PROFILE("AmrMesh-cluster");
+                if (use_parallel_cluster) {
+                    BL_PROFILE("AmrMesh-cluster-parallel");
                     //
-                    // Construct initial cluster.
+                    // Cluster the tags of each local TagBox separately, so
+                    // that the grids do not depend on the distribution map.
+                    // The tags are not duplicated across TagBoxes, but the
+                    // clusters of different TagBoxes may overlap.
                     //
-                    ClusterList clist(&tagvec[0], tagvec.size());
-                    if (use_new_chop) {
-                        clist.new_chop(grid_eff);
-                    } else {
-                        clist.chop(grid_eff);
+                    const int nfabs = static_cast<int>(tagoffset.size())-1;
+                    Vector<BoxList> fab_bx(nfabs);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+                    for (int li = 0; li < nfabs; ++li) {
+                        const int n = tagoffset[li+1] - tagoffset[li];
+                        if (n > 0) {
+                            ClusterList clist(tagvec.data()+tagoffset[li], n);
+                            if (use_new_chop) {
+                                clist.new_chop(grid_eff);
+                            } else {
+                                clist.chop(grid_eff);
+                            }
+                            clist.boxList(fab_bx[li]);
+                        }
                     }
-                    clist.intersect(p_n_ba[levc]);
                     //
-                    // Efficient properly nested Clusters have been constructed
-                    // now generate list of grids at level levf.
+                    // Keep the clusters properly nested.
                     //
-                    clist.boxList(new_bx);
-                    new_bx.refine(bf_lev[levc]);
-                    new_bx.simplify();
-
-                    if (new_bx.size()>0) {
-                        // Chop new grids outside domain
+                    Vector<Box> bxs;
+                    std::vector<std::pair<int,Box> > isects;
+                    for (auto const& bl : fab_bx) {
+                        for (auto const& b : bl) {
+                            if (p_n_ba[levc].contains(b,true)) {
+                                bxs.push_back(b);
+                            } else {
+                                p_n_ba[levc].intersections(b,isects);
+                                for (auto const& is : isects) {
+                                    bxs.push_back(is.second);
+                                }
+                            }
+                        }
+                    }
+                    p_n_ba[levc].clear();
+                    //
+                    // Merge the clusters of all processes.  They are sorted
+                    // so that the result does not depend on their order.
+                    //
+                    AllGatherBoxes(bxs);
+                    if (!bxs.empty()) {
+                        std::sort(bxs.begin(), bxs.end());
+                        BoxArray ba(BoxList(std::move(bxs)));
+                        ba.removeOverlap();
+                        new_bx = ba.boxList();
+                        new_bx.refine(bf_lev[levc]);
+                        new_bx.simplify();
                         new_bx.intersect(Geom(levc).Domain());
                     }
+                } else {
+                    if (ParallelDescriptor::IOProcessor()) {
+                        BL_PROFILE("AmrMesh-cluster");
+                        //
+                        // Construct initial cluster.
+                        //
+                        ClusterList clist(&tagvec[0], tagvec.size());
+                        if (use_new_chop) {
+                            clist.new_chop(grid_eff);
+                        } else {
+                            clist.chop(grid_eff);
+                        }
+                        clist.intersect(p_n_ba[levc]);
+                        //
+                        // Efficient properly nested Clusters have been constructed
+                        // now generate list of grids at level levf.
+                        //
+                        clist.boxList(new_bx);
+                        new_bx.refine(bf_lev[levc]);
+                        new_bx.simplify();
+
+                        if (new_bx.size()>0) {
+                            // Chop new grids outside domain
+                            new_bx.intersect(Geom(levc).Domain());
+                        }
+                    }
+                    new_bx.Bcast();  // Broadcast the new BoxList to other processes
                 }
-                new_bx.Bcast();  // Broadcast the new BoxList to other processes
 
                 //
                 // Refine up to levf.
@@ -1038,6 +1110,7 @@ std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
     os << "  check_input = " << amr_mesh.check_input  << "\n";
     os << "  use_new_chop = " << amr_mesh.use_new_chop << "\n";
     os << "  iterate_on_new_grids = " << amr_mesh.iterate_on_new_grids << "\n";
+    os << "  use_parallel_cluster = " << amr_mesh.use_parallel_cluster << "\n";
     return os;
 }
 
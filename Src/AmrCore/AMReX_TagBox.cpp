@@ -376,8 +376,9 @@ TagBoxArray::mapPeriodicRemoveDuplicates (const Geometry& geom)
 }
 
 void
-TagBoxArray::local_collate_cpu (Gpu::PinnedVector<IntVect>& v) const
+TagBoxArray::local_collate_cpu (Gpu::PinnedVector<IntVect>& v, Vector<int>& offset) const
 {
+    offset.assign(this->local_size()+1, 0);
     if (this->local_size() == 0) return;
 
     Vector<int> count(this->local_size());
@@ -396,7 +397,6 @@ TagBoxArray::local_collate_cpu (Gpu::PinnedVector<IntVect>& v) const
         count[fai.LocalIndex()] = c;
     }
 
-    Vector<int> offset(count.size()+1, 0);
     std::partial_sum(count.begin(), count.end(), offset.begin()+1);
 
     v.resize(offset.back());
@@ -425,9 +425,10 @@ TagBoxArray::local_collate_cpu (Gpu::PinnedVector<IntVect>& v) const
 
 #ifdef AMREX_USE_GPU
 void
-TagBoxArray::local_collate_gpu (Gpu::PinnedVector<IntVect>& v) const
+TagBoxArray::local_collate_gpu (Gpu::PinnedVector<IntVect>& v, Vector<int>& offset) const
 {
     const int nfabs = this->local_size();
+    offset.assign(nfabs+1, 0);
     if (nfabs == 0) return;
 
     constexpr int block_size = 128;
@@ -499,6 +500,10 @@ TagBoxArray::local_collate_gpu (Gpu::PinnedVector<IntVect>& v) const
     std::partial_sum(hv_ntags.begin(), hv_ntags.end(), hv_tags_offset.begin()+1);
     int ntotaltags = hv_tags_offset.back();
 
+    for (int li = 0; li < nfabs; ++li) {
+        offset[li+1] = hv_tags_offset[blockoffset[li+1]];
+    }
+
     if (ntotaltags == 0) return;
 
     Gpu::NonManagedDeviceVector<int> dv_tags_offset(ntotblocks);
@@ -591,19 +596,33 @@ TagBoxArray::local_collate_gpu (Gpu::PinnedVector<IntVect>& v) const
 #endif
 
 void
-TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+TagBoxArray::local_collate (Gpu::PinnedVector<IntVect>& TheLocalCollateSpace) const
 {
-    BL_PROFILE("TagBoxArray::collate()");
+    Vector<int> offset;
+    local_collate(TheLocalCollateSpace, offset);
+}
 
-    Gpu::PinnedVector<IntVect> TheLocalCollateSpace;
+void
+TagBoxArray::local_collate (Gpu::PinnedVector<IntVect>& TheLocalCollateSpace,
+                            Vector<int>& offset) const
+{
 #ifdef AMREX_USE_GPU
     if (Gpu::inLaunchRegion()) {
-        local_collate_gpu(TheLocalCollateSpace);
+        local_collate_gpu(TheLocalCollateSpace, offset);
     } else
 #endif
     {
-        local_collate_cpu(TheLocalCollateSpace);
+        local_collate_cpu(TheLocalCollateSpace, offset);
     }
+}
+
+void
+TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+{
+    BL_PROFILE("TagBoxArray::collate()");
+
+    Gpu::PinnedVector<IntVect> TheLocalCollateSpace;
+    local_collate(TheLocalCollateSpace);
 
     Long count = TheLocalCollateSpace.size();
 
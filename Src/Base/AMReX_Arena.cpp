@@ -3,6 +3,8 @@
 #include <AMReX_BArena.H>
 #include <AMReX_CArena.H>
 #include <AMReX_PArena.H>
+#include <AMReX_TArena.H>
+#include <AMReX_ThreadCacheArena.H>
 
 #include <AMReX.H>
 #include <AMReX_Print.H>
@@ -49,6 +51,21 @@ namespace {
     bool the_arena_is_managed = true;
 #endif
     bool abort_on_out_of_gpu_memory = false;
+#if defined(BL_COALESCE_FABS) || defined(AMREX_USE_GPU)
+    std::string the_arena_type = "CArena";
+#else
+    std::string the_arena_type = "BArena";
+#endif
+    std::string the_device_arena_type = "CArena";
+    std::string the_managed_arena_type = "CArena";
+    std::string the_pinned_arena_type = "CArena";
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+    bool the_arena_thread_cache = false;
+    int the_arena_thread_cache_size = 16;
+    Long the_arena_thread_cache_max_bytes = 64L*1024L*1024L;
+    // The arena behind the thread cache front-end, if the_arena is one.
+    Arena* the_arena_parent = nullptr;
+#endif
 }
 
 const std::size_t Arena::align_size;
@@ -256,6 +273,43 @@ namespace {
         static BArena the_barena;
         return &the_barena;
     }
+
+    Arena* NewCoalescingArena (std::string const& type, ArenaInfo const& info)
+    {
+        if (type == "CArena") {
+            return new CArena(0, info);
+        } else if (type == "TArena") {
+            return new TArena(0, info);
+        } else {
+            amrex::Abort("Arena::Initialize: unknown arena type " + type);
+            return nullptr;
+        }
+    }
+
+    void PrintArenaUsage (Arena* arena, std::string const& name)
+    {
+        if (CArena* p = dynamic_cast<CArena*>(arena)) {
+            p->PrintUsage(name);
+        } else if (TArena* q = dynamic_cast<TArena*>(arena)) {
+            q->PrintUsage(name);
+        } else if (ThreadCacheArena* r = dynamic_cast<ThreadCacheArena*>(arena)) {
+            r->PrintUsage(name);
+            PrintArenaUsage(r->parent(), name);
+        }
+    }
+
+    void PrintArenaUsage (Arena* arena, std::ostream& os, std::string const& name,
+                          std::string const& space)
+    {
+        if (CArena* p = dynamic_cast<CArena*>(arena)) {
+            p->PrintUsage(os, name, space);
+        } else if (TArena* q = dynamic_cast<TArena*>(arena)) {
+            q->PrintUsage(os, name, space);
+        } else if (ThreadCacheArena* r = dynamic_cast<ThreadCacheArena*>(arena)) {
+            r->PrintUsage(os, name, space);
+            PrintArenaUsage(r->parent(), os, name, space);
+        }
+    }
 }
 
 void
@@ -294,22 +348,47 @@ Arena::Initialize ()
     pp.queryAdd(  "the_async_arena_release_threshold",   the_async_arena_release_threshold);
     pp.queryAdd("the_arena_is_managed", the_arena_is_managed);
     pp.queryAdd("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
+    pp.queryAdd(        "the_arena_type",         the_arena_type);
+    pp.queryAdd( "the_device_arena_type",  the_device_arena_type);
+    pp.queryAdd("the_managed_arena_type", the_managed_arena_type);
+    pp.queryAdd( "the_pinned_arena_type",  the_pinned_arena_type);
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+    pp.queryAdd("the_arena_thread_cache", the_arena_thread_cache);
+    pp.queryAdd("the_arena_thread_cache_size", the_arena_thread_cache_size);
+    pp.queryAdd("the_arena_thread_cache_max_bytes", the_arena_thread_cache_max_bytes);
+#endif
 
     {
 #if defined(BL_COALESCE_FABS) || defined(AMREX_USE_GPU)
         ArenaInfo ai{};
         ai.SetReleaseThreshold(the_arena_release_threshold);
         if (the_arena_is_managed) {
-            the_arena = new CArena(0, ai.SetPreferred());
+            the_arena = NewCoalescingArena(the_arena_type, ai.SetPreferred());
         } else {
-            the_arena = new CArena(0, ai.SetDeviceMemory());
+            the_arena = NewCoalescingArena(the_arena_type, ai.SetDeviceMemory());
         }
 #ifdef AMREX_USE_GPU
         void *p = the_arena->alloc(static_cast<std::size_t>(the_arena_init_size));
         the_arena->free(p);
 #endif
 #else
-        the_arena = The_BArena();
+        if (the_arena_type == "BArena") {
+            the_arena = The_BArena();
+        } else {
+            the_arena = NewCoalescingArena(the_arena_type, ArenaInfo{}.SetReleaseThreshold
+                                           (the_arena_release_threshold));
+            if (the_arena_init_size > 0) {
+                void *p = the_arena->alloc(static_cast<std::size_t>(the_arena_init_size));
+                the_arena->free(p);
+            }
+        }
+#ifdef AMREX_USE_OMP
+        if (the_arena_thread_cache) {
+            the_arena_parent = the_arena;
+            the_arena = new ThreadCacheArena(the_arena_parent, the_arena_thread_cache_size,
+                                             static_cast<std::size_t>(the_arena_thread_cache_max_bytes));
+        }
+#endif
 #endif
     }
 
@@ -319,8 +398,9 @@ Arena::Initialize ()
     if (the_arena->isDevice()) {
         the_device_arena = the_arena;
     } else {
-        the_device_arena = new CArena(0, ArenaInfo{}.SetDeviceMemory().SetReleaseThreshold
-                                      (the_device_arena_release_threshold));
+        the_device_arena = NewCoalescingArena(the_device_arena_type,
+                                              ArenaInfo{}.SetDeviceMemory().SetReleaseThreshold
+                                              (the_device_arena_release_threshold));
     }
 #else
     the_device_arena = The_BArena();
@@ -330,8 +410,9 @@ Arena::Initialize ()
     if (the_arena->isManaged()) {
         the_managed_arena = the_arena;
     } else {
-        the_managed_arena = new CArena(0, ArenaInfo{}.SetReleaseThreshold
-                                       (the_managed_arena_release_threshold));
+        the_managed_arena = NewCoalescingArena(the_managed_arena_type,
+                                               ArenaInfo{}.SetReleaseThreshold
+                                               (the_managed_arena_release_threshold));
     }
 #else
     the_managed_arena = The_BArena();
@@ -339,8 +420,9 @@ Arena::Initialize ()
 
     // When USE_CUDA=FALSE, we call mlock to pin the cpu memory.
     // When USE_CUDA=TRUE, we call cudaHostAlloc to pin the host memory.
-    the_pinned_arena = new CArena(0, ArenaInfo{}.SetHostAlloc().SetReleaseThreshold
-                                  (the_pinned_arena_release_threshold));
+    the_pinned_arena = NewCoalescingArena(the_pinned_arena_type,
+                                          ArenaInfo{}.SetHostAlloc().SetReleaseThreshold
+                                          (the_pinned_arena_release_threshold));
 
     if (the_device_arena_init_size > 0 && the_device_arena != the_arena) {
         void *p = the_device_arena->alloc(the_device_arena_init_size);
@@ -395,28 +477,16 @@ Arena::PrintUsage ()
     }
 #endif
     if (The_Arena()) {
-        CArena* p = dynamic_cast<CArena*>(The_Arena());
-        if (p) {
-            p->PrintUsage("The         Arena");
-        }
+        PrintArenaUsage(The_Arena(), "The         Arena");
     }
     if (The_Device_Arena() && The_Device_Arena() != The_Arena()) {
-        CArena* p = dynamic_cast<CArena*>(The_Device_Arena());
-        if (p) {
-            p->PrintUsage("The  Device Arena");
-        }
+        PrintArenaUsage(The_Device_Arena(), "The  Device Arena");
     }
     if (The_Managed_Arena() && The_Managed_Arena() != The_Arena()) {
-        CArena* p = dynamic_cast<CArena*>(The_Managed_Arena());
-        if (p) {
-            p->PrintUsage("The Managed Arena");
-        }
+        PrintArenaUsage(The_Managed_Arena(), "The Managed Arena");
     }
     if (The_Pinned_Arena()) {
-        CArena* p = dynamic_cast<CArena*>(The_Pinned_Arena());
-        if (p) {
-            p->PrintUsage("The  Pinned Arena");
-        }
+        PrintArenaUsage(The_Pinned_Arena(), "The  Pinned Arena");
     }
 }
 
@@ -440,28 +510,16 @@ Arena::PrintUsageToFiles (const std::string& filename, const std::string& messag
 #endif
 
     if (The_Arena()) {
-        CArena* p = dynamic_cast<CArena*>(The_Arena());
-        if (p) {
-            p->PrintUsage(ofs, "The         Arena", "    ");
-        }
+        PrintArenaUsage(The_Arena(), ofs, "The         Arena", "    ");
     }
     if (The_Device_Arena() && The_Device_Arena() != The_Arena()) {
-        CArena* p = dynamic_cast<CArena*>(The_Device_Arena());
-        if (p) {
-            p->PrintUsage(ofs, "The  Device Arena", "    ");
-        }
+        PrintArenaUsage(The_Device_Arena(), ofs, "The  Device Arena", "    ");
     }
     if (The_Managed_Arena() && The_Managed_Arena() != The_Arena()) {
-        CArena* p = dynamic_cast<CArena*>(The_Managed_Arena());
-        if (p) {
-            p->PrintUsage(ofs, "The Managed Arena", "    ");
-        }
+        PrintArenaUsage(The_Managed_Arena(), ofs, "The Managed Arena", "    ");
     }
     if (The_Pinned_Arena()) {
-        CArena* p = dynamic_cast<CArena*>(The_Pinned_Arena());
-        if (p) {
-            p->PrintUsage(ofs, "The  Pinned Arena", "    ");
-        }
+        PrintArenaUsage(The_Pinned_Arena(), ofs, "The  Pinned Arena", "    ");
     }
 
     ofs << "\n";
@@ -506,6 +564,15 @@ Arena::Finalize ()
         the_arena = nullptr;
     }
 
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+    if (the_arena_parent) {
+        if (!dynamic_cast<BArena*>(the_arena_parent)) {
+            delete the_arena_parent;
+        }
+        the_arena_parent = nullptr;
+    }
+#endif
+
     delete the_async_arena;
     the_async_arena = nullptr;
 
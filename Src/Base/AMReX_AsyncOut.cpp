@@ -1,11 +1,15 @@
 #include <AMReX_AsyncOut.H>
 #include <AMReX_BackgroundThread.H>
+#include <AMReX_CArena.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Vector.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
 #include <AMReX.H>
 
+#include <condition_variable>
+#include <mutex>
+
 namespace amrex {
 namespace AsyncOut {
 
@@ -13,12 +17,63 @@ namespace {
 
 int s_asyncout = false;
 int s_noutfiles = 64;
+int s_nthreads = 1;
+Long s_max_staging = -1;
 MPI_Comm s_comm = MPI_COMM_NULL;
 
-std::unique_ptr<BackgroundThread> s_thread;
+// Each thread has its own communicator for Wait and Notify.
+Vector<MPI_Comm> s_comms;
+Vector<std::unique_ptr<BackgroundThread> > s_threads;
+int s_next_thread = 0;
+thread_local int s_ithread = 0;
+
+std::unique_ptr<CArena> s_staging_arena;
+
+std::mutex s_staging_mutex;
+std::condition_variable s_staging_cond;
+Long s_staged = 0;
+
+std::mutex s_stats_mutex;
+Stats s_stats;
 
 WriteInfo s_info;
 
+std::function<void()> make_job (int ithread, std::function<void()>&& a_f)
+{
+    return [ithread, f=std::move(a_f)] ()
+    {
+        s_ithread = ithread;
+        const double t0 = amrex::second();
+        f();
+        const double dt = amrex::second() - t0;
+        std::lock_guard<std::mutex> lck(s_stats_mutex);
+        ++s_stats.njobs;
+        s_stats.write_time += dt;
+    };
+}
+
+}
+
+struct Fence::State
+{
+    std::mutex mutx;
+    std::condition_variable cond;
+    int count = 0;
+};
+
+bool Fence::isReady () const
+{
+    if (!m_state) { return true; }
+    std::lock_guard<std::mutex> lck(m_state->mutx);
+    return m_state->count == 0;
+}
+
+void Fence::wait () const
+{
+    if (m_state) {
+        std::unique_lock<std::mutex> lck(m_state->mutx);
+        m_state->cond.wait(lck, [this] () -> bool { return m_state->count == 0; });
+    }
 }
 
 void Initialize ()
@@ -28,6 +83,9 @@ void Initialize ()
     ParmParse pp("amrex");
     pp.queryAdd("async_out", s_asyncout);
     pp.queryAdd("async_out_nfiles", s_noutfiles);
+    pp.queryAdd("async_out_nthreads", s_nthreads);
+    pp.queryAdd("async_out_max_staging", s_max_staging);
+    s_nthreads = std::max(s_nthreads, 1);
 
     int nprocs = ParallelDescriptor::NProcs();
     s_noutfiles = std::min(s_noutfiles, nprocs);
@@ -50,7 +108,24 @@ void Initialize ()
 #endif
 
     if (s_asyncout) {
-        s_thread = std::make_unique<BackgroundThread>();
+        s_comms.resize(s_nthreads, MPI_COMM_NULL);
+        s_comms[0] = s_comm;
+#ifdef AMREX_USE_MPI
+        if (s_comm != MPI_COMM_NULL) {
+            for (int i = 1; i < s_nthreads; ++i) {
+                BL_MPI_REQUIRE( MPI_Comm_dup(s_comm, &s_comms[i]) );
+            }
+        }
+#endif
+        for (int i = 0; i < s_nthreads; ++i) {
+            s_threads.emplace_back(std::make_unique<BackgroundThread>());
+        }
+
+#ifdef AMREX_USE_GPU
+        s_staging_arena = std::make_unique<CArena>(0, ArenaInfo().SetHostAlloc());
+#else
+        s_staging_arena = std::make_unique<CArena>(0, ArenaInfo().SetCpuMemory());
+#endif
     }
 
     ExecOnFinalize(Finalize);
@@ -58,14 +133,20 @@ void Initialize ()
 
 void Finalize ()
 {
-    if (s_thread) {
-        s_thread.reset();
-    }
+    s_threads.clear();
+    s_staging_arena.reset();
+    s_next_thread = 0;
+    s_staged = 0;
+    s_stats = Stats{};
 
 #ifdef AMREX_USE_MPI
+    for (int i = 1; i < static_cast<int>(s_comms.size()); ++i) {
+        if (s_comms[i] != MPI_COMM_NULL) MPI_Comm_free(&s_comms[i]);
+    }
     if (s_comm != MPI_COMM_NULL) MPI_Comm_free(&s_comm);
     s_comm = MPI_COMM_NULL;
 #endif
+    s_comms.clear();
 }
 
 bool UseAsyncOut () { return s_asyncout; }
@@ -93,34 +174,106 @@ WriteInfo GetWriteInfo (int rank)
     return WriteInfo{ifile, ispot, nspots};
 }
 
+int NThreads () { return s_nthreads; }
+
 void Submit (std::function<void()>&& a_f)
 {
-    s_thread->Submit(std::move(a_f));
+    s_threads[0]->Submit(make_job(0, std::move(a_f)));
 }
 
 void Submit (std::function<void()> const& a_f)
 {
-    s_thread->Submit(a_f);
+    Submit(std::function<void()>(a_f));
+}
+
+void SubmitConcurrent (std::function<void()>&& a_f)
+{
+    const int ithread = s_next_thread;
+    s_next_thread = (s_next_thread + 1) % static_cast<int>(s_threads.size());
+    s_threads[ithread]->Submit(make_job(ithread, std::move(a_f)));
+}
+
+Fence SubmitFence ()
+{
+    Fence fence;
+    if (!s_threads.empty()) {
+        fence.m_state = std::make_shared<Fence::State>();
+        fence.m_state->count = static_cast<int>(s_threads.size());
+        for (auto& t : s_threads) {
+            t->Submit([state=fence.m_state] ()
+            {
+                std::lock_guard<std::mutex> lck(state->mutx);
+                if (--state->count == 0) {
+                    state->cond.notify_all();
+                }
+            });
+        }
+    }
+    return fence;
 }
 
 void Finish ()
 {
-    if (s_thread) {
-        s_thread->Finish();
+    for (auto& t : s_threads) {
+        t->Finish();
     }
 }
 
+Arena* StagingArena ()
+{
+    if (s_staging_arena) {
+        return s_staging_arena.get();
+    } else {
+        return The_Cpu_Arena();
+    }
+}
+
+void ReserveStaging (Long nbytes)
+{
+    std::unique_lock<std::mutex> lck(s_staging_mutex);
+    if (s_max_staging >= 0) {
+        s_staging_cond.wait(lck, [=] () -> bool
+                            { return s_staged == 0 || s_staged + nbytes <= s_max_staging; });
+    }
+    s_staged += nbytes;
+}
+
+void ReleaseStaging (Long nbytes)
+{
+    {
+        std::lock_guard<std::mutex> lck(s_staging_mutex);
+        s_staged -= nbytes;
+    }
+    s_staging_cond.notify_all();
+}
+
+Stats GetStats ()
+{
+    std::lock_guard<std::mutex> lck(s_stats_mutex);
+    return s_stats;
+}
+
+void AddBytesWritten (Long nbytes)
+{
+    std::lock_guard<std::mutex> lck(s_stats_mutex);
+    s_stats.nbytes += nbytes;
+}
+
 void Wait ()
 {
 #ifdef AMREX_USE_MPI
     const int N = s_info.ispot;
     if (N > 0) {
+        const double t0 = amrex::second();
         Vector<MPI_Request> reqs(N);
         Vector<MPI_Status> stats(N);
         for (int i = 0; i < N; ++i) {
-            reqs[i] = ParallelDescriptor::Abarrier(s_comm).req();
+            reqs[i] = ParallelDescriptor::Abarrier(s_comms[s_ithread]).req();
         }
         ParallelDescriptor::Waitall(reqs, stats);
+        const double dt = amrex::second() - t0;
+        std::lock_guard<std::mutex> lck(s_stats_mutex);
+        s_stats.wait_time += dt;
     }
 #endif
 }
@@ -133,7 +286,7 @@ void Notify ()
         Vector<MPI_Request> reqs(N);
         Vector<MPI_Status> stats(N);
         for (int i = 0; i < N; ++i) {
-            reqs[i] = ParallelDescriptor::Abarrier(s_comm).req();
+            reqs[i] = ParallelDescriptor::Abarrier(s_comms[s_ithread]).req();
         }
         ParallelDescriptor::Waitall(reqs, stats);
     }
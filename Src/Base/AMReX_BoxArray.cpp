@@ -5,6 +5,8 @@
 #include <AMReX_Utility.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_BaseFab.H>
+#include <AMReX_Morton.H>
+#include <AMReX_ParmParse.H>
 
 #ifdef AMREX_MEM_PROFILING
 #include <AMReX_MemProfiler.H>
@@ -12,7 +14,9 @@
 
 #include <AMReX_OpenMP.H>
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 
 namespace amrex {
 
@@ -23,8 +27,13 @@ Long BARef::total_box_bytes      = 0L;
 Long BARef::total_box_bytes_hwm  = 0L;
 Long BARef::total_hash_bytes     = 0L;
 Long BARef::total_hash_bytes_hwm = 0L;
+Long BARef::total_bvh_bytes      = 0L;
+Long BARef::total_bvh_bytes_hwm  = 0L;
 #endif
 
+BARef::SearchIndex BARef::default_search_index = BARef::SearchIndex::hash;
+Long BARef::compact_min_size = 0;
+
 bool    BARef::initialized = false;
 bool BoxArray::initialized = false;
 
@@ -75,8 +84,16 @@ BARef::BARef (std::istream& is)
 }
 
 BARef::BARef (const BARef& rhs)
-    : m_abox(rhs.m_abox) // don't copy hash
+    : m_abox(rhs.m_abox), // don't copy hash
+      search_index(rhs.search_index)
 {
+    if (rhs.m_compact) {
+        const int N = rhs.size();
+        m_abox.resize(N);
+        for (int i = 0; i < N; ++i) {
+            m_abox[i] = rhs.m_compact->box(i);
+        }
+    }
 #ifdef AMREX_MEM_PROFILING
     updateMemoryUsage_box(1);
 #endif
@@ -87,6 +104,7 @@ BARef::~BARef ()
 #ifdef AMREX_MEM_PROFILING
     updateMemoryUsage_box(-1);
     updateMemoryUsage_hash(-1);
+    updateMemoryUsage_bvh(-1);
 #endif
 }
 
@@ -178,10 +196,13 @@ BARef::resize (Long n) {
 #ifdef AMREX_MEM_PROFILING
     updateMemoryUsage_box(-1);
     updateMemoryUsage_hash(-1);
+    updateMemoryUsage_bvh(-1);
 #endif
     m_abox.resize(n);
     hash.clear();
     has_hashmap = false;
+    bvh = BVH();
+    has_bvh = false;
 #ifdef AMREX_MEM_PROFILING
     updateMemoryUsage_box(1);
 #endif
@@ -191,8 +212,8 @@ BARef::resize (Long n) {
 void
 BARef::updateMemoryUsage_box (int s)
 {
-    if (m_abox.size() > 1) {
-        Long b = amrex::bytesOf(m_abox);
+    if (size() > 1) {
+        Long b = m_compact ? m_compact->nBytes() : amrex::bytesOf(m_abox);
         if (s > 0) {
             total_box_bytes += b;
             total_box_bytes_hwm = std::max(total_box_bytes_hwm, total_box_bytes);
@@ -209,11 +230,7 @@ void
 BARef::updateMemoryUsage_hash (int s)
 {
     if (hash.size() > 0) {
-        Long b = sizeof(hash);
-        for (const auto& x: hash) {
-            b += amrex::gcc_map_node_extra_bytes
-                + sizeof(IntVect) + amrex::bytesOf(x.second);
-        }
+        Long b = hashBytes();
         if (s > 0) {
             total_hash_bytes += b;
             total_hash_bytes_hwm = std::max(total_hash_bytes_hwm, total_hash_bytes);
@@ -222,7 +239,298 @@ BARef::updateMemoryUsage_hash (int s)
         }
     }
 }
+
+void
+BARef::updateMemoryUsage_bvh (int s)
+{
+    if (!bvh.boxes.empty()) {
+        Long b = bvh.nBytes();
+        if (s > 0) {
+            total_bvh_bytes += b;
+            total_bvh_bytes_hwm = std::max(total_bvh_bytes_hwm, total_bvh_bytes);
+        } else {
+            total_bvh_bytes -= b;
+        }
+    }
+}
+#endif
+
+bool
+BARef::compact ()
+{
+    if (m_compact) { return true; }
+    if (m_abox.empty()) { return false; }
+
+    auto c = std::make_unique<BACompact>();
+    if (!c->define(m_abox)) { return false; }
+
+#ifdef AMREX_MEM_PROFILING
+    updateMemoryUsage_box(-1);
+#endif
+    m_compact = std::move(c);
+    Vector<Box>().swap(m_abox);
+    // The hash map and the BVH are not needed anymore.
+#ifdef AMREX_MEM_PROFILING
+    updateMemoryUsage_hash(-1);
+    updateMemoryUsage_bvh(-1);
+#endif
+    hash.clear();
+    has_hashmap = false;
+    bvh = BVH();
+    has_bvh = false;
+#ifdef AMREX_MEM_PROFILING
+    updateMemoryUsage_box(1);
+#endif
+    return true;
+}
+
+void
+BARef::decompress ()
+{
+    if (!m_compact) { return; }
+#ifdef AMREX_MEM_PROFILING
+    updateMemoryUsage_box(-1);
+#endif
+    const int N = m_compact->size();
+    m_abox.resize(N);
+    for (int i = 0; i < N; ++i) {
+        m_abox[i] = m_compact->box(i);
+    }
+    m_compact.reset();
+#ifdef AMREX_MEM_PROFILING
+    updateMemoryUsage_box(1);
+#endif
+}
+
+bool
+BARef::sameBoxes (const BARef& rhs) const
+{
+    if (!m_compact && !rhs.m_compact) {
+        return m_abox == rhs.m_abox;
+    }
+    const Long N = size();
+    if (N != rhs.size()) { return false; }
+    auto const lhs_boxes = boxes();
+    auto const rhs_boxes = rhs.boxes();
+    for (Long i = 0; i < N; ++i) {
+        if (lhs_boxes[i] != rhs_boxes[i]) { return false; }
+    }
+    return true;
+}
+
+int
+BACompact::find (Long t) const noexcept
+{
+    if (sorted.empty()) {
+        // The runs are sorted by tile index and do not overlap.
+        const int r = static_cast<int>(std::upper_bound(run_start.begin(), run_start.end(), t)
+                                       - run_start.begin()) - 1;
+        if (r < 0) { return -1; }
+        const Long k = t - run_start[r];
+        if (k % run_stride[r] != 0) { return -1; }
+        const Long i = run_begin[r] + k / run_stride[r];
+        return (i < run_begin[r+1]) ? static_cast<int>(i) : -1;
+    } else {
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), t,
+                                   [this] (int i, Long tile) { return tileIndex(i) < tile; });
+        return (it != sorted.end() && tileIndex(*it) == t) ? *it : -1;
+    }
+}
+
+template <typename F>
+void
+BACompact::query (const Box& b, F const& f) const
+{
+    IntVect alo, ahi;
+    Array<Long,AMREX_SPACEDIM> n;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        auto const& c = cuts[idim];
+        n[idim] = static_cast<Long>(c.size()) - 1;
+        if (b.bigEnd(idim) < c.front() || b.smallEnd(idim) >= c.back()) { return; }
+        alo[idim] = std::max(0, static_cast<int>(std::upper_bound(c.begin(), c.end(), b.smallEnd(idim))
+                                                 - c.begin()) - 1);
+        ahi[idim] = std::min(static_cast<int>(n[idim])-1,
+                             static_cast<int>(std::upper_bound(c.begin(), c.end(), b.bigEnd(idim))
+                                              - c.begin()) - 1);
+    }
+#if (AMREX_SPACEDIM == 3)
+    for (int a2 = alo[2]; a2 <= ahi[2]; ++a2) {
+#endif
+#if (AMREX_SPACEDIM >= 2)
+    for (int a1 = alo[1]; a1 <= ahi[1]; ++a1) {
+#endif
+    for (int a0 = alo[0]; a0 <= ahi[0]; ++a0) {
+        Long t = a0;
+#if (AMREX_SPACEDIM >= 2)
+        t += n[0]*a1;
+#endif
+#if (AMREX_SPACEDIM == 3)
+        t += n[0]*n[1]*a2;
+#endif
+        const int i = find(t);
+        if (i >= 0 && f(i)) { return; }
+    }
+#if (AMREX_SPACEDIM >= 2)
+    }
 #endif
+#if (AMREX_SPACEDIM == 3)
+    }
+#endif
+}
+
+Long
+BACompact::nBytes () const
+{
+    Long b = sizeof(BACompact) + amrex::bytesOf(run_begin) + amrex::bytesOf(run_start)
+        + amrex::bytesOf(run_stride) + amrex::bytesOf(sorted);
+    for (auto const& c : cuts) {
+        b += amrex::bytesOf(c);
+    }
+    return b;
+}
+
+bool
+BACompact::define (const Vector<Box>& boxes)
+{
+    const int N = boxes.size();
+    if (N == 0) { return false; }
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        auto& c = cuts[idim];
+        c.clear();
+        c.reserve(2*N);
+        for (auto const& bx : boxes) {
+            if (!bx.ok() || !bx.cellCentered()) { return false; }
+            c.push_back(bx.smallEnd(idim));
+            c.push_back(bx.bigEnd(idim)+1);
+        }
+        std::sort(c.begin(), c.end());
+        c.erase(std::unique(c.begin(), c.end()), c.end());
+        c.shrink_to_fit();
+    }
+
+    // A box is a cell of the grid if no cut is strictly inside it.
+    Vector<Long> tiles(N);
+    for (int i = 0; i < N; ++i) {
+        Long t = 0, stride = 1;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            auto const& c = cuts[idim];
+            const int a = static_cast<int>(std::lower_bound(c.begin(), c.end(), boxes[i].smallEnd(idim))
+                                           - c.begin());
+            if (c[a+1] != boxes[i].bigEnd(idim)+1) { return false; }
+            t += a*stride;
+            stride *= static_cast<Long>(c.size()) - 1;
+        }
+        tiles[i] = t;
+    }
+
+    run_begin.clear();
+    run_start.clear();
+    run_stride.clear();
+    sorted.clear();
+    bool increasing = true;
+    for (int i = 0; i < N; ) {
+        const Long stride = (i+1 < N) ? tiles[i+1] - tiles[i] : 1;
+        int j = i+1;
+        while (j < N && tiles[j] - tiles[j-1] == stride) { ++j; }
+        run_begin.push_back(i);
+        run_start.push_back(tiles[i]);
+        run_stride.push_back((j-i > 1) ? stride : 1);
+        if (j-i > 1 && stride <= 0) { increasing = false; }
+        if (i > 0 && tiles[i] <= tiles[i-1]) { increasing = false; }
+        i = j;
+    }
+    run_begin.push_back(N);
+    run_begin.shrink_to_fit();
+    run_start.shrink_to_fit();
+    run_stride.shrink_to_fit();
+
+    if (!increasing) {
+        sorted.resize(N);
+        std::iota(sorted.begin(), sorted.end(), 0);
+        std::sort(sorted.begin(), sorted.end(),
+                  [&] (int a, int b) { return tiles[a] < tiles[b]; });
+        for (int i = 1; i < N; ++i) {
+            if (tiles[sorted[i]] == tiles[sorted[i-1]]) { return false; }
+        }
+    }
+
+    return 2*nBytes() <= amrex::bytesOf(boxes);
+}
+
+Long
+BARef::hashBytes () const
+{
+    Long b = 0;
+    if (hash.size() > 0) {
+        b = sizeof(hash);
+        for (const auto& x: hash) {
+            b += amrex::gcc_map_node_extra_bytes
+                + sizeof(IntVect) + amrex::bytesOf(x.second);
+        }
+    }
+    return b;
+}
+
+Long
+BARef::BVH::nBytes () const
+{
+    Long b = sizeof(BVH) + amrex::bytesOf(boxes) + amrex::bytesOf(index);
+    for (auto const& level : nodes) {
+        b += sizeof(level) + amrex::bytesOf(level);
+    }
+    return b;
+}
+
+template <typename F>
+void
+BARef::BVH::query (const Box& b, F const& f) const
+{
+    const int nboxes = boxes.size();
+    const int nlevels = nodes.size();
+
+    auto search_boxes = [&] (int begin, int end) -> bool
+    {
+        for (int i = begin; i < end; ++i) {
+            if (boxes[i].intersects(b) && f(index[i])) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (nlevels == 0) {
+        search_boxes(0, nboxes);
+        return;
+    }
+
+    // Depth-first traversal.  At most fanout nodes per level are pending.
+    constexpr int max_levels = 16;
+    AMREX_ASSERT(nlevels <= max_levels);
+    int stack_level[max_levels*fanout];
+    int stack_node[max_levels*fanout];
+    int top = 0;
+    stack_level[top] = nlevels-1;
+    stack_node[top] = 0;
+    ++top;
+    while (top > 0) {
+        --top;
+        const int lev = stack_level[top];
+        const int node = stack_node[top];
+        if (!nodes[lev][node].intersects(b)) { continue; }
+        const int begin = node*fanout;
+        if (lev == 0) {
+            if (search_boxes(begin, std::min(begin+fanout, nboxes))) { return; }
+        } else {
+            const int end = std::min(begin+fanout, static_cast<int>(nodes[lev-1].size()));
+            for (int child = end-1; child >= begin; --child) {
+                stack_level[top] = lev-1;
+                stack_node[top] = child;
+                ++top;
+            }
+        }
+    }
+}
 
 void
 BARef::Initialize ()
@@ -238,6 +546,10 @@ BARef::Initialize ()
              ([] () -> MemProfiler::MemInfo {
                  return {total_hash_bytes, total_hash_bytes_hwm};
              }));
+        MemProfiler::add("BoxArrayBVH", std::function<MemProfiler::MemInfo()>
+             ([] () -> MemProfiler::MemInfo {
+                 return {total_bvh_bytes, total_bvh_bytes_hwm};
+             }));
         MemProfiler::add("BoxArray Innard", std::function<MemProfiler::NBuildsInfo()>
              ([] () -> MemProfiler::NBuildsInfo {
                  return {numboxarrays, numboxarrays_hwm};
@@ -252,6 +564,8 @@ void
 BARef::Finalize ()
 {
     initialized = false;
+    default_search_index = SearchIndex::hash;
+    compact_min_size = 0;
 }
 
 void
@@ -260,6 +574,19 @@ BoxArray::Initialize ()
     if (!initialized) {
         initialized = true;
         BARef::Initialize();
+
+        ParmParse pp("boxarray");
+        std::string search_index;
+        if (pp.query("search_index", search_index)) {
+            if (search_index == "hash") {
+                BARef::default_search_index = SearchIndex::hash;
+            } else if (search_index == "bvh") {
+                BARef::default_search_index = SearchIndex::bvh;
+            } else {
+                amrex::Abort("BoxArray: unknown boxarray.search_index " + search_index);
+            }
+        }
+        pp.query("compact_min_size", BARef::compact_min_size);
     }
 
     amrex::ExecOnFinalize(BoxArray::Finalize);
@@ -290,6 +617,7 @@ BoxArray::BoxArray (const BoxList& bl)
     m_ref(std::make_shared<BARef>(bl))
 {
     type_update();
+    compact_if_large();
 }
 
 BoxArray::BoxArray (BoxList&& bl) noexcept
@@ -298,6 +626,7 @@ BoxArray::BoxArray (BoxList&& bl) noexcept
     m_ref(std::make_shared<BARef>(std::move(bl)))
 {
     type_update();
+    compact_if_large();
 }
 
 BoxArray::BoxArray (size_t n)
@@ -343,6 +672,7 @@ BoxArray::BoxArray (BoxList&& bl, IntVect const& max_grid_size)
     m_bat = BATransformer(tmpbl.ixType());
     m_ref->define(std::move(tmpbl));
     type_update();
+    compact_if_large();
 }
 
 void
@@ -361,6 +691,7 @@ BoxArray::define (const BoxList& bl)
     m_bat = BATransformer(bl.ixType());
     m_ref->define(bl);
     type_update();
+    compact_if_large();
 }
 
 void
@@ -370,6 +701,7 @@ BoxArray::define (BoxList&& bl) noexcept
     m_bat = BATransformer(bl.ixType());
     m_ref->define(std::move(bl));
     type_update();
+    compact_if_large();
 }
 
 void
@@ -392,7 +724,7 @@ BoxArray::numPts () const noexcept
 {
     Long result = 0;
     const int N = size();
-    auto const& bxs = this->m_ref->m_abox;
+    auto const bxs = m_ref->boxes();
     if (m_bat.is_null()) {
 #ifdef AMREX_USE_OMP
 #pragma omp parallel for reduction(+:result)
@@ -429,7 +761,7 @@ BoxArray::d_numPts () const noexcept
 {
     double result = 0;
     const int N = size();
-    auto const& bxs = this->m_ref->m_abox;
+    auto const bxs = m_ref->boxes();
     if (m_bat.is_null()) {
 #ifdef AMREX_USE_OMP
 #pragma omp parallel for reduction(+:result)
@@ -484,7 +816,7 @@ BoxArray::writeOn (std::ostream& os) const
     os << '(' << size() << ' ' << 0 << '\n';
 
     const int N = size();
-    auto const& bxs = this->m_ref->m_abox;
+    auto const bxs = m_ref->boxes();
     if (m_bat.is_null()) {
         for (int i = 0; i < N; ++i) {
             os << bxs[i] << '\n';
@@ -513,7 +845,7 @@ bool
 BoxArray::operator== (const BoxArray& rhs) const noexcept
 {
     return m_bat == rhs.m_bat &&
-        (m_ref == rhs.m_ref || m_ref->m_abox == rhs.m_ref->m_abox);
+        (m_ref == rhs.m_ref || m_ref->sameBoxes(*rhs.m_ref));
 }
 
 bool
@@ -542,7 +874,7 @@ bool
 BoxArray::CellEqual (const BoxArray& rhs) const noexcept
 {
     return crseRatio() == rhs.crseRatio()
-        && (m_ref == rhs.m_ref || m_ref->m_abox == rhs.m_ref->m_abox);
+        && (m_ref == rhs.m_ref || m_ref->sameBoxes(*rhs.m_ref));
 }
 
 BoxArray&
@@ -614,7 +946,7 @@ BoxArray::coarsenable (const IntVect& refinement_ratio, const IntVect& min_width
     bool res = first.coarsenable(refinement_ratio,min_width);
     if (res == false) return false;
 
-    auto const& bxs = this->m_ref->m_abox;
+    auto const bxs = m_ref->boxes();
     if (m_bat.is_null()) {
 #ifdef AMREX_USE_OMP
 #pragma omp parallel for reduction(&&:res)
@@ -862,6 +1194,7 @@ BoxArray::set (int i, const Box& ibox)
     if (i == 0) {
         m_bat.set_index_type(ibox.ixType());
     }
+    m_ref->decompress();
     m_ref->m_abox[i] = amrex::enclosedCells(ibox);
 }
 
@@ -877,7 +1210,7 @@ BoxArray::ok () const
     const int N = size();
     if (N > 0)
     {
-        auto const& bxs = this->m_ref->m_abox;
+        auto const bxs = m_ref->boxes();
         if (m_bat.is_null()) {
             for (int i = 0; i < N; ++i) {
                 if (! bxs[i].ok()) return false;
@@ -903,7 +1236,7 @@ BoxArray::isDisjoint () const
     std::vector< std::pair<int,Box> > isects;
 
     const int N = size();
-    auto const& bxs = this->m_ref->m_abox;
+    auto const bxs = m_ref->boxes();
     if (m_bat.is_null()) {
         for (int i = 0; i < N; ++i) {
             intersections(bxs[i],isects);
@@ -934,7 +1267,7 @@ BoxArray::boxList () const
     newb.data().reserve(N);
     if (N > 0) {
         newb.set(ixType());
-        auto const& bxs = this->m_ref->m_abox;
+        auto const bxs = m_ref->boxes();
         if (m_bat.is_null()) {
             for (int i = 0; i < N; ++i) {
                 newb.push_back(bxs[i]);
@@ -1033,14 +1366,14 @@ BoxArray::minimalBox () const
 #endif
         if (use_single_thread)
         {
-            minbox = m_ref->m_abox[0];
+            minbox = m_ref->boxes()[0];
             for (int i = 1; i < N; ++i) {
-                minbox.minBox(m_ref->m_abox[i]);
+                minbox.minBox(m_ref->boxes()[i]);
             }
         }
         else
         {
-            Vector<Box> bxs(nthreads, m_ref->m_abox[0]);
+            Vector<Box> bxs(nthreads, m_ref->boxes()[0]);
 #ifdef AMREX_USE_OMP
 #pragma omp parallel
 #endif
@@ -1050,7 +1383,7 @@ BoxArray::minimalBox () const
 #pragma omp for
 #endif
                 for (int i = 0; i < N; ++i) {
-                    bxs[tid].minBox(m_ref->m_abox[i]);
+                    bxs[tid].minBox(m_ref->boxes()[i]);
                 }
             }
             minbox = bxs[0];
@@ -1081,16 +1414,16 @@ BoxArray::minimalBox (Long& npts_avg_box) const
 #endif
         if (use_single_thread)
         {
-            minbox = m_ref->m_abox[0];
-            npts_tot += m_ref->m_abox[0].numPts();
+            minbox = m_ref->boxes()[0];
+            npts_tot += m_ref->boxes()[0].numPts();
             for (int i = 1; i < N; ++i) {
-                minbox.minBox(m_ref->m_abox[i]);
-                npts_tot += m_ref->m_abox[i].numPts();
+                minbox.minBox(m_ref->boxes()[i]);
+                npts_tot += m_ref->boxes()[i].numPts();
             }
         }
         else
         {
-            Vector<Box> bxs(nthreads, m_ref->m_abox[0]);
+            Vector<Box> bxs(nthreads, m_ref->boxes()[0]);
 #ifdef AMREX_USE_OMP
 #pragma omp parallel reduction(+:npts_tot)
 #endif
@@ -1100,8 +1433,8 @@ BoxArray::minimalBox (Long& npts_avg_box) const
 #pragma omp for
 #endif
                 for (int i = 0; i < N; ++i) {
-                    bxs[tid].minBox(m_ref->m_abox[i]);
-                    Long npts = m_ref->m_abox[i].numPts();
+                    bxs[tid].minBox(m_ref->boxes()[i]);
+                    Long npts = m_ref->boxes()[i].numPts();
                     npts_tot += npts;
                 }
             }
@@ -1183,6 +1516,35 @@ BoxArray::intersections (const Box&                         bx,
 {
     // This is called too many times BL_PROFILE("BoxArray::intersections()");
 
+    if (m_ref->m_compact || m_ref->search_index == SearchIndex::bvh)
+    {
+        isects.resize(0);
+
+        if (empty()) return;
+
+        BL_ASSERT(bx.ixType() == ixType());
+
+        auto const abox = m_ref->boxes();
+
+        auto f = [&] (int index) -> bool
+        {
+            const Box& isect = bx & amrex::grow(m_bat(abox[index]),ng);
+            if (isect.ok()) {
+                isects.push_back(std::pair<int,Box>(index,isect));
+                return first_only;
+            }
+            return false;
+        };
+
+        if (m_ref->m_compact) {
+            m_ref->m_compact->query(searchRegion(bx,ng), f);
+        } else {
+            getBVH().query(searchRegion(bx,ng), f);
+        }
+
+        return;
+    }
+
     BARef::HashType& BoxHashMap = getHashMap();
 
     isects.resize(0);
@@ -1211,7 +1573,7 @@ BoxArray::intersections (const Box&                         bx,
 
         auto TheEnd = BoxHashMap.cend();
 
-        auto& abox = m_ref->m_abox;
+        auto const abox = m_ref->boxes();
 
         for (IntVect iv = cbx.smallEnd(), End = cbx.bigEnd(); iv <= End; cbx.next(iv))
         {
@@ -1280,6 +1642,40 @@ BoxArray::complementIn (BoxList& bl, const Box& bx) const
 
     if (empty()) return;
 
+    if (m_ref->m_compact || m_ref->search_index == SearchIndex::bvh)
+    {
+        BL_ASSERT(bx.ixType() == ixType());
+
+        Vector<Box> intersect_boxes;
+        auto const abox = m_ref->boxes();
+        auto f = [&] (int index) -> bool
+        {
+            const Box& ibox = m_bat(abox[index]);
+            if (bx.intersects(ibox)) {
+                intersect_boxes.push_back(ibox);
+            }
+            return false;
+        };
+        if (m_ref->m_compact) {
+            m_ref->m_compact->query(searchRegion(bx,IntVect(0)), f);
+        } else {
+            getBVH().query(searchRegion(bx,IntVect(0)), f);
+        }
+
+        BoxList newbl(bl.ixType());
+        BoxList newdiff(bl.ixType());
+        for  (auto const& ibox : intersect_boxes) {
+            newbl.clear();
+            for (Box const& b : bl) {
+                amrex::boxDiff(newdiff, b, ibox);
+                newbl.join(newdiff);
+            }
+            bl.swap(newbl);
+            if (bl.isEmpty()) { return; }
+        }
+        return;
+    }
+
     BARef::HashType& BoxHashMap = getHashMap();
 
     BL_ASSERT(bx.ixType() == ixType());
@@ -1305,7 +1701,7 @@ BoxArray::complementIn (BoxList& bl, const Box& bx) const
     auto TheEnd = BoxHashMap.cend();
 
     Vector<Box> intersect_boxes;
-    auto& abox = m_ref->m_abox;
+    auto const abox = m_ref->boxes();
     if (m_bat.is_null()) {
         AMREX_LOOP_3D(cbx, i, j, k,
         {
@@ -1373,6 +1769,52 @@ BoxArray::clear_hash_bin () const
         m_ref->hash.clear();
         m_ref->has_hashmap = false;
     }
+    if (!m_ref->bvh.boxes.empty())
+    {
+#ifdef AMREX_MEM_PROFILING
+        m_ref->updateMemoryUsage_bvh(-1);
+#endif
+        m_ref->bvh = BARef::BVH();
+        m_ref->has_bvh = false;
+    }
+}
+
+void
+BoxArray::setSearchIndex (SearchIndex si) const
+{
+    m_ref->search_index = si;
+}
+
+Long
+BoxArray::searchIndexBytes () const
+{
+    if (m_ref->m_compact) {
+        return 0L; // The compact storage is its own index.
+    } else if (m_ref->search_index == SearchIndex::bvh) {
+        return m_ref->HasBVH() ? m_ref->bvh.nBytes() : 0L;
+    } else {
+        return m_ref->HasHashMap() ? m_ref->hashBytes() : 0L;
+    }
+}
+
+bool
+BoxArray::compact () const
+{
+    return m_ref->compact();
+}
+
+Long
+BoxArray::boxStorageBytes () const
+{
+    return m_ref->m_compact ? m_ref->m_compact->nBytes() : amrex::bytesOf(m_ref->m_abox);
+}
+
+void
+BoxArray::compact_if_large ()
+{
+    if (BARef::compact_min_size > 0 && size() >= BARef::compact_min_size) {
+        compact();
+    }
 }
 
 //
@@ -1391,6 +1833,10 @@ BoxArray::removeOverlap (bool simplify)
 
     uniqify();
 
+    // The boxes added below are inserted into the hash map.
+    const SearchIndex search_index = m_ref->search_index;
+    m_ref->search_index = SearchIndex::hash;
+
     BARef::HashType& BoxHashMap = m_ref->hash;
 
     const Box EmptyBox;
@@ -1449,6 +1895,7 @@ BoxArray::removeOverlap (bool simplify)
     }
 
     BoxArray nba(std::move(bl));
+    nba.setSearchIndex(search_index);
 
     *this = nba;
 
@@ -1502,12 +1949,12 @@ BoxArray::getHashMap () const
             // Calculate the bounding box & maximum extent of the boxes.
             //
             IntVect maxext = IntVect::TheUnitVector();
-            Box boundingbox = m_ref->m_abox[0];
+            Box boundingbox = m_ref->boxes()[0];
 
             const int N = size();
             for (int i = 0; i < N; ++i)
             {
-                Box bx = m_ref->m_abox[i];
+                Box bx = m_ref->boxes()[i];
                 bx.normalize();
                 maxext = amrex::max(maxext, bx.size());
                 boundingbox.minBox(bx);
@@ -1515,8 +1962,9 @@ BoxArray::getHashMap () const
 
             for (int i = 0; i < N; i++)
             {
+                const Box bx = m_ref->boxes()[i];
                 const IntVect& crsnsmlend
-                    = amrex::coarsen(m_ref->m_abox[i].smallEnd(),maxext);
+                    = amrex::coarsen(bx.smallEnd(),maxext);
                 BoxHashMap[crsnsmlend].push_back(i);
             }
 
@@ -1539,11 +1987,101 @@ BoxArray::getHashMap () const
     return BoxHashMap;
 }
 
+BARef::BVH const&
+BoxArray::getBVH () const
+{
+    BARef::BVH& bvh = m_ref->bvh;
+
+    if (m_ref->HasBVH()) return bvh;
+
+#ifdef AMREX_USE_OMP
+#pragma omp critical(intersections_lock)
+#endif
+    {
+        if (bvh.boxes.empty() && size() > 0)
+        {
+            auto const abox = m_ref->boxes();
+            const int N = size();
+
+            Box boundingbox = abox[0];
+            for (int i = 1; i < N; ++i) {
+                boundingbox.minBox(abox[i]);
+            }
+            GpuArray<Real,AMREX_SPACEDIM> plo, phi;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                plo[idim] = static_cast<Real>(boundingbox.smallEnd(idim));
+                phi[idim] = static_cast<Real>(boundingbox.bigEnd(idim)+1);
+            }
+
+            Vector<std::pair<std::uint32_t,int> > codes(N);
+            for (int i = 0; i < N; ++i) {
+                const Box bx = abox[i];
+                const IntVect lo = bx.smallEnd();
+                const IntVect hi = bx.bigEnd();
+                codes[i].first = Morton::get32BitCode(
+                    AMREX_D_DECL(Real(0.5)*static_cast<Real>(lo[0]+hi[0]+1),
+                                 Real(0.5)*static_cast<Real>(lo[1]+hi[1]+1),
+                                 Real(0.5)*static_cast<Real>(lo[2]+hi[2]+1)),
+                    plo, phi);
+                codes[i].second = i;
+            }
+            std::sort(codes.begin(), codes.end());
+
+            bvh.boxes.resize(N);
+            bvh.index.resize(N);
+            for (int i = 0; i < N; ++i) {
+                bvh.index[i] = codes[i].second;
+                bvh.boxes[i] = abox[codes[i].second];
+            }
+
+            constexpr int fanout = BARef::BVH::fanout;
+            Vector<Box> const* children = &bvh.boxes;
+            while (children->size() > 1) {
+                const int nchildren = children->size();
+                const int nnodes = (nchildren + fanout - 1) / fanout;
+                Vector<Box> level(nnodes);
+                for (int n = 0; n < nnodes; ++n) {
+                    const int end = std::min((n+1)*fanout, nchildren);
+                    Box b = (*children)[n*fanout];
+                    for (int c = n*fanout+1; c < end; ++c) {
+                        b.minBox((*children)[c]);
+                    }
+                    level[n] = b;
+                }
+                bvh.nodes.push_back(std::move(level));
+                children = &bvh.nodes.back();
+            }
+
+#ifdef AMREX_MEM_PROFILING
+            m_ref->updateMemoryUsage_bvh(1);
+#endif
+
+#ifdef AMREX_USE_OMP
+#pragma omp flush
+#pragma omp atomic write
+#endif
+            m_ref->has_bvh = true;
+        }
+    }
+
+    return bvh;
+}
+
+Box
+BoxArray::searchRegion (const Box& bx, const IntVect& ng) const noexcept
+{
+    // A box of m_abox intersects bx grown by ng after transformation only
+    // if it intersects this cell-centered region.
+    Box r(bx.smallEnd() - ng - getDoiHi(), bx.bigEnd() + ng + getDoiLo());
+    return r.refine(crseRatio());
+}
+
 void
 BoxArray::uniqify ()
 {
     if (m_ref.use_count() == 1) {
         clear_hash_bin();
+        m_ref->decompress();
     } else {
         auto p = std::make_shared<BARef>(*m_ref);
         std::swap(m_ref,p);
@@ -9,6 +9,7 @@
 #include <AMReX_VisMF.H>
 #include <AMReX_Utility.H>
 #include <AMReX_Morton.H>
+#include <AMReX_GraphPartition.H>
 
 #include <iostream>
 #include <fstream>
@@ -17,6 +18,8 @@
 #include <map>
 #include <vector>
 #include <queue>
+#include <set>
+#include <functional>
 #include <algorithm>
 #include <numeric>
 #include <string>
@@ -25,6 +28,8 @@
 
 namespace {
 int flag_verbose_mapper;
+int graph_nghost;
+amrex::Real graph_imbalance;
 }
 
 namespace amrex {
@@ -74,6 +79,9 @@ DistributionMapping::strategy (DistributionMapping::Strategy how)
     case RRSFC:
         m_BuildMap = &DistributionMapping::RRSFCProcessorMap;
         break;
+    case GRAPH:
+        m_BuildMap = &DistributionMapping::GraphProcessorMap;
+        break;
     default:
         amrex::Error("Bad DistributionMapping::Strategy");
     }
@@ -115,6 +123,8 @@ DistributionMapping::Initialize ()
     max_efficiency   = 0.9_rt;
     node_size        = 0;
     flag_verbose_mapper = 0;
+    graph_nghost     = 1;
+    graph_imbalance  = 0.03_rt;
 
     ParmParse pp("DistributionMapping");
 
@@ -124,6 +134,8 @@ DistributionMapping::Initialize ()
     pp.queryAdd("sfc_threshold",       sfc_threshold);
     pp.queryAdd("node_size",           node_size);
     pp.queryAdd("verbose_mapper",      flag_verbose_mapper);
+    pp.queryAdd("graph_nghost",        graph_nghost);
+    pp.queryAdd("graph_imbalance",     graph_imbalance);
 
     std::string theStrategy;
 
@@ -145,6 +157,10 @@ DistributionMapping::Initialize ()
         {
             strategy(RRSFC);
         }
+        else if (theStrategy == "GRAPH")
+        {
+            strategy(GRAPH);
+        }
         else
         {
             std::string msg("Unknown strategy: ");
@@ -1397,6 +1413,243 @@ DistributionMapping::RRSFCProcessorMap (const BoxArray&          boxes,
     RRSFCDoIt(boxes,nprocs);
 }
 
+void
+DistributionMapping::GraphProcessorMapDoIt (const BoxArray&          boxes,
+                                            const std::vector<Long>& wgts,
+                                            int                   /*   nprocs */,
+                                            bool                     sort,
+                                            Real*                    eff,
+                                            Long*                    comm_volume)
+{
+    if (flag_verbose_mapper) {
+        Print() << "DM: GraphProcessorMapDoIt called..." << std::endl;
+    }
+
+    BL_PROFILE("DistributionMapping::GraphProcessorMapDoIt()");
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    int nteams = nprocs;
+    int nworkers = 1;
+#if defined(BL_USE_TEAM)
+    nteams = ParallelDescriptor::NTeams();
+    nworkers = ParallelDescriptor::TeamSize();
+#else
+    if (node_size > 0) {
+        nteams = nprocs/node_size;
+        nworkers = node_size;
+        if (nworkers*nteams != nprocs) {
+            nteams = nprocs;
+            nworkers = 1;
+        }
+    }
+#endif
+
+    if (flag_verbose_mapper) {
+        Print() << "  (nprocs, nteams, nworkers) = ("
+                << nprocs << ", " << nteams << ", " << nworkers << ")\n";
+    }
+
+    const CSRGraph graph = makeBoxGraph(boxes, wgts, IntVect(graph_nghost));
+    //
+    // Partition across teams first so that most of the communication stays
+    // within a team (e.g., a node), and then across the workers of each team.
+    //
+    const Vector<int> team_part = partitionGraph(graph, nteams, graph_imbalance);
+
+    std::vector< std::vector<int> > vec(nteams);
+    for (int i = 0, N = boxes.size(); i < N; ++i) {
+        vec[team_part[i]].push_back(i);
+    }
+
+    std::vector<LIpair> LIpairV;
+
+    LIpairV.reserve(nteams);
+
+    for (int i = 0; i < nteams; ++i)
+    {
+        Long wgt = 0;
+        for (int ibox : vec[i]) {
+            wgt += wgts[ibox];
+        }
+        LIpairV.push_back(LIpair(wgt,i));
+    }
+
+    if (sort) Sort(LIpairV, true);
+
+    if (flag_verbose_mapper) {
+        for (const auto &p : LIpairV) {
+            Print() << "  Bucket " << p.second << " contains " << p.first << std::endl;
+        }
+    }
+
+    Vector<int> ord;
+    Vector<Vector<int> > wrkerord;
+
+    if (nteams == nprocs) {
+        if (sort) {
+            LeastUsedCPUs(nprocs,ord);
+        } else {
+            ord.resize(nprocs);
+            std::iota(ord.begin(), ord.end(), 0);
+        }
+    } else {
+        if (sort) {
+            LeastUsedTeams(ord,wrkerord,nteams,nworkers);
+        } else {
+            ord.resize(nteams);
+            std::iota(ord.begin(), ord.end(), 0);
+            wrkerord.resize(nteams);
+            for (auto& v : wrkerord) {
+                v.resize(nworkers);
+                std::iota(v.begin(), v.end(), 0);
+            }
+        }
+    }
+
+    Long max_wgt = 0;
+
+    for (int i = 0; i < nteams; ++i)
+    {
+        const int tid  = ord[i];
+        const int ivec = LIpairV[i].second;
+        const std::vector<int>& vi = vec[ivec];
+        const int Nbx = vi.size();
+
+        if (flag_verbose_mapper) {
+            Print() << "Mapping bucket " << LIpairV[i].second << " to rank " << ord[i] << std::endl;
+        }
+
+        if (nteams == nprocs) {
+            for (int j = 0; j < Nbx; ++j) {
+                m_ref->m_pmap[vi[j]] = ParallelContext::local_to_global_rank(tid);
+            }
+            max_wgt = std::max(max_wgt, LIpairV[i].first);
+        } else {
+            const CSRGraph team_graph = subGraph(graph, Vector<int>(vi.begin(), vi.end()));
+            const Vector<int> wpart = partitionGraph(team_graph, nworkers, graph_imbalance);
+
+            std::vector<LIpair> ww;
+            for (int w = 0; w < nworkers; ++w) {
+                ww.push_back(LIpair(0,w));
+            }
+            for (int j = 0; j < Nbx; ++j) {
+                ww[wpart[j]].first += wgts[vi[j]];
+            }
+            Vector<int> worker_of_part(nworkers);
+            for (int w = 0; w < nworkers; ++w) {
+                max_wgt = std::max(max_wgt, ww[w].first);
+            }
+            Sort(ww,true);
+
+            const Vector<int>& sorted_workers = wrkerord[i];
+
+            const int leadrank = tid * nworkers;
+
+            for (int w = 0; w < nworkers; ++w) {
+                worker_of_part[ww[w].second] = leadrank + sorted_workers[w];
+            }
+            for (int j = 0; j < Nbx; ++j) {
+                m_ref->m_pmap[vi[j]] = worker_of_part[wpart[j]];
+            }
+        }
+    }
+
+    if (eff || comm_volume || verbose)
+    {
+        Real sum_wgt = 0;
+        for (Long w : wgts) {
+            sum_wgt += w;
+        }
+        Real efficiency = sum_wgt/(nprocs*max_wgt);
+        if (eff) *eff = efficiency;
+
+        Long volume = graphEdgeCut(graph, m_ref->m_pmap);
+        if (comm_volume) *comm_volume = volume;
+
+        if (verbose)
+        {
+            amrex::Print() << "GRAPH efficiency: " << efficiency
+                           << ", predicted communication volume: " << volume << '\n';
+        }
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray& boxes,
+                                        int             nprocs)
+{
+    BL_ASSERT(boxes.size() > 0);
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(boxes.size());
+
+    if (boxes.size() <= nprocs || nprocs < 2)
+    {
+        KnapSackProcessorMap(boxes,nprocs);
+    }
+    else
+    {
+        std::vector<Long> wgts;
+
+        wgts.reserve(boxes.size());
+
+        for (int i = 0, N = boxes.size(); i < N; ++i)
+        {
+            wgts.push_back(boxes[i].numPts());
+        }
+
+        GraphProcessorMapDoIt(boxes,wgts,nprocs);
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray&          boxes,
+                                        const std::vector<Long>& wgts,
+                                        int                      nprocs,
+                                        bool                     sort)
+{
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (boxes.size() <= nprocs || nprocs < 2)
+    {
+        KnapSackProcessorMap(wgts,nprocs);
+    }
+    else
+    {
+        GraphProcessorMapDoIt(boxes,wgts,nprocs,sort);
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray&          boxes,
+                                        const std::vector<Long>& wgts,
+                                        int                      nprocs,
+                                        Real&                    eff,
+                                        Long&                    comm_volume,
+                                        bool                     sort)
+{
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (boxes.size() <= nprocs || nprocs < 2)
+    {
+        KnapSackProcessorMap(wgts,nprocs,&eff);
+        comm_volume = ComputeCommunicationVolume(boxes, *this, IntVect(graph_nghost));
+    }
+    else
+    {
+        GraphProcessorMapDoIt(boxes,wgts,nprocs,sort,&eff,&comm_volume);
+    }
+}
+
 DistributionMapping
 DistributionMapping::makeKnapSack (const Vector<Real>& rcost, int nmax)
 {
@@ -1510,6 +1763,197 @@ DistributionMapping::makeKnapSack (const LayoutData<Real>& rcost_local,
     return r;
 }
 
+namespace {
+
+Real
+rebalance_efficiency (Vector<Real> const& load)
+{
+    Real sum = 0, max = 0;
+    for (Real l : load) {
+        sum += l;
+        max = std::max(max, l);
+    }
+    return (max > 0) ? sum/(load.size()*max) : 1.0_rt;
+}
+
+// Move boxes from the most loaded rank to the least loaded one, picking the
+// box with the largest reduction of the maximum load per byte.  Each box is
+// moved at most once, so this terminates after at most pmap.size() moves.
+Long
+incremental_rebalance (Vector<int>& pmap, Vector<Real> const& cost,
+                       Vector<Long> const& box_bytes, Long max_bytes,
+                       Vector<Real>& load)
+{
+    const int nprocs = load.size();
+    const int N = pmap.size();
+
+    Vector<Vector<int> > boxes(nprocs);
+    for (int i = 0; i < N; ++i) {
+        boxes[pmap[i]].push_back(i);
+    }
+
+    std::set<std::pair<Real,int> > ranks;
+    for (int p = 0; p < nprocs; ++p) {
+        ranks.emplace(load[p], p);
+    }
+
+    Vector<char> moved(N, 0);
+    Long moved_bytes = 0;
+
+    while (true)
+    {
+        const int p = ranks.rbegin()->second;
+        const int q = ranks.begin()->second;
+        if (p == q) { break; }
+        const Real lmax = load[p];
+        const Real lmin = load[q];
+
+        int best = -1;
+        Real best_score = 0;
+        for (int k = 0, M = boxes[p].size(); k < M; ++k)
+        {
+            const int ibox = boxes[p][k];
+            if (moved[ibox] || box_bytes[ibox] > max_bytes - moved_bytes) { continue; }
+            const Real gain = lmax - std::max(lmax-cost[ibox], lmin+cost[ibox]);
+            if (gain <= 0) { continue; }
+            const Real score = gain / Real(std::max(box_bytes[ibox], Long(1)));
+            if (score > best_score) {
+                best_score = score;
+                best = k;
+            }
+        }
+        if (best < 0) { break; }
+
+        const int ibox = boxes[p][best];
+        boxes[p][best] = boxes[p].back();
+        boxes[p].pop_back();
+        boxes[q].push_back(ibox);
+
+        ranks.erase(std::make_pair(lmax,p));
+        ranks.erase(std::make_pair(lmin,q));
+        load[p] -= cost[ibox];
+        load[q] += cost[ibox];
+        ranks.emplace(load[p], p);
+        ranks.emplace(load[q], q);
+
+        pmap[ibox] = q;
+        moved[ibox] = 1;
+        moved_bytes += box_bytes[ibox];
+    }
+
+    return moved_bytes;
+}
+
+}
+
+DistributionMapping
+DistributionMapping::makeRebalance (const DistributionMapping& dm,
+                                    const Vector<Real>& rcost,
+                                    const Vector<Long>& box_bytes,
+                                    Long max_migration_bytes,
+                                    Real& currentEfficiency,
+                                    Real& proposedEfficiency,
+                                    Long& migrated_bytes,
+                                    int nprocs)
+{
+    BL_PROFILE("makeRebalance");
+
+    AMREX_ALWAYS_ASSERT(dm.size() == rcost.size() && dm.size() == box_bytes.size());
+
+    Vector<int> pmap = dm.ProcessorMap();
+
+    Vector<Real> load(nprocs, 0.0_rt);
+    for (int i = 0, N = pmap.size(); i < N; ++i) {
+        AMREX_ASSERT(pmap[i] >= 0 && pmap[i] < nprocs);
+        load[pmap[i]] += rcost[i];
+    }
+    currentEfficiency = rebalance_efficiency(load);
+
+    migrated_bytes = incremental_rebalance(pmap, rcost, box_bytes, max_migration_bytes, load);
+
+    proposedEfficiency = rebalance_efficiency(load);
+
+    if (verbose)
+    {
+        const Long nmoved = std::inner_product(pmap.begin(), pmap.end(),
+                                               dm.ProcessorMap().begin(), Long(0),
+                                               std::plus<Long>(), std::not_equal_to<int>());
+        amrex::Print() << "Rebalance efficiency: " << currentEfficiency << " -> "
+                       << proposedEfficiency << ", moved " << nmoved << " of "
+                       << pmap.size() << " boxes, " << migrated_bytes << " of "
+                       << std::accumulate(box_bytes.begin(), box_bytes.end(), Long(0))
+                       << " bytes (budget " << max_migration_bytes << ")\n";
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
+DistributionMapping
+DistributionMapping::makeRebalance (const LayoutData<Real>& rcost_local,
+                                    Long bytes_per_cell,
+                                    Long max_migration_bytes,
+                                    Real& currentEfficiency,
+                                    Real& proposedEfficiency,
+                                    Long& migrated_bytes,
+                                    bool broadcastToAll, int root)
+{
+    BL_PROFILE("makeRebalance");
+
+    Vector<Real> rcost(rcost_local.size());
+    ParallelDescriptor::GatherLayoutDataToVector<Real>(rcost_local, rcost, root);
+    // rcost is now filled out on root
+
+    DistributionMapping r;
+    if (ParallelDescriptor::MyProc() == root)
+    {
+        const BoxArray& ba = rcost_local.boxArray();
+        Vector<Long> box_bytes(ba.size());
+        for (int i = 0; i < ba.size(); ++i) {
+            box_bytes[i] = ba[i].numPts() * bytes_per_cell;
+        }
+
+        r = makeRebalance(rcost_local.DistributionMap(), rcost, box_bytes, max_migration_bytes,
+                          currentEfficiency, proposedEfficiency, migrated_bytes,
+                          ParallelDescriptor::NProcs());
+    }
+
+#ifdef BL_USE_MPI
+    if (broadcastToAll)
+    {
+        Vector<int> pmap(rcost_local.DistributionMap().size());
+        if (ParallelDescriptor::MyProc() == root)
+        {
+            pmap = r.ProcessorMap();
+        }
+
+        ParallelDescriptor::Bcast(&pmap[0], pmap.size(), root);
+        if (ParallelDescriptor::MyProc() != root)
+        {
+            r = DistributionMapping(pmap);
+        }
+    }
+#else
+    amrex::ignore_unused(broadcastToAll);
+#endif
+
+    return r;
+}
+
+Long
+DistributionMapping::ComputeMigrationBytes (const DistributionMapping& from,
+                                            const DistributionMapping& to,
+                                            const Vector<Long>& box_bytes)
+{
+    AMREX_ALWAYS_ASSERT(from.size() == to.size() && from.size() == box_bytes.size());
+    Long nbytes = 0;
+    for (int i = 0, N = from.size(); i < N; ++i) {
+        if (from[i] != to[i]) {
+            nbytes += box_bytes[i];
+        }
+    }
+    return nbytes;
+}
+
 void
 DistributionMapping::ComputeDistributionMappingEfficiency (const DistributionMapping& dm,
                                                            const Vector<Real>& cost,
@@ -1754,6 +2198,96 @@ DistributionMapping::makeSFC (const LayoutData<Real>& rcost_local,
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeGraph (const MultiFab& weight, bool sort)
+{
+    BL_PROFILE("makeGraph");
+    Vector<Long> cost = gather_weights(weight);
+    int nprocs = ParallelContext::NProcsSub();
+    DistributionMapping r;
+    r.GraphProcessorMap(weight.boxArray(), cost, nprocs, sort);
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeGraph (const MultiFab& weight, Real& eff, Long& comm_volume, bool sort)
+{
+    BL_PROFILE("makeGraph");
+    Vector<Long> cost = gather_weights(weight);
+    int nprocs = ParallelContext::NProcsSub();
+    DistributionMapping r;
+    r.GraphProcessorMap(weight.boxArray(), cost, nprocs, eff, comm_volume, sort);
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeGraph (const Vector<Real>& rcost, const BoxArray& ba, bool sort)
+{
+    Real eff;
+    Long comm_volume;
+    return makeGraph(rcost, ba, eff, comm_volume, sort);
+}
+
+DistributionMapping
+DistributionMapping::makeGraph (const Vector<Real>& rcost, const BoxArray& ba, Real& eff,
+                                Long& comm_volume, bool sort)
+{
+    BL_PROFILE("makeGraph");
+
+    DistributionMapping r;
+
+    Vector<Long> cost(rcost.size());
+
+    Real wmax = *std::max_element(rcost.begin(), rcost.end());
+    Real scale = (wmax == 0) ? 1.e9_rt : 1.e9_rt/wmax;
+
+    for (int i = 0; i < rcost.size(); ++i) {
+        cost[i] = Long(rcost[i]*scale) + 1L;
+    }
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    r.GraphProcessorMap(ba, cost, nprocs, eff, comm_volume, sort);
+
+    return r;
+}
+
+std::vector<std::vector<int> >
+DistributionMapping::makeGraph (const BoxArray& ba, bool use_box_vol, const int nprocs)
+{
+    BL_PROFILE("makeGraph");
+
+    const int N = ba.size();
+    std::vector<Long> wgts;
+    wgts.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        wgts.push_back(use_box_vol ? ba[i].numPts() : Long(1));
+    }
+
+    const CSRGraph graph = makeBoxGraph(ba, wgts, IntVect(graph_nghost));
+    const Vector<int> part = partitionGraph(graph, nprocs, graph_imbalance);
+
+    std::vector< std::vector<int> > r(nprocs);
+    for (int i = 0; i < N; ++i) {
+        r[part[i]].push_back(i);
+    }
+
+    return r;
+}
+
+Long
+DistributionMapping::ComputeCommunicationVolume (const BoxArray& ba,
+                                                 const DistributionMapping& dm,
+                                                 const IntVect& nghost)
+{
+    BL_PROFILE("ComputeCommunicationVolume");
+
+    AMREX_ASSERT(ba.size() == dm.size());
+    const CSRGraph graph = makeBoxGraph(ba, std::vector<Long>(ba.size(), 1L), nghost);
+    return graphEdgeCut(graph, dm.ProcessorMap());
+}
+
 std::vector<std::vector<int> >
 DistributionMapping::makeSFC (const BoxArray& ba, bool use_box_vol, const int nprocs)
 {
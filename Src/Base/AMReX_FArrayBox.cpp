@@ -466,11 +466,10 @@ FArrayBox::Finalize ()
 
 FABio*
 FABio::read_header (std::istream& is,
-                    FArrayBox&    f)
+                    Box&          bx,
+                    int&          nvar)
 {
-//    BL_PROFILE("FArrayBox::read_header_is");
-    int nvar;
-    Box bx;
+//    BL_PROFILE("FArrayBox::read_header_is_bx");
     FABio* fio = 0;
     RealDescriptor* rd = 0;
     char c;
@@ -492,12 +491,6 @@ FABio::read_header (std::istream& is,
         is >> machine;
         is >> bx;
         is >> nvar;
-        //
-        // Set the FArrayBox to the appropriate size.
-        //
-        if (f.box() != bx || f.nComp() != nvar) {
-            f.resize(bx,nvar);
-        }
         is.ignore(BL_IGNORE_MAX, '\n');
         switch (typ_in)
         {
@@ -521,12 +514,6 @@ FABio::read_header (std::istream& is,
         is >> *rd;
         is >> bx;
         is >> nvar;
-        //
-        // Set the FArrayBox to the appropriate size.
-        //
-        if (f.box() != bx || f.nComp() != nvar) {
-            f.resize(bx,nvar);
-        }
         is.ignore(BL_IGNORE_MAX, '\n');
         fio = new FABio_binary(rd);
     }
@@ -539,6 +526,24 @@ FABio::read_header (std::istream& is,
 }
 
 
+FABio*
+FABio::read_header (std::istream& is,
+                    FArrayBox&    f)
+{
+//    BL_PROFILE("FArrayBox::read_header_is");
+    int nvar;
+    Box bx;
+    FABio* fio = FABio::read_header(is, bx, nvar);
+    //
+    // Set the FArrayBox to the appropriate size.
+    //
+    if (f.box() != bx || f.nComp() != nvar) {
+        f.resize(bx,nvar);
+    }
+    return fio;
+}
+
+
 FABio*
 FABio::read_header (std::istream& is,
                     FArrayBox&    f,
@@ -546,76 +551,14 @@ FABio::read_header (std::istream& is,
                     int&          nCompAvailable)
 {
 //    BL_PROFILE("FArrayBox::read_header_is_i");
-    int nvar;
     Box bx;
-    FABio *fio = 0;
-    RealDescriptor *rd = 0;
-    char c;
-
-    is >> c;
-    if(c != 'F') amrex::Error("FABio::read_header(): expected \'F\'");
-    is >> c;
-    if(c != 'A') amrex::Error("FABio::read_header(): expected \'A\'");
-    is >> c;
-    if(c != 'B') amrex::Error("FABio::read_header(): expected \'B\'");
-
-    is >> c;
-    if(c == ':') {  // ---- The "old" FAB format.
-        int typ_in, wrd_in;
-        is >> typ_in;
-        is >> wrd_in;
-
-        char machine[128];
-        is >> machine;
-        is >> bx;
-        is >> nvar;
-        nCompAvailable = nvar;
-        nvar = 1;    // make a single component fab
-        //
-        // Set the FArrayBox to the appropriate size.
-        //
-        if (f.box() != bx || f.nComp() != nvar) {
-            f.resize(bx,nvar);
-        }
-        is.ignore(BL_IGNORE_MAX, '\n');
-        switch (typ_in)
-        {
-        case FABio::FAB_ASCII: fio = new FABio_ascii; break;
-        case FABio::FAB_8BIT:  fio = new FABio_8bit;  break;
-        case FABio::FAB_NATIVE:
-        case FABio::FAB_NATIVE_32:
-        case FABio::FAB_IEEE:
-            rd = RealDescriptor::newRealDescriptor(typ_in,
-                                                   wrd_in,
-                                                   machine,
-                                                   FArrayBox::ordering);
-            fio = new FABio_binary(rd);
-            break;
-        default:
-            amrex::Error("FABio::read_header(): Unrecognized FABio header");
-        }
-    } else {  // ---- The "new" FAB format.
-        is.putback(c);
-        rd = new RealDescriptor;
-        is >> *rd;
-        is >> bx;
-        is >> nvar;
-        nCompAvailable = nvar;
-        nvar = 1;    // make a single component fab
-        //
-        // Set the FArrayBox to the appropriate size.
-        //
-        if (f.box() != bx || f.nComp() != nvar) {
-            f.resize(bx,nvar);
-        }
-        is.ignore(BL_IGNORE_MAX, '\n');
-        fio = new FABio_binary(rd);
-    }
-
-    if(is.fail()) {
-        amrex::Error("FABio::read_header() failed");
+    FABio* fio = FABio::read_header(is, bx, nCompAvailable);
+    //
+    // Set the FArrayBox to the appropriate size, a single component fab.
+    //
+    if (f.box() != bx || f.nComp() != 1) {
+        f.resize(bx,1);
     }
-
     return fio;
 }
 
@@ -31,6 +31,7 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 int     FabArrayBase::MaxComp;
+bool    FabArrayBase::fb_neighbor_collective;
 
 #if defined(AMREX_USE_GPU)
 
@@ -102,6 +103,7 @@ FabArrayBase::Initialize ()
     // Set default values here!!!
     //
     FabArrayBase::MaxComp           = 25;
+    FabArrayBase::fb_neighbor_collective = false;
 
     ParmParse pp("fabarray");
 
@@ -118,6 +120,7 @@ FabArrayBase::Initialize ()
     }
 
     pp.queryAdd("maxcomp",             FabArrayBase::MaxComp);
+    pp.queryAdd("fb_neighbor_collective", FabArrayBase::fb_neighbor_collective);
 
     if (MaxComp < 1) {
         MaxComp = 1;
@@ -1170,7 +1173,43 @@ FabArrayBase::FB::define_os (const FabArrayBase& fa)
 }
 
 FabArrayBase::FB::~FB ()
-{}
+{
+#ifdef BL_USE_MPI
+    if (m_nbr_comm != MPI_COMM_NULL) {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized) { MPI_Comm_free(&m_nbr_comm); }
+    }
+#endif
+}
+
+#ifdef BL_USE_MPI
+MPI_Comm
+FabArrayBase::FB::neighborComm () const
+{
+    if (m_nbr_comm == MPI_COMM_NULL)
+    {
+        BL_PROFILE("FabArrayBase::FB::neighborComm()");
+
+        Vector<int> sources, destinations;
+        sources.reserve(m_RcvTags->size());
+        destinations.reserve(m_SndTags->size());
+        for (auto const& kv : *m_RcvTags) {
+            sources.push_back(ParallelContext::global_to_local_rank(kv.first));
+        }
+        for (auto const& kv : *m_SndTags) {
+            destinations.push_back(ParallelContext::global_to_local_rank(kv.first));
+        }
+        BL_MPI_REQUIRE( MPI_Dist_graph_create_adjacent(ParallelContext::CommunicatorSub(),
+                                                       static_cast<int>(sources.size()),
+                                                       sources.data(), MPI_UNWEIGHTED,
+                                                       static_cast<int>(destinations.size()),
+                                                       destinations.data(), MPI_UNWEIGHTED,
+                                                       MPI_INFO_NULL, 0, &m_nbr_comm) );
+    }
+    return m_nbr_comm;
+}
+#endif
 
 void
 FabArrayBase::flushFB (bool no_assertion) const
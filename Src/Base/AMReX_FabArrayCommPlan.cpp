@@ -0,0 +1,155 @@
+
+#include <AMReX_FabArrayCommPlan.H>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace amrex {
+
+FabArrayCommPlanBase::~FabArrayCommPlanBase ()
+{
+#ifdef AMREX_USE_MPI
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (finalized) { return; }
+    for (auto& req : m_send_reqs) {
+        if (req != MPI_REQUEST_NULL) { MPI_Request_free(&req); }
+    }
+    for (auto& req : m_recv_reqs) {
+        if (req != MPI_REQUEST_NULL) { MPI_Request_free(&req); }
+    }
+    if (m_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&m_comm);
+    }
+    if (m_the_send_data) {
+        The_FA_Arena()->free(m_the_send_data);
+    }
+    if (m_the_recv_data) {
+        The_FA_Arena()->free(m_the_recv_data);
+    }
+#endif
+}
+
+#ifdef AMREX_USE_MPI
+
+namespace {
+    // Compute the sizes and offsets of the messages in the same way as
+    // FabArray::PrepareSendBuffers and FabArray::PostRcvs.
+    std::size_t
+    comm_plan_layout (const FabArrayBase::MapOfCopyComTagContainers& tags, bool use_sbox,
+                      std::size_t bytes_per_cell, Vector<std::size_t>& offset,
+                      Vector<std::size_t>& size, Vector<int>& rank,
+                      Vector<const FabArrayBase::CopyComTagsContainer*>& cctc)
+    {
+        std::size_t total = 0;
+        for (auto const& kv : tags)
+        {
+            std::size_t nbytes = 0;
+            for (auto const& cct : kv.second)
+            {
+                nbytes += (use_sbox ? cct.sbox.numPts() : cct.dbox.numPts()) * bytes_per_cell;
+            }
+
+            std::size_t acd = ParallelDescriptor::alignof_comm_data(nbytes);
+            nbytes = amrex::aligned_size(acd, nbytes); // so that nbytes are aligned
+
+            // Also need to align the offset properly
+            total = amrex::aligned_size(std::max(std::size_t(alignof(std::max_align_t)), acd),
+                                        total);
+
+            offset.push_back(total);
+            size.push_back(nbytes);
+            rank.push_back(kv.first);
+            cctc.push_back(&(kv.second));
+            total += nbytes;
+        }
+        return total;
+    }
+}
+
+void
+FabArrayCommPlanBase::define (const MapOfCopyComTagContainers& snd_tags,
+                              const MapOfCopyComTagContainers& rcv_tags,
+                              std::size_t bytes_per_cell)
+{
+    BL_MPI_REQUIRE( MPI_Comm_dup(ParallelContext::CommunicatorSub(), &m_comm) );
+
+    Vector<std::size_t> send_offset, recv_offset;
+    Vector<int> send_rank, recv_from;
+    m_send_bytes = comm_plan_layout(snd_tags, true, bytes_per_cell, send_offset,
+                                    m_send_size, send_rank, m_send_cctc);
+    m_recv_bytes = comm_plan_layout(rcv_tags, false, bytes_per_cell, recv_offset,
+                                    m_recv_size, recv_from, m_recv_cctc);
+
+    if (m_send_bytes > 0) {
+        m_the_send_data = static_cast<char*>(The_FA_Arena()->alloc(m_send_bytes));
+    }
+    if (m_recv_bytes > 0) {
+        m_the_recv_data = static_cast<char*>(The_FA_Arena()->alloc(m_recv_bytes));
+    }
+
+    const int tag = 0; // We have the communicator to ourselves.
+
+    for (int i = 0, N = m_send_size.size(); i < N; ++i) {
+        m_send_data.push_back(m_the_send_data + send_offset[i]);
+        if (m_send_size[i] > 0) {
+            AMREX_ALWAYS_ASSERT(m_send_size[i] <= std::size_t(std::numeric_limits<int>::max()));
+            const int rank = ParallelContext::global_to_local_rank(send_rank[i]);
+            MPI_Request req;
+            BL_MPI_REQUIRE( MPI_Send_init(m_send_data[i], static_cast<int>(m_send_size[i]),
+                                          MPI_CHAR, rank, tag, m_comm, &req) );
+            m_send_reqs.push_back(req);
+        }
+    }
+
+    for (int i = 0, N = m_recv_size.size(); i < N; ++i) {
+        m_recv_data.push_back(m_the_recv_data + recv_offset[i]);
+        if (m_recv_size[i] > 0) {
+            AMREX_ALWAYS_ASSERT(m_recv_size[i] <= std::size_t(std::numeric_limits<int>::max()));
+            const int rank = ParallelContext::global_to_local_rank(recv_from[i]);
+            MPI_Request req;
+            BL_MPI_REQUIRE( MPI_Recv_init(m_recv_data[i], static_cast<int>(m_recv_size[i]),
+                                          MPI_CHAR, rank, tag, m_comm, &req) );
+            m_recv_reqs.push_back(req);
+        }
+    }
+}
+
+void
+FabArrayCommPlanBase::startRecvs ()
+{
+    if (!m_recv_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Startall(static_cast<int>(m_recv_reqs.size()), m_recv_reqs.data()) );
+    }
+}
+
+void
+FabArrayCommPlanBase::startSends ()
+{
+    if (!m_send_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Startall(static_cast<int>(m_send_reqs.size()), m_send_reqs.data()) );
+    }
+}
+
+void
+FabArrayCommPlanBase::waitRecvs ()
+{
+    if (!m_recv_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Waitall(static_cast<int>(m_recv_reqs.size()), m_recv_reqs.data(),
+                                    MPI_STATUSES_IGNORE) );
+    }
+}
+
+void
+FabArrayCommPlanBase::waitSends ()
+{
+    if (!m_send_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Waitall(static_cast<int>(m_send_reqs.size()), m_send_reqs.data(),
+                                    MPI_STATUSES_IGNORE) );
+    }
+}
+
+#endif
+
+}
@@ -0,0 +1,552 @@
+
+#include <AMReX_GraphPartition.H>
+#include <AMReX_BLProfiler.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace amrex {
+
+Long
+CSRGraph::totalVertexWeight () const noexcept
+{
+    return std::accumulate(vwgt.begin(), vwgt.end(), Long(0));
+}
+
+CSRGraph
+makeBoxGraph (const BoxArray& ba, const std::vector<Long>& wgts, const IntVect& nghost)
+{
+    BL_PROFILE("makeBoxGraph()");
+
+    const int N = ba.size();
+    AMREX_ASSERT(N == static_cast<int>(wgts.size()));
+
+    // Edges i -> j weighted by the number of ghost cells of i in box j.
+    Vector<Vector<std::pair<int,Long> > > nbrs(N);
+    std::vector<std::pair<int,Box> > isects;
+    for (int i = 0; i < N; ++i) {
+        ba.intersections(amrex::grow(ba[i],nghost), isects);
+        for (auto const& is : isects) {
+            if (is.first != i) {
+                const Long w = is.second.numPts();
+                nbrs[i].emplace_back(is.first, w);
+                nbrs[is.first].emplace_back(i, w);
+            }
+        }
+    }
+
+    CSRGraph g;
+    g.vwgt.assign(wgts.begin(), wgts.end());
+    g.xadj.resize(N+1);
+    g.xadj[0] = 0;
+    for (int i = 0; i < N; ++i) {
+        auto& nb = nbrs[i];
+        std::sort(nb.begin(), nb.end());
+        // Merge the two directions of the same edge.
+        for (int k = 0, M = nb.size(); k < M; ) {
+            const int j = nb[k].first;
+            Long w = 0;
+            for (; k < M && nb[k].first == j; ++k) {
+                w += nb[k].second;
+            }
+            g.adjncy.push_back(j);
+            g.adjwgt.push_back(w);
+        }
+        g.xadj[i+1] = static_cast<int>(g.adjncy.size());
+        Vector<std::pair<int,Long> >().swap(nb);
+    }
+    return g;
+}
+
+CSRGraph
+subGraph (const CSRGraph& g, const Vector<int>& vertices)
+{
+    const int N = vertices.size();
+    Vector<int> local(g.numVertices(), -1);
+    for (int i = 0; i < N; ++i) {
+        local[vertices[i]] = i;
+    }
+
+    CSRGraph sg;
+    sg.vwgt.resize(N);
+    sg.xadj.resize(N+1);
+    sg.xadj[0] = 0;
+    for (int i = 0; i < N; ++i) {
+        const int v = vertices[i];
+        sg.vwgt[i] = g.vwgt[v];
+        for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k) {
+            const int u = local[g.adjncy[k]];
+            if (u >= 0) {
+                sg.adjncy.push_back(u);
+                sg.adjwgt.push_back(g.adjwgt[k]);
+            }
+        }
+        sg.xadj[i+1] = static_cast<int>(sg.adjncy.size());
+    }
+    return sg;
+}
+
+Long
+graphEdgeCut (const CSRGraph& g, const Vector<int>& part)
+{
+    Long cut = 0;
+    for (int v = 0, N = g.numVertices(); v < N; ++v) {
+        for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k) {
+            if (part[v] != part[g.adjncy[k]]) {
+                cut += g.adjwgt[k];
+            }
+        }
+    }
+    return cut/2; // Each edge is stored twice.
+}
+
+namespace {
+
+// A small deterministic generator, so that every process computes the same
+// partition regardless of the standard library.
+struct GPRandom
+{
+    std::uint64_t s = 0x9E3779B97F4A7C15ULL;
+    std::uint64_t operator() () noexcept {
+        s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+        return s;
+    }
+    int operator() (int n) noexcept { return static_cast<int>((*this)() % std::uint64_t(n)); }
+};
+
+constexpr int coarsest_size = 64;
+
+// Coarsen by heavy-edge matching.  cmap maps vertices of g to vertices of the result.
+CSRGraph
+coarsen (const CSRGraph& g, Long maxvwgt, Vector<int>& cmap, GPRandom& rng)
+{
+    const int N = g.numVertices();
+
+    Vector<int> perm(N);
+    std::iota(perm.begin(), perm.end(), 0);
+    for (int i = N-1; i > 0; --i) {
+        std::swap(perm[i], perm[rng(i+1)]);
+    }
+
+    Vector<int> match(N, -1);
+    for (int u : perm) {
+        if (match[u] >= 0) { continue; }
+        int best = u;
+        Long bestw = -1;
+        for (int k = g.xadj[u]; k < g.xadj[u+1]; ++k) {
+            const int v = g.adjncy[k];
+            if (match[v] < 0 && v != u && g.adjwgt[k] > bestw
+                && g.vwgt[u]+g.vwgt[v] <= maxvwgt)
+            {
+                best = v;
+                bestw = g.adjwgt[k];
+            }
+        }
+        match[u] = best;
+        match[best] = u;
+    }
+
+    cmap.assign(N, -1);
+    int nc = 0;
+    for (int u = 0; u < N; ++u) {
+        if (cmap[u] < 0) {
+            cmap[u] = nc;
+            cmap[match[u]] = nc;
+            ++nc;
+        }
+    }
+
+    CSRGraph cg;
+    cg.vwgt.assign(nc, 0);
+    cg.xadj.resize(nc+1);
+    cg.xadj[0] = 0;
+    cg.adjncy.reserve(g.adjncy.size());
+    cg.adjwgt.reserve(g.adjwgt.size());
+    Vector<int> pos(nc, -1);
+    int c = 0;
+    for (int u = 0; u < N; ++u) {
+        if (cmap[u] != c) { continue; } // Each coarse vertex is built once, in order.
+        const int begin = static_cast<int>(cg.adjncy.size());
+        const int pair[2] = {u, match[u]};
+        const int nv = (match[u] == u) ? 1 : 2;
+        for (int m = 0; m < nv; ++m) {
+            const int v = pair[m];
+            cg.vwgt[c] += g.vwgt[v];
+            for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k) {
+                const int cu = cmap[g.adjncy[k]];
+                if (cu == c) { continue; }
+                if (pos[cu] < begin) {
+                    pos[cu] = static_cast<int>(cg.adjncy.size());
+                    cg.adjncy.push_back(cu);
+                    cg.adjwgt.push_back(g.adjwgt[k]);
+                } else {
+                    cg.adjwgt[pos[cu]] += g.adjwgt[k];
+                }
+            }
+        }
+        cg.xadj[c+1] = static_cast<int>(cg.adjncy.size());
+        ++c;
+    }
+    return cg;
+}
+
+// Fiduccia-Mattheyses refinement of a bisection.  The weight of part 0
+// should be within tol of tw0.
+void
+refineBisection (const CSRGraph& g, Vector<int>& part, Long tw0, Long tol, Long& cut)
+{
+    const int N = g.numVertices();
+    if (N < 2) { return; }
+
+    Long w0 = 0;
+    for (int v = 0; v < N; ++v) {
+        if (part[v] == 0) { w0 += g.vwgt[v]; }
+    }
+
+    auto imbalance = [=] (Long w) { return std::max(Long(0), std::abs(w-tw0)-tol); };
+
+    Vector<Long> gain(N);
+    Vector<char> locked(N);
+    Vector<int> moves;
+    moves.reserve(N);
+    const int max_bad_moves = std::max(25, N/50);
+
+    for (int pass = 0; pass < 8; ++pass)
+    {
+        using GV = std::pair<Long,int>;
+        std::priority_queue<GV> pq;
+        for (int v = 0; v < N; ++v) {
+            Long ed = 0, id = 0;
+            for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k) {
+                if (part[g.adjncy[k]] == part[v]) {
+                    id += g.adjwgt[k];
+                } else {
+                    ed += g.adjwgt[k];
+                }
+            }
+            gain[v] = ed - id;
+            locked[v] = 0;
+            if (ed > 0 || imbalance(w0) > 0) {
+                pq.emplace(gain[v], v);
+            }
+        }
+
+        moves.clear();
+        const Long start_cut = cut;
+        const Long start_imb = imbalance(w0);
+        Long best_cut = cut, best_imb = start_imb;
+        int best_nmoves = 0;
+
+        while (!pq.empty())
+        {
+            const auto gv = pq.top();
+            pq.pop();
+            const int v = gv.second;
+            if (locked[v] || gv.first != gain[v]) { continue; }
+
+            const Long new_w0 = (part[v] == 0) ? w0 - g.vwgt[v] : w0 + g.vwgt[v];
+            const Long new_imb = imbalance(new_w0);
+            if (new_imb > 0 && new_imb >= imbalance(w0)) { continue; }
+
+            locked[v] = 1;
+            const int to = 1 - part[v];
+            part[v] = to;
+            w0 = new_w0;
+            cut -= gain[v];
+            moves.push_back(v);
+            for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k) {
+                const int u = g.adjncy[k];
+                if (locked[u]) { continue; }
+                gain[u] += (part[u] == to) ? -2*g.adjwgt[k] : 2*g.adjwgt[k];
+                pq.emplace(gain[u], u);
+            }
+
+            if (new_imb < best_imb || (new_imb == best_imb && cut < best_cut)) {
+                best_cut = cut;
+                best_imb = new_imb;
+                best_nmoves = static_cast<int>(moves.size());
+            } else if (static_cast<int>(moves.size()) - best_nmoves > max_bad_moves) {
+                break;
+            }
+        }
+
+        // Roll back to the best state.
+        for (int i = static_cast<int>(moves.size())-1; i >= best_nmoves; --i) {
+            const int v = moves[i];
+            w0 += (part[v] == 0) ? -g.vwgt[v] : g.vwgt[v];
+            part[v] = 1 - part[v];
+        }
+        cut = best_cut;
+
+        if (best_cut >= start_cut && best_imb >= start_imb) { break; }
+    }
+}
+
+// Greedy graph growing from a few seeds, keeping the best result.
+Vector<int>
+initialBisection (const CSRGraph& g, Long tw0, Long tol, GPRandom& rng)
+{
+    const int N = g.numVertices();
+    Vector<int> best_part(N, 1);
+    Long best_cut = std::numeric_limits<Long>::max();
+    Long best_imb = std::numeric_limits<Long>::max();
+
+    const int ntrials = std::min(N, 8);
+    Vector<int> part(N);
+    Vector<Long> conn(N);
+    for (int trial = 0; trial < ntrials; ++trial)
+    {
+        std::fill(part.begin(), part.end(), 1);
+        std::fill(conn.begin(), conn.end(), 0);
+        using GV = std::pair<Long,int>;
+        std::priority_queue<GV> pq;
+        Long w0 = 0;
+        int next_unvisited = 0;
+        pq.emplace(0, rng(N));
+        while (w0 < tw0)
+        {
+            int v = -1;
+            while (!pq.empty()) {
+                const auto gv = pq.top();
+                pq.pop();
+                if (part[gv.second] == 1 && gv.first == conn[gv.second]) {
+                    v = gv.second;
+                    break;
+                }
+            }
+            if (v < 0) { // Disconnected graph
+                while (next_unvisited < N && part[next_unvisited] == 0) { ++next_unvisited; }
+                if (next_unvisited == N) { break; }
+                v = next_unvisited;
+            }
+            // Stop if adding v would overshoot more than stopping here.
+            if (w0 > 0 && (w0 + g.vwgt[v] - tw0) > (tw0 - w0)) { break; }
+            part[v] = 0;
+            w0 += g.vwgt[v];
+            for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k) {
+                const int u = g.adjncy[k];
+                if (part[u] == 1) {
+                    conn[u] += g.adjwgt[k];
+                    pq.emplace(conn[u], u);
+                }
+            }
+        }
+
+        Long cut = graphEdgeCut(g, part);
+        refineBisection(g, part, tw0, tol, cut);
+
+        Long w = 0;
+        for (int v = 0; v < N; ++v) {
+            if (part[v] == 0) { w += g.vwgt[v]; }
+        }
+        const Long imb = std::max(Long(0), std::abs(w-tw0)-tol);
+        if (imb < best_imb || (imb == best_imb && cut < best_cut)) {
+            best_imb = imb;
+            best_cut = cut;
+            best_part = part;
+        }
+    }
+    return best_part;
+}
+
+Long
+maxVertexWeight (const CSRGraph& g)
+{
+    return g.vwgt.empty() ? Long(0) : *std::max_element(g.vwgt.begin(), g.vwgt.end());
+}
+
+// Multilevel bisection with a weight of tw0 in part 0.
+Vector<int>
+multilevelBisection (const CSRGraph& g, Long tw0, Long tol, GPRandom& rng)
+{
+    const Long total = g.totalVertexWeight();
+
+    Vector<CSRGraph> graphs;
+    Vector<Vector<int> > cmaps;
+    const Long maxvwgt = std::max(Long(1), Long(1.5*double(total)/coarsest_size));
+    const CSRGraph* cur = &g;
+    while (cur->numVertices() > coarsest_size)
+    {
+        Vector<int> cmap;
+        CSRGraph cg = coarsen(*cur, maxvwgt, cmap, rng);
+        if (cg.numVertices() > 0.95*cur->numVertices()) { break; }
+        cmaps.push_back(std::move(cmap));
+        graphs.push_back(std::move(cg));
+        cur = &graphs.back();
+    }
+
+    // On coarse levels, the tolerance has to be at least the weight of a
+    // vertex, or no vertex could move.
+    Vector<int> part = initialBisection(*cur, tw0, std::max(tol,maxVertexWeight(*cur)), rng);
+
+    for (int lev = static_cast<int>(cmaps.size())-1; lev >= 0; --lev)
+    {
+        const CSRGraph& fg = (lev == 0) ? g : graphs[lev-1];
+        Vector<int> fpart(fg.numVertices());
+        for (int v = 0, N = fg.numVertices(); v < N; ++v) {
+            fpart[v] = part[cmaps[lev][v]];
+        }
+        part = std::move(fpart);
+        Long cut = graphEdgeCut(fg, part);
+        refineBisection(fg, part, tw0, (lev == 0) ? tol : std::max(tol,maxVertexWeight(fg)), cut);
+    }
+
+    return part;
+}
+
+// Bisection with a fraction frac of the total weight in part 0.  This keeps
+// the best of a few multilevel bisections.
+Vector<int>
+bisect (const CSRGraph& g, double frac, Real imbalance, GPRandom& rng)
+{
+    const Long total = g.totalVertexWeight();
+    const Long tw0 = static_cast<Long>(std::llround(frac*double(total)));
+    const Long tol = static_cast<Long>(double(imbalance)*double(std::min(tw0,total-tw0)));
+
+    constexpr int ntries = 4;
+    Vector<int> best_part;
+    Long best_cut = 0, best_imb = 0;
+    for (int itry = 0; itry < ntries; ++itry)
+    {
+        Vector<int> part = multilevelBisection(g, tw0, tol, rng);
+        Long w0 = 0;
+        for (int v = 0, N = g.numVertices(); v < N; ++v) {
+            if (part[v] == 0) { w0 += g.vwgt[v]; }
+        }
+        const Long imb = std::max(Long(0), std::abs(w0-tw0)-tol);
+        const Long cut = graphEdgeCut(g, part);
+        if (itry == 0 || imb < best_imb || (imb == best_imb && cut < best_cut)) {
+            best_part = std::move(part);
+            best_cut = cut;
+            best_imb = imb;
+        }
+    }
+    return best_part;
+}
+
+void
+recursiveBisection (const CSRGraph& g, const Vector<int>& vertices, int nparts, int first_part,
+                    Real imbalance, GPRandom& rng, Vector<int>& result)
+{
+    if (nparts == 1 || vertices.size() <= 1) {
+        for (int v : vertices) { result[v] = first_part; }
+        return;
+    }
+
+    const int nparts0 = nparts/2;
+    Vector<int> part = bisect(g, double(nparts0)/double(nparts), imbalance, rng);
+
+    Vector<int> lv[2], gv[2];
+    for (int i = 0, N = vertices.size(); i < N; ++i) {
+        lv[part[i]].push_back(i);
+        gv[part[i]].push_back(vertices[i]);
+    }
+    for (int p = 0; p < 2; ++p) {
+        CSRGraph sg = subGraph(g, lv[p]);
+        recursiveBisection(sg, gv[p], (p == 0) ? nparts0 : nparts-nparts0,
+                           (p == 0) ? first_part : first_part+nparts0,
+                           imbalance, rng, result);
+    }
+}
+
+// Move boundary vertices between parts to reduce the cut and restore balance.
+void
+refineKWay (const CSRGraph& g, Vector<int>& part, int nparts, Real imbalance)
+{
+    const int N = g.numVertices();
+    Vector<Long> pw(nparts, 0);
+    Vector<int> pn(nparts, 0);
+    Long maxv = 0;
+    for (int v = 0; v < N; ++v) {
+        pw[part[v]] += g.vwgt[v];
+        pn[part[v]]++;
+        maxv = std::max(maxv, g.vwgt[v]);
+    }
+    const double avg = double(g.totalVertexWeight())/double(nparts);
+    const Long maxw = std::max(static_cast<Long>((1.0+double(imbalance))*avg), maxv);
+
+    Vector<Long> conn(nparts, 0);
+    Vector<int> nbparts;
+    for (int pass = 0; pass < 10; ++pass)
+    {
+        int nmoved = 0;
+        for (int v = 0; v < N; ++v)
+        {
+            const int from = part[v];
+            if (pn[from] == 1) { continue; } // Do not empty a part.
+
+            nbparts.clear();
+            for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k) {
+                const int p = part[g.adjncy[k]];
+                if (conn[p] == 0) { nbparts.push_back(p); }
+                conn[p] += g.adjwgt[k];
+            }
+            const Long id = conn[from];
+            const bool overweight = pw[from] > maxw;
+
+            int to = -1;
+            Long best_gain = std::numeric_limits<Long>::lowest();
+            for (int q : nbparts) {
+                if (q == from) { continue; }
+                const Long gain = conn[q] - id;
+                const Long new_wq = pw[q] + g.vwgt[v];
+                bool ok;
+                if (overweight) {
+                    ok = new_wq < pw[from];
+                } else {
+                    ok = new_wq <= maxw && (gain > 0 || (gain == 0 && new_wq < pw[from]));
+                }
+                if (ok && (to < 0 || gain > best_gain || (gain == best_gain && pw[q] < pw[to]))) {
+                    to = q;
+                    best_gain = gain;
+                }
+            }
+            if (to < 0 && overweight) {
+                // No suitable neighbor.  Move it to the lightest part instead.
+                const int q = static_cast<int>(std::min_element(pw.begin(), pw.end()) - pw.begin());
+                if (pw[q] + g.vwgt[v] < pw[from]) { to = q; }
+            }
+
+            for (int p : nbparts) { conn[p] = 0; }
+
+            if (to >= 0) {
+                part[v] = to;
+                pw[from] -= g.vwgt[v];
+                pw[to] += g.vwgt[v];
+                pn[from]--;
+                pn[to]++;
+                ++nmoved;
+            }
+        }
+        if (nmoved == 0) { break; }
+    }
+}
+
+}
+
+Vector<int>
+partitionGraph (const CSRGraph& g, int nparts, Real imbalance)
+{
+    BL_PROFILE("partitionGraph()");
+
+    AMREX_ALWAYS_ASSERT(nparts > 0);
+    const int N = g.numVertices();
+    Vector<int> part(N, 0);
+    if (nparts == 1 || N == 0) { return part; }
+
+    GPRandom rng;
+    Vector<int> vertices(N);
+    std::iota(vertices.begin(), vertices.end(), 0);
+    recursiveBisection(g, vertices, nparts, 0, imbalance, rng, part);
+
+    refineKWay(g, part, nparts, imbalance);
+
+    return part;
+}
+
+}
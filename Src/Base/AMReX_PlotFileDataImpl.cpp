@@ -127,19 +127,62 @@ MultiFab
 PlotFileDataImpl::get (int level, std::string const& varname) noexcept
 {
     MultiFab mf(m_ba[level], m_dmap[level], 1, m_ngrow[level]);
+    const int icomp = varIndex(varname);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        int gid = mfi.index();
+        FArrayBox& dstfab = mf[mfi];
+        std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
+        dstfab.copy<RunOn::Host>(*srcfab);
+    }
+    return mf;
+}
+
+FArrayBox
+PlotFileDataImpl::get (int level, Box const& box, int icomp, int ncomp) noexcept
+{
+    FArrayBox fab(box, ncomp, The_Pinned_Arena());
+    fab.setVal<RunOn::Host>(0.0);
+    for (auto const& is : m_ba[level].intersections(box)) {
+        m_vismf[level]->readFAB(fab, is.second, is.first, icomp);
+    }
+    return fab;
+}
+
+FArrayBox
+PlotFileDataImpl::get (int level, Box const& box, std::string const& varname) noexcept
+{
+    return get(level, box, varIndex(varname), 1);
+}
+
+std::pair<Real,Real>
+PlotFileDataImpl::minmax (int level, std::string const& varname) noexcept
+{
+    const int icomp = varIndex(varname);
+    VisMF const& vismf = *m_vismf[level];
+    Real mn = vismf.min(icomp);
+    Real mx = vismf.max(icomp);
+    if (mn > mx) {  // Not in the header for the FabArray, try the fabs.
+        for (int i = 0, N = vismf.size(); i < N; ++i) {
+            mn = std::min(mn, vismf.min(i,icomp));
+            mx = std::max(mx, vismf.max(i,icomp));
+        }
+    }
+    if (mn > mx) {  // Not in the header at all
+        MultiFab const& mf = get(level, varname);
+        mn = mf.min(0);
+        mx = mf.max(0);
+    }
+    return std::make_pair(mn, mx);
+}
+
+int
+PlotFileDataImpl::varIndex (std::string const& varname) const noexcept
+{
     auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
     if (r == std::end(m_var_names)) {
         amrex::Abort("PlotFileDataImpl::get: varname not found "+varname);
-    } else {
-        int icomp = std::distance(std::begin(m_var_names), r);
-        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-            int gid = mfi.index();
-            FArrayBox& dstfab = mf[mfi];
-            std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
-            dstfab.copy<RunOn::Host>(*srcfab);
-        }
     }
-    return mf;
+    return static_cast<int>(std::distance(std::begin(m_var_names), r));
 }
 
 }
@@ -0,0 +1,463 @@
+
+#include <AMReX_TArena.H>
+#include <AMReX_Algorithm.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Gpu.H>
+#include <AMReX_ParallelReduce.H>
+
+#include <algorithm>
+#include <limits>
+
+namespace amrex {
+
+namespace {
+    // Index of the lowest set bit.  x must not be zero.
+    int tarena_ffs (std::uint64_t x) noexcept
+    {
+        return 63 - amrex::clz(std::uint64_t(x & (~x + 1)));
+    }
+
+    int tarena_ffs (std::uint32_t x) noexcept
+    {
+        return 31 - amrex::clz(std::uint32_t(x & (~x + 1)));
+    }
+
+    // Index of the highest set bit.  x must not be zero.
+    int tarena_fls (std::uint64_t x) noexcept
+    {
+        return 63 - amrex::clz(x);
+    }
+
+    int tarena_fls (std::uint32_t x) noexcept
+    {
+        return 31 - amrex::clz(x);
+    }
+}
+
+TArena::TArena (std::size_t hunk_size, ArenaInfo info)
+{
+    static_assert(Arena::align_size == (std::size_t(1) << align_log2),
+                  "TArena: align_log2 is inconsistent with Arena::align_size");
+
+    arena_info = info;
+    //
+    // Force alignment of hunksize.
+    //
+    m_hunk = Arena::align(hunk_size == 0 ? DefaultHunkSize : hunk_size);
+
+    for (auto& heads : m_free_heads) {
+        heads.fill(null_node);
+    }
+    m_sl_bitmap.fill(0);
+
+    BL_ASSERT(m_hunk >= hunk_size);
+    BL_ASSERT(m_hunk%Arena::align_size == 0);
+}
+
+TArena::~TArena ()
+{
+    for (auto const& h : m_alloc) {
+        deallocate_system(h.p, h.size);
+    }
+}
+
+int
+TArena::newNode ()
+{
+    if (m_node_pool.empty()) {
+        m_nodes.emplace_back();
+        return static_cast<int>(m_nodes.size()) - 1;
+    } else {
+        int n = m_node_pool.back();
+        m_node_pool.pop_back();
+        m_nodes[n] = Node{};
+        return n;
+    }
+}
+
+void
+TArena::deleteNode (int n)
+{
+    m_node_pool.push_back(n);
+}
+
+void
+TArena::mapping_insert (std::size_t sz, int& fl, int& sl) noexcept
+{
+    if (sz < small_block_size) {
+        fl = 0;
+        sl = static_cast<int>(sz >> align_log2);
+    } else {
+        int msb = tarena_fls(std::uint64_t(sz));
+        fl = msb - (sl_log2+align_log2) + 1;
+        sl = static_cast<int>(sz >> (msb-sl_log2)) ^ sl_count;
+    }
+}
+
+void
+TArena::mapping_search (std::size_t sz, int& fl, int& sl) noexcept
+{
+    //
+    // Round up to the next bin boundary so that every block in the bin is
+    // large enough.
+    //
+    if (sz >= small_block_size) {
+        int msb = tarena_fls(std::uint64_t(sz));
+        std::size_t round = (std::size_t(1) << (msb-sl_log2)) - 1;
+        if (sz <= std::numeric_limits<std::size_t>::max() - round) {
+            sz += round;
+        }
+    }
+    mapping_insert(sz, fl, sl);
+}
+
+int
+TArena::findFreeBlock (std::size_t sz) const noexcept
+{
+    int fl, sl;
+    mapping_search(sz, fl, sl);
+    if (fl >= fl_count) { return null_node; }
+
+    std::uint32_t sl_map = m_sl_bitmap[fl] & (~std::uint32_t(0) << sl);
+    if (sl_map == 0) {
+        std::uint64_t fl_map = (fl+1 < 64) ? (m_fl_bitmap & (~std::uint64_t(0) << (fl+1))) : 0;
+        if (fl_map == 0) {
+            //
+            // As a last resort before asking the system for more memory,
+            // look for a large enough block in the bin sz itself maps to.
+            //
+            mapping_insert(sz, fl, sl);
+            for (int n = m_free_heads[fl][sl]; n != null_node; n = m_nodes[n].next_free) {
+                if (m_nodes[n].size >= sz) { return n; }
+            }
+            return null_node;
+        }
+        fl = tarena_ffs(fl_map);
+        sl_map = m_sl_bitmap[fl];
+    }
+    sl = tarena_ffs(sl_map);
+
+    BL_ASSERT(m_free_heads[fl][sl] != null_node);
+    BL_ASSERT(m_nodes[m_free_heads[fl][sl]].size >= sz);
+    return m_free_heads[fl][sl];
+}
+
+std::size_t
+TArena::roundUpToBin (std::size_t sz) noexcept
+{
+    if (sz >= small_block_size) {
+        int msb = tarena_fls(std::uint64_t(sz));
+        std::size_t mask = (std::size_t(1) << (msb-sl_log2)) - 1;
+        if (sz <= std::numeric_limits<std::size_t>::max() - mask) {
+            sz = (sz + mask) & ~mask;
+        }
+    }
+    return sz;
+}
+
+void
+TArena::insertFreeBlock (int n) noexcept
+{
+    Node& node = m_nodes[n];
+    int fl, sl;
+    mapping_insert(node.size, fl, sl);
+
+    int head = m_free_heads[fl][sl];
+    node.prev_free = null_node;
+    node.next_free = head;
+    if (head != null_node) {
+        m_nodes[head].prev_free = n;
+    }
+    m_free_heads[fl][sl] = n;
+    m_fl_bitmap |= std::uint64_t(1) << fl;
+    m_sl_bitmap[fl] |= std::uint32_t(1) << sl;
+
+    node.free = true;
+    ++m_nfree;
+}
+
+void
+TArena::removeFreeBlock (int n) noexcept
+{
+    Node& node = m_nodes[n];
+    BL_ASSERT(node.free);
+    int fl, sl;
+    mapping_insert(node.size, fl, sl);
+
+    if (node.prev_free != null_node) {
+        m_nodes[node.prev_free].next_free = node.next_free;
+    }
+    if (node.next_free != null_node) {
+        m_nodes[node.next_free].prev_free = node.prev_free;
+    }
+    if (m_free_heads[fl][sl] == n) {
+        m_free_heads[fl][sl] = node.next_free;
+        if (node.next_free == null_node) {
+            m_sl_bitmap[fl] &= ~(std::uint32_t(1) << sl);
+            if (m_sl_bitmap[fl] == 0) {
+                m_fl_bitmap &= ~(std::uint64_t(1) << fl);
+            }
+        }
+    }
+    node.prev_free = null_node;
+    node.next_free = null_node;
+
+    node.free = false;
+    --m_nfree;
+}
+
+void*
+TArena::alloc (std::size_t nbytes)
+{
+    std::lock_guard<std::mutex> lock(tarena_mutex);
+
+    nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
+
+    if (static_cast<Long>(m_used+nbytes) >= arena_info.release_threshold) {
+        freeUnused_protected();
+    }
+
+    int n = findFreeBlock(nbytes);
+
+    if (n == null_node)
+    {
+        //
+        // Large requests are rounded up to the bin boundary, so that the
+        // block can be reused for any request in the same bin later.
+        //
+        const std::size_t N = nbytes < m_hunk ? m_hunk : roundUpToBin(nbytes);
+
+        void* vp = allocate_system(N);
+
+        m_used += N;
+
+        n = newNode();
+        m_nodes[n].block = static_cast<char*>(vp);
+        m_nodes[n].size = N;
+
+        m_alloc.push_back(Hunk{vp, N, n});
+    }
+    else
+    {
+        removeFreeBlock(n);
+    }
+
+    if (m_nodes[n].size > nbytes)
+    {
+        //
+        // Put the remainder of the block back into the free bins.
+        //
+        int r = newNode(); // Note that this may invalidate references into m_nodes.
+        Node& node = m_nodes[n];
+        Node& rest = m_nodes[r];
+        rest.block = node.block + nbytes;
+        rest.size = node.size - nbytes;
+        rest.prev_phys = n;
+        rest.next_phys = node.next_phys;
+        if (node.next_phys != null_node) {
+            m_nodes[node.next_phys].prev_phys = r;
+        }
+        node.next_phys = r;
+        node.size = nbytes;
+        insertFreeBlock(r);
+    }
+
+    void* vp = m_nodes[n].block;
+    m_busylist.emplace(vp, n);
+
+    m_actually_used += nbytes;
+
+    BL_ASSERT(vp != nullptr);
+
+    return vp;
+}
+
+void
+TArena::free (void* vp)
+{
+    if (vp == nullptr) {
+        //
+        // Allow calls with NULL as allowed by C++ delete.
+        //
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(tarena_mutex);
+
+    auto busy_it = m_busylist.find(vp);
+    if (busy_it == m_busylist.end()) {
+        amrex::Abort("TArena::free: unknown pointer");
+        return;
+    }
+
+    int n = busy_it->second;
+    m_busylist.erase(busy_it);
+
+    m_actually_used -= m_nodes[n].size;
+
+    //
+    // Coalesce with free blocks on the lo and hi side of this block.  The
+    // lo side block survives the merge, so the node at the start of a hunk
+    // never changes.
+    //
+    int lo = m_nodes[n].prev_phys;
+    if (lo != null_node && m_nodes[lo].free)
+    {
+        removeFreeBlock(lo);
+        m_nodes[lo].size += m_nodes[n].size;
+        m_nodes[lo].next_phys = m_nodes[n].next_phys;
+        if (m_nodes[n].next_phys != null_node) {
+            m_nodes[m_nodes[n].next_phys].prev_phys = lo;
+        }
+        deleteNode(n);
+        n = lo;
+    }
+
+    int hi = m_nodes[n].next_phys;
+    if (hi != null_node && m_nodes[hi].free)
+    {
+        removeFreeBlock(hi);
+        m_nodes[n].size += m_nodes[hi].size;
+        m_nodes[n].next_phys = m_nodes[hi].next_phys;
+        if (m_nodes[hi].next_phys != null_node) {
+            m_nodes[m_nodes[hi].next_phys].prev_phys = n;
+        }
+        deleteNode(hi);
+    }
+
+    insertFreeBlock(n);
+}
+
+std::size_t
+TArena::freeUnused ()
+{
+    std::lock_guard<std::mutex> lock(tarena_mutex);
+    return freeUnused_protected();
+}
+
+std::size_t
+TArena::freeUnused_protected ()
+{
+    std::size_t nbytes = 0;
+    m_alloc.erase(std::remove_if(m_alloc.begin(), m_alloc.end(),
+                                 [&nbytes,this] (Hunk const& h)
+                                 {
+                                     Node const& node = m_nodes[h.node];
+                                     if (node.free && node.size == h.size) {
+                                         removeFreeBlock(h.node);
+                                         deleteNode(h.node);
+                                         nbytes += h.size;
+                                         deallocate_system(h.p, h.size);
+                                         return true;
+                                     }
+                                     return false;
+                                 }),
+                  m_alloc.end());
+    m_used -= nbytes;
+    return nbytes;
+}
+
+bool
+TArena::hasFreeDeviceMemory (std::size_t sz)
+{
+#ifdef AMREX_USE_GPU
+    if (isDevice() || isManaged()) {
+        std::lock_guard<std::mutex> lock(tarena_mutex);
+
+        std::size_t nbytes = Arena::align(sz == 0 ? 1 : sz);
+
+        if (static_cast<Long>(m_used+nbytes) >= arena_info.release_threshold) {
+            freeUnused_protected();
+        }
+
+        if (findFreeBlock(nbytes) == null_node) {
+            const std::size_t N = nbytes < m_hunk ? m_hunk : nbytes;
+            return Gpu::Device::freeMemAvailable() > N;
+        } else {
+            return true;
+        }
+    } else
+#endif
+    {
+        amrex::ignore_unused(sz);
+        return true;
+    }
+}
+
+std::size_t
+TArena::heap_space_used () const noexcept
+{
+    return m_used;
+}
+
+std::size_t
+TArena::heap_space_actually_used () const noexcept
+{
+    return m_actually_used;
+}
+
+std::size_t
+TArena::sizeOf (void* p) const noexcept
+{
+    if (p == nullptr) {
+        return 0;
+    } else {
+        auto it = m_busylist.find(p);
+        if (it == m_busylist.end()) {
+            return 0;
+        } else {
+            return m_nodes[it->second].size;
+        }
+    }
+}
+
+std::size_t
+TArena::largest_free_block () const noexcept
+{
+    std::lock_guard<std::mutex> lock(tarena_mutex);
+    if (m_fl_bitmap == 0) { return 0; }
+    int fl = tarena_fls(m_fl_bitmap);
+    int sl = tarena_fls(m_sl_bitmap[fl]);
+    std::size_t r = 0;
+    for (int n = m_free_heads[fl][sl]; n != null_node; n = m_nodes[n].next_free) {
+        r = std::max(r, m_nodes[n].size);
+    }
+    return r;
+}
+
+void
+TArena::PrintUsage (std::string const& name) const
+{
+    Long min_megabytes = heap_space_used() / (1024*1024);
+    Long max_megabytes = min_megabytes;
+    Long actual_min_megabytes = heap_space_actually_used() / (1024*1024);
+    Long actual_max_megabytes = actual_min_megabytes;
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+    ParallelReduce::Min<Long>({min_megabytes, actual_min_megabytes},
+                              IOProc, ParallelDescriptor::Communicator());
+    ParallelReduce::Max<Long>({max_megabytes, actual_max_megabytes},
+                              IOProc, ParallelDescriptor::Communicator());
+#ifdef AMREX_USE_MPI
+    amrex::Print() << "[" << name << "] space (MB) allocated spread across MPI: ["
+                   << min_megabytes << " ... " << max_megabytes << "]\n"
+                   << "[" << name << "] space (MB) used      spread across MPI: ["
+                   << actual_min_megabytes << " ... " << actual_max_megabytes << "]\n";
+#else
+    amrex::Print() << "[" << name << "] space allocated (MB): " << min_megabytes << "\n";
+    amrex::Print() << "[" << name << "] space used      (MB): " << actual_min_megabytes << "\n";
+#endif
+}
+
+void
+TArena::PrintUsage (std::ostream& os, std::string const& name, std::string const& space) const
+{
+    Long megabytes = heap_space_used() / (1024*1024);
+    Long actual_megabytes = heap_space_actually_used() / (1024*1024);
+    os << space << "[" << name << "] space allocated (MB): " << megabytes << "\n";
+    os << space << "[" << name << "] space used      (MB): " << actual_megabytes << "\n";
+    os << space << "[" << name << "]: " << m_alloc.size() << " allocs, "
+       << m_busylist.size() << " busy blocks, " << m_nfree << " free blocks, "
+       << largest_free_block() << " bytes in largest free block\n";
+}
+
+}
@@ -0,0 +1,212 @@
+
+#include <AMReX_ThreadCacheArena.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+
+namespace amrex {
+
+ThreadCacheArena::ThreadCacheArena (Arena* parent, int magazine_size,
+                                    std::size_t max_cached_bytes)
+    : m_parent(parent),
+      m_magazine_size(std::max(magazine_size,1)),
+      m_max_cached_bytes(max_cached_bytes),
+      m_caches(OpenMP::get_max_threads())
+{
+    BL_ASSERT(m_parent != nullptr);
+    BL_ASSERT(m_parent->isHostAccessible());
+    arena_info = m_parent->arenaInfo();
+    for (auto& tc : m_caches) {
+        for (auto& mag : tc.magazines) {
+            mag.blocks.reserve(m_magazine_size);
+        }
+    }
+}
+
+ThreadCacheArena::~ThreadCacheArena ()
+{
+    for (auto& tc : m_caches) {
+        for (auto& mag : tc.magazines) {
+            flush(tc, mag, mag.blocks.size());
+        }
+    }
+}
+
+ThreadCacheArena::ThreadCache*
+ThreadCacheArena::threadCache () noexcept
+{
+#ifdef AMREX_USE_OMP
+    // Only threads of the outermost parallel region have a cache of their
+    // own.  Threads not created by OpenMP are never in a parallel region.
+    if (omp_in_parallel() && omp_get_level() == 1) {
+        int tid = omp_get_thread_num();
+        if (tid < static_cast<int>(m_caches.size())) {
+            return &m_caches[tid];
+        }
+    }
+#endif
+    return nullptr;
+}
+
+void*
+ThreadCacheArena::alloc (std::size_t nbytes)
+{
+    nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
+
+    ThreadCache* tc = threadCache();
+    if (tc) {
+        for (auto& mag : tc->magazines) {
+            if (mag.nbytes == nbytes && !mag.blocks.empty()) {
+                char* p = static_cast<char*>(mag.blocks.back());
+                mag.blocks.pop_back();
+                mag.last_used = ++tc->tick;
+                tc->cached_bytes -= nbytes;
+                ++tc->hits;
+                return p + header_size;
+            }
+        }
+        ++tc->misses;
+    }
+
+    char* p = static_cast<char*>(m_parent->alloc(nbytes + header_size));
+    *reinterpret_cast<std::size_t*>(p) = nbytes;
+    return p + header_size;
+}
+
+void
+ThreadCacheArena::free (void* vp)
+{
+    if (vp == nullptr) { return; }
+
+    char* p = static_cast<char*>(vp) - header_size;
+    const std::size_t nbytes = *reinterpret_cast<std::size_t*>(p);
+
+    ThreadCache* tc = threadCache();
+    if (tc == nullptr || nbytes > m_max_cached_bytes) {
+        m_parent->free(p);
+        return;
+    }
+
+    Magazine* target = nullptr;
+    for (auto& mag : tc->magazines) {
+        if (mag.nbytes == nbytes) {
+            target = &mag;
+            break;
+        }
+    }
+
+    if (target == nullptr) {
+        //
+        // Take over an empty magazine, or else the least recently used one.
+        //
+        for (auto& mag : tc->magazines) {
+            if (mag.blocks.empty()) {
+                target = &mag;
+                break;
+            } else if (target == nullptr || mag.last_used < target->last_used) {
+                target = &mag;
+            }
+        }
+        flush(*tc, *target, target->blocks.size());
+        target->nbytes = nbytes;
+    }
+
+    if (static_cast<int>(target->blocks.size()) >= m_magazine_size) {
+        flush(*tc, *target, target->blocks.size()/2 + 1);
+    }
+
+    while (tc->cached_bytes + nbytes > m_max_cached_bytes) {
+        //
+        // Make room by returning the least recently used magazine.
+        //
+        Magazine* victim = nullptr;
+        for (auto& mag : tc->magazines) {
+            if (!mag.blocks.empty() && (victim == nullptr || mag.last_used < victim->last_used)) {
+                victim = &mag;
+            }
+        }
+        if (victim == nullptr) { break; }
+        flush(*tc, *victim, victim->blocks.size());
+    }
+
+    target->blocks.push_back(p);
+    target->last_used = ++tc->tick;
+    tc->cached_bytes += nbytes;
+}
+
+void
+ThreadCacheArena::flush (ThreadCache& tc, Magazine& mag, std::size_t n)
+{
+    n = std::min(n, mag.blocks.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        m_parent->free(mag.blocks[i]);
+    }
+    mag.blocks.erase(mag.blocks.begin(), mag.blocks.begin()+n);
+    tc.cached_bytes -= n*mag.nbytes;
+    tc.returned += n;
+}
+
+std::size_t
+ThreadCacheArena::freeUnused ()
+{
+    BL_ASSERT(!OpenMP::in_parallel());
+    for (auto& tc : m_caches) {
+        for (auto& mag : tc.magazines) {
+            flush(tc, mag, mag.blocks.size());
+        }
+    }
+    return m_parent->freeUnused();
+}
+
+bool
+ThreadCacheArena::hasFreeDeviceMemory (std::size_t sz)
+{
+    return m_parent->hasFreeDeviceMemory(sz);
+}
+
+std::size_t
+ThreadCacheArena::cached_bytes () const noexcept
+{
+    std::size_t r = 0;
+    for (auto const& tc : m_caches) {
+        r += tc.cached_bytes;
+    }
+    return r;
+}
+
+void
+ThreadCacheArena::PrintUsage (std::string const& name) const
+{
+    Long hits = 0, misses = 0, returned = 0;
+    for (auto const& tc : m_caches) {
+        hits += tc.hits;
+        misses += tc.misses;
+        returned += tc.returned;
+    }
+    Long cached_megabytes = cached_bytes() / (1024*1024);
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+    ParallelReduce::Sum<Long>({hits, misses, returned}, IOProc, ParallelDescriptor::Communicator());
+    ParallelReduce::Max<Long>(cached_megabytes, IOProc, ParallelDescriptor::Communicator());
+    amrex::Print() << "[" << name << "] thread cache: " << hits << " hits, "
+                   << misses << " misses, " << returned << " blocks returned, "
+                   << cached_megabytes << " MB max cached\n";
+}
+
+void
+ThreadCacheArena::PrintUsage (std::ostream& os, std::string const& name, std::string const& space) const
+{
+    Long hits = 0, misses = 0, returned = 0;
+    for (auto const& tc : m_caches) {
+        hits += tc.hits;
+        misses += tc.misses;
+        returned += tc.returned;
+    }
+    os << space << "[" << name << "] thread cache: " << hits << " hits, "
+       << misses << " misses, " << returned << " blocks returned, "
+       << cached_bytes()/(1024*1024) << " MB cached\n";
+}
+
+}
@@ -607,6 +607,18 @@ TinyProfiler::StopRegion (const std::string& regname) noexcept
     }
 }
 
+void
+TinyProfiler::AddTime (const std::string& fname, Long n, double dt) noexcept
+{
+    for (auto const& region : regionstack)
+    {
+        Stats& st = statsmap[region][fname];
+        st.n += n;
+        st.dtin += dt;
+        st.dtex += dt;
+    }
+}
+
 TinyProfileRegion::TinyProfileRegion (std::string a_regname) noexcept
     : regname(std::move(a_regname)),
       tprof(std::string("REG::")+regname, false, false)
@@ -4,9 +4,12 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
 #include <AMReX_VisMF.H>
+#include <AMReX_VisMFCompress.H>
 
+#include <array>
 #include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 
 namespace amrex {
@@ -19,6 +22,7 @@ std::map<std::string, VisMF::PersistentIFStream> VisMF::persistentIFStreams;
 
 int VisMF::verbose(0);
 VisMF::Header::Version VisMF::currentVersion(VisMF::Header::Version_v1);
+Real VisMF::compressionTolerance(1.e-6);
 bool VisMF::groupSets(false);
 bool VisMF::setBuf(true);
 bool VisMF::useSingleRead(false);
@@ -28,6 +32,9 @@ bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
 bool VisMF::allowSparseWrites(true);
+bool VisMF::aggregateWrites(false);
+int VisMF::nAggregatorsPerNode(1);
+Long VisMF::aggregatorBufferSize(16*1024*1024);
 
 Long VisMFBuffer::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -40,6 +47,97 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+#ifdef BL_USE_MPI
+    //
+    // The processes writing through the same aggregator, which is rank 0 of
+    // the group, and the number of the file it writes.
+    //
+    struct AggregatorGroup
+    {
+        int naggregators = -1;
+        MPI_Comm comm = MPI_COMM_NULL;
+        int fileNumber = -1;
+    };
+
+    AggregatorGroup aggregatorGroup;
+
+    void FreeAggregatorGroup ()
+    {
+        if(aggregatorGroup.comm != MPI_COMM_NULL) {
+            MPI_Comm_free(&aggregatorGroup.comm);
+        }
+        aggregatorGroup = AggregatorGroup{};
+    }
+
+    const AggregatorGroup& GetAggregatorGroup (int naggregators)
+    {
+        if(aggregatorGroup.naggregators == naggregators) {
+            return aggregatorGroup;
+        }
+        FreeAggregatorGroup();
+
+        MPI_Comm comm = ParallelDescriptor::Communicator();
+        const int myProc(ParallelDescriptor::MyProc(comm));
+
+        // ---- split the processes of each node into contiguous groups
+        MPI_Comm nodeComm;
+        BL_MPI_REQUIRE( MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, myProc,
+                                            MPI_INFO_NULL, &nodeComm) );
+        int nodeRank, nodeSize;
+        MPI_Comm_rank(nodeComm, &nodeRank);
+        MPI_Comm_size(nodeComm, &nodeSize);
+        const int ngroups(std::min(naggregators, nodeSize));
+        const int igroup(static_cast<int>((Long(nodeRank) * ngroups) / nodeSize));
+        BL_MPI_REQUIRE( MPI_Comm_split(nodeComm, igroup, nodeRank, &aggregatorGroup.comm) );
+        MPI_Comm_free(&nodeComm);
+
+        // ---- number the files by the ranks of the aggregators
+        int groupRank;
+        MPI_Comm_rank(aggregatorGroup.comm, &groupRank);
+        MPI_Comm aggregatorComm;
+        BL_MPI_REQUIRE( MPI_Comm_split(comm, (groupRank == 0) ? 0 : MPI_UNDEFINED, myProc,
+                                       &aggregatorComm) );
+        if(groupRank == 0) {
+            MPI_Comm_rank(aggregatorComm, &aggregatorGroup.fileNumber);
+            MPI_Comm_free(&aggregatorComm);
+        }
+        BL_MPI_REQUIRE( MPI_Bcast(&aggregatorGroup.fileNumber, 1, MPI_INT, 0,
+                                  aggregatorGroup.comm) );
+
+        aggregatorGroup.naggregators = naggregators;
+        return aggregatorGroup;
+    }
+#endif
+
+    //
+    // Copies the bytes of a list of memory segments in order.
+    //
+    struct SegmentCursor
+    {
+        explicit SegmentCursor (const Vector<std::pair<const char*, Long> > &segs)
+            : segments(segs) {}
+
+        void copy (char *dst, Long n)
+        {
+            while(n > 0) {
+                const auto &seg = segments[iseg];
+                const Long m(std::min(n, seg.second - pos));
+                std::memcpy(dst, seg.first + pos, m);
+                dst += m;
+                n   -= m;
+                pos += m;
+                if(pos == seg.second) {
+                    ++iseg;
+                    pos = 0;
+                }
+            }
+        }
+
+        const Vector<std::pair<const char*, Long> > &segments;
+        int iseg = 0;
+        Long pos = 0;
+    };
 }
 
 void
@@ -65,6 +163,7 @@ VisMF::Initialize ()
     if(headerVersion != currentVersion) {
       currentVersion = static_cast<VisMF::Header::Version> (headerVersion);
     }
+    pp.queryAdd("compression_tolerance", compressionTolerance);
 
     pp.queryAdd("groupsets", groupSets);
     pp.queryAdd("setbuf", setBuf);
@@ -76,6 +175,11 @@ VisMF::Initialize ()
     pp.queryAdd("usedynamicsetselection", useDynamicSetSelection);
     pp.queryAdd("iobuffersize", ioBufferSize);
     pp.queryAdd("allowsparsewrites", allowSparseWrites);
+    pp.queryAdd("aggregatewrites", aggregateWrites);
+    pp.queryAdd("naggregatorspernode", nAggregatorsPerNode);
+    pp.queryAdd("aggregatorbuffersize", aggregatorBufferSize);
+    SetNAggregatorsPerNode(nAggregatorsPerNode);
+    SetAggregatorBufferSize(aggregatorBufferSize);
 
     initialized = true;
 }
@@ -83,9 +187,28 @@ VisMF::Initialize ()
 void
 VisMF::Finalize ()
 {
+#ifdef BL_USE_MPI
+    FreeAggregatorGroup();
+#endif
     initialized = false;
 }
 
+void
+VisMF::SetNAggregatorsPerNode (int naggregators)
+{
+    nAggregatorsPerNode = std::max(1, naggregators);
+}
+
+void
+VisMF::SetAggregatorBufferSize (Long nbytes)
+{
+    // ---- whole pages, and the blocks must fit in an int for MPI
+    const Long pageSize(4096);
+    const Long maxSize((std::numeric_limits<int>::max() / pageSize) * pageSize);
+    aggregatorBufferSize = std::min(maxSize, std::max(pageSize,
+                                    ((nbytes + pageSize - 1) / pageSize) * pageSize));
+}
+
 void
 VisMF::SetNOutFiles (int noutfiles, MPI_Comm comm)
 {
@@ -248,6 +371,71 @@ operator>> (std::istream&         is,
     return is;
 }
 
+static
+std::ostream&
+operator<< (std::ostream&               os,
+            const Vector< Vector<Long> >& ar)
+{
+    Long i(0), N(ar.size()), M = (N == 0) ? 0 : ar[0].size();
+
+    os << N << ',' << M << '\n';
+
+    for( ; i < N; ++i) {
+        BL_ASSERT(ar[i].size() == M);
+
+        for(Long j(0); j < M; ++j) {
+            os << ar[i][j] << ',';
+        }
+        os << '\n';
+    }
+
+    if( ! os.good()) {
+        amrex::Error("Write of Vector<Vector<Long>> failed");
+    }
+
+    return os;
+}
+
+static
+std::istream&
+operator>> (std::istream&         is,
+            Vector< Vector<Long> >& ar)
+{
+    char ch;
+    Long i(0), N, M;
+
+    is >> N >> ch >> M;
+
+    if( N < 0 ) {
+      amrex::Error("Expected a positive integer, N, got something else");
+    }
+    if( M < 0 ) {
+      amrex::Error("Expected a positive integer, M, got something else");
+    }
+    if( ch != ',' ) {
+      amrex::Error("Expected a ',' got something else");
+    }
+
+    ar.resize(N);
+
+    for( ; i < N; ++i) {
+        ar[i].resize(M);
+
+        for(Long j = 0; j < M; ++j) {
+            is >> ar[i][j] >> ch;
+            if( ch != ',' ) {
+              amrex::Error("Expected a ',' got something else");
+            }
+        }
+    }
+
+    if( ! is.good()) {
+        amrex::Error("Read of Vector<Vector<Long>> failed");
+    }
+
+    return is;
+}
+
 std::ostream&
 operator<< (std::ostream        &os,
             const VisMF::Header &hd)
@@ -273,13 +461,19 @@ operator<< (std::ostream        &os,
 
     os << hd.m_fod      << '\n';
 
-    if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(hd.m_vers == VisMF::Header::Version_v1           ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       VisMF::IsCompressed(hd))
     {
       os << hd.m_min      << '\n';
       os << hd.m_max      << '\n';
     }
 
+    if(VisMF::IsCompressed(hd)) {
+      BL_ASSERT(hd.m_ba.size() == hd.m_csize.size());
+      os << hd.m_csize    << '\n';
+    }
+
     if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
       BL_ASSERT(hd.m_famin.size() == hd.m_ncomp);
       BL_ASSERT(hd.m_famin.size() == hd.m_famax.size());
@@ -306,6 +500,11 @@ operator<< (std::ostream        &os,
       }
     }
 
+    if(VisMF::IsCompressed(hd)) {
+      // ---- the codecs work on the native format
+      os << FPC::NativeRealDescriptor() << '\n';
+    }
+
     os.flags(oflags);
     os.precision(oldPrec);
 
@@ -357,8 +556,9 @@ operator>> (std::istream  &is,
     is >> hd.m_fod;
     BL_ASSERT(hd.m_ba.size() == hd.m_fod.size());
 
-    if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(hd.m_vers == VisMF::Header::Version_v1           ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       VisMF::IsCompressed(hd))
     {
       is >> hd.m_min;
       is >> hd.m_max;
@@ -366,6 +566,11 @@ operator>> (std::istream  &is,
       BL_ASSERT(hd.m_ba.size() == hd.m_max.size());
     }
 
+    if(VisMF::IsCompressed(hd)) {
+      is >> hd.m_csize;
+      BL_ASSERT(hd.m_ba.size() == hd.m_csize.size());
+    }
+
     if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
       char ch;
       hd.m_famin.resize(hd.m_ncomp);
@@ -385,7 +590,8 @@ operator>> (std::istream  &is,
     }
     if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       VisMF::IsCompressed(hd))
     {
       is >> hd.m_writtenRD;
     }
@@ -551,6 +757,155 @@ VisMF::readFAB (int idx,
     return VisMF::readFAB(idx, m_fafabname, m_hdr, ncomp);
 }
 
+namespace
+{
+    //
+    // Read the rows of region in components [srccomp, srccomp+dest.nComp())
+    // of the fab on fabbox, whose data start at dataStart, into dest.  Rows
+    // that are close to each other in the file are read together.
+    //
+    void readRegionRows (std::istream &is, Long dataStart, const Box &fabbox,
+                         const RealDescriptor &rd, int srccomp,
+                         const Box &region, FArrayBox &dest)
+    {
+        const bool doConvert( ! (rd == FPC::NativeRealDescriptor()));
+        const Long itemBytes(rd.numBytes());
+        const Long rowItems(region.length(0));
+        const Long rowBytes(rowItems * itemBytes);
+        // ---- reading a small gap is cheaper than seeking over it
+        const Long maxGap(64 * 1024);
+        const Long maxRead(std::max(VisMFBuffer::GetIOBufferSize(), rowBytes));
+
+        const auto flo  = amrex::lbound(fabbox);
+        const auto flen = amrex::length(fabbox);
+        const auto rlo  = amrex::lbound(region);
+        const auto rhi  = amrex::ubound(region);
+        const auto &a   = dest.array();
+
+        Long runStart(0), runEnd(0);
+        Vector<std::pair<Long, Real*> > rows;    // ---- [offset in the run, destination]
+        Vector<char> buffer;
+        auto readRun = [&] ()
+        {
+            if(rows.empty()) {
+                return;
+            }
+            buffer.resize(runEnd - runStart);
+            is.seekg(runStart, std::ios::beg);
+            is.read(buffer.data(), buffer.size());
+            if( ! is.good()) {
+                amrex::Error("VisMF::readFAB:  read of region failed");
+            }
+            for(const auto &row : rows) {
+                if(doConvert) {
+                    RealDescriptor::convertToNativeFormat(row.second, rowItems,
+                                                          buffer.data() + row.first, rd);
+                } else {
+                    std::memcpy(row.second, buffer.data() + row.first, rowBytes);
+                }
+            }
+            rows.clear();
+        };
+
+        for(int n(0); n < dest.nComp(); ++n) {
+            for(int k(rlo.z); k <= rhi.z; ++k) {
+                for(int j(rlo.y); j <= rhi.y; ++j) {
+                    const Long cell = (rlo.x - flo.x)
+                        + flen.x * ((j - flo.y) + Long(flen.y) * ((k - flo.z)
+                        + Long(flen.z) * (srccomp + n)));
+                    const Long offset = dataStart + cell * itemBytes;
+                    if(offset - runEnd > maxGap || offset + rowBytes - runStart > maxRead) {
+                        readRun();
+                    }
+                    if(rows.empty()) {
+                        runStart = offset;
+                    }
+                    rows.emplace_back(offset - runStart, a.ptr(rlo.x, j, k, n));
+                    runEnd = offset + rowBytes;
+                }
+            }
+        }
+        readRun();
+    }
+}
+
+void
+VisMF::readFAB (FArrayBox &fab, const Box &region, int idx, int icomp)
+{
+//    BL_PROFILE("VisMF::readFAB_region");
+    const int ncomp(fab.nComp());
+    Box fab_box(m_hdr.m_ba[idx]);
+    if(m_hdr.m_ngrow.max() > 0) {
+        fab_box.grow(m_hdr.m_ngrow);
+    }
+    BL_ASSERT(fab.box().contains(region) && fab_box.contains(region));
+    BL_ASSERT(icomp >= 0 && icomp + ncomp <= m_hdr.m_ncomp);
+
+    FArrayBox *hfab = &fab;
+#ifdef AMREX_USE_GPU
+    std::unique_ptr<FArrayBox> hostfab;
+    if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+        hostfab = std::make_unique<FArrayBox>(region, ncomp, The_Pinned_Arena());
+        hfab = hostfab.get();
+    }
+#endif
+
+    std::string FullName(VisMF::DirName(m_fafabname));
+    FullName += m_hdr.m_fod[idx].m_name;
+
+    // ---- unbuffered, so only the requested bytes are read
+    std::ifstream ifs;
+    ifs.rdbuf()->pubsetbuf(nullptr, 0);
+    ifs.open(FullName.c_str(), std::ios::in | std::ios::binary);
+    if( ! ifs.good()) {
+        amrex::FileOpenFailed(FullName);
+    }
+    ifs.seekg(m_hdr.m_fod[idx].m_head, std::ios::beg);
+
+    if(IsCompressed(m_hdr)) {
+        FArrayBox compfab(fab_box, 1, The_Pinned_Arena());
+        for(int n(0); n < ncomp; ++n) {
+            ifs.seekg(m_hdr.m_fod[idx].m_head, std::ios::beg);
+            readCompressedFAB(ifs, compfab, m_hdr.m_csize[idx], icomp + n);
+            hfab->copy<RunOn::Host>(compfab, region, 0, region, n, 1);
+        }
+    } else if(NoFabHeader(m_hdr)) {
+        readRegionRows(ifs, m_hdr.m_fod[idx].m_head, fab_box, m_hdr.m_writtenRD,
+                       icomp, region, *hfab);
+    } else {
+        // ---- parse the fab header to find the format and the start of the data
+        const Long maxHeaderBytes(4096);
+        std::string fabHeader(maxHeaderBytes, '\0');
+        ifs.read(&fabHeader[0], maxHeaderBytes);
+        fabHeader.resize(ifs.gcount());
+        ifs.clear();
+        std::istringstream hss(fabHeader);
+        Box bx;
+        int nvar;
+        std::unique_ptr<FABio> fio(FABio::read_header(hss, bx, nvar));
+        BL_ASSERT(bx == fab_box && nvar == m_hdr.m_ncomp);
+        const auto *bio = dynamic_cast<const FABio_binary*>(fio.get());
+        if(bio != nullptr) {
+            const Long dataStart(m_hdr.m_fod[idx].m_head + static_cast<std::streamoff>(hss.tellg()));
+            readRegionRows(ifs, dataStart, bx, bio->realDescriptor(), icomp, region, *hfab);
+        } else {
+            FArrayBox compfab(The_Pinned_Arena());
+            for(int n(0); n < ncomp; ++n) {
+                ifs.seekg(m_hdr.m_fod[idx].m_head, std::ios::beg);
+                compfab.readFrom(ifs, icomp + n);
+                hfab->copy<RunOn::Host>(compfab, region, 0, region, n, 1);
+            }
+        }
+    }
+
+#ifdef AMREX_USE_GPU
+    if (hostfab) {
+        fab.copy<RunOn::Device>(*hostfab, region, 0, region, 0, ncomp);
+        Gpu::streamSynchronize();
+    }
+#endif
+}
+
 std::string
 VisMF::BaseName (const std::string& filename)
 {
@@ -857,6 +1212,156 @@ VisMF::Header::CalculateMinMax (const FabArray<FArrayBox>& mf,
     }
 }
 
+Vector<Real>
+VisMF::CompressionSteps (const FabArray<FArrayBox> &mf,
+                         VisMF::Header::Version whichVersion,
+                         MPI_Comm comm)
+{
+    const int ncomp(mf.nComp());
+    Vector<Real> steps(ncomp, 0.0);
+
+    if(whichVersion != VisMF::Header::CompressedLossy_v1 || compressionTolerance <= 0.0) {
+        return steps;
+    }
+
+    // ---- the error bound is relative to the range of the valid data
+    bool run_on_device = Gpu::inLaunchRegion()
+        && (mf.arena()->isManaged() || mf.arena()->isDevice());
+
+    Vector<Real> famin(ncomp,  std::numeric_limits<Real>::max());
+    Vector<Real> famax(ncomp, -std::numeric_limits<Real>::max());
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        for(int i(0); i < ncomp; ++i) {
+            auto mm = (run_on_device) ? mf[mfi].minmax<RunOn::Device>(mfi.validbox(),i)
+                                      : mf[mfi].minmax<RunOn::Host  >(mfi.validbox(),i);
+            famin[i] = std::min(famin[i], mm.first);
+            famax[i] = std::max(famax[i], mm.second);
+        }
+    }
+    ParallelAllReduce::Min(famin.dataPtr(), ncomp, comm);
+    ParallelAllReduce::Max(famax.dataPtr(), ncomp, comm);
+
+    for(int i(0); i < ncomp; ++i) {
+        const Real range = famax[i] - famin[i];
+        if(range > 0.0 && range < std::numeric_limits<Real>::max()) {
+            steps[i] = 2.0_rt * compressionTolerance * range;
+        }
+    }
+    return steps;
+}
+
+
+Vector<char>
+VisMF::CompressFab (const FArrayBox &fab, const Box &bx,
+                    const Vector<Real> &steps, Vector<Long> &csize)
+{
+    BL_PROFILE("VisMF::CompressFab");
+    BL_ASSERT(fab.box().contains(bx));
+
+    const int ncomp(fab.nComp());
+    const FArrayBox *hfab = &fab;
+    std::unique_ptr<FArrayBox> hostfab;
+    bool data_on_device = fab.arena()->isManaged() || fab.arena()->isDevice();
+    if(data_on_device || bx != fab.box()) {
+        // ---- the codecs need contiguous data on the host
+#ifdef AMREX_USE_GPU
+        if(data_on_device) {
+            hostfab = std::make_unique<FArrayBox>(bx, ncomp, The_Pinned_Arena());
+            hostfab->copy<RunOn::Device>(fab, bx);
+            Gpu::streamSynchronize();
+        } else
+#endif
+        {
+            hostfab = std::make_unique<FArrayBox>(bx, ncomp, The_Cpu_Arena());
+            hostfab->copy<RunOn::Host>(fab, bx);
+        }
+        hfab = hostfab.get();
+    }
+
+    Vector<char> buf;
+    csize.resize(ncomp);
+    for(int n(0); n < ncomp; ++n) {
+        csize[n] = VisMFCompress::Compress(hfab->dataPtr(n), bx, steps[n], buf);
+    }
+    return buf;
+}
+
+
+void
+VisMF::GatherCompressedSizes (const FabArray<FArrayBox> &mf,
+                              VisMF::Header &hdr,
+                              int procToWrite, MPI_Comm comm)
+{
+    amrex::ignore_unused(mf,hdr,procToWrite,comm);
+
+#ifdef BL_USE_MPI
+    const int ncomp(hdr.m_ncomp);
+    const int myProc(ParallelDescriptor::MyProc(comm));
+    Vector<int> nmtags(ParallelDescriptor::NProcs(comm), 0);
+    Vector<int> offset(ParallelDescriptor::NProcs(comm), 0);
+
+    const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
+
+    for(int i(0), N = mf.size(); i < N; ++i) {
+        nmtags[pmap[i]] += ncomp;
+    }
+
+    for(int i(1), N(offset.size()); i < N; ++i) {
+        offset[i] = offset[i-1] + nmtags[i-1];
+    }
+
+    Vector<Long> senddata(nmtags[myProc]);
+
+    if(senddata.empty()) {
+        //
+        // Can't let senddata be empty as senddata.dataPtr() will fail.
+        //
+        senddata.resize(1);
+    }
+
+    int ioffset = 0;
+
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        for(int i(0); i < ncomp; ++i) {
+            senddata[ioffset++] = hdr.m_csize[mfi.index()][i];
+        }
+    }
+
+    BL_ASSERT(ioffset == nmtags[myProc]);
+
+    Vector<Long> recvdata(mf.size()*ncomp);
+
+    BL_COMM_PROFILE(BLProfiler::Gatherv, recvdata.size() * sizeof(Long),
+                    myProc, BLProfiler::BeforeCall());
+
+    BL_MPI_REQUIRE( MPI_Gatherv(senddata.dataPtr(),
+                                nmtags[myProc],
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                recvdata.dataPtr(),
+                                nmtags.dataPtr(),
+                                offset.dataPtr(),
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                procToWrite,
+                                comm) );
+
+    BL_COMM_PROFILE(BLProfiler::Gatherv, recvdata.size() * sizeof(Long),
+                    myProc, BLProfiler::AfterCall());
+
+    if(myProc == procToWrite) {
+        for(int j(0), N(mf.size()); j < N; ++j) {
+            if(pmap[j] != procToWrite) {
+                hdr.m_csize[j].resize(ncomp);
+                for(int k(0); k < ncomp; ++k) {
+                    hdr.m_csize[j][k] = recvdata[offset[pmap[j]]+k];
+                }
+                offset[pmap[j]] += ncomp;
+            }
+        }
+    }
+#endif /*BL_USE_MPI*/
+}
+
+
 Long
 VisMF::WriteHeaderDoit (const std::string&mf_name, const VisMF::Header& hdr)
 {
@@ -974,16 +1479,59 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     std::string filePrefix(mf_name + FabFileSuffix);
 
-    NFilesIter nfi(nOutFiles, filePrefix, groupSets, setBuf);
-
     bool oldHeader(currentVersion == VisMF::Header::Version_v1);
 
+    // ---- compress before writing, so the files are not kept open while compressing
+    bool compressed(IsCompressed(hdr));
+    Vector<Vector<char> > compressedFabs;    // ---- [local index]
+    if(compressed) {
+        const Vector<Real> steps = CompressionSteps(mf, currentVersion);
+        hdr.m_csize.resize(mf.size());
+        for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            compressedFabs.push_back(CompressFab(mf[mfi], mf[mfi].box(), steps,
+                                                 hdr.m_csize[mfi.index()]));
+        }
+    }
+
+#ifdef BL_USE_MPI
+    if(aggregateWrites && FArrayBox::getFormat() != FABio::FAB_ASCII
+                       && FArrayBox::getFormat() != FABio::FAB_8BIT)
+    {
+        bytesWritten += WriteAggregated(mf, filePrefix, hdr, compressedFabs, coordinatorProc);
+
+        if(currentVersion == VisMF::Header::Version_v1           ||
+           currentVersion == VisMF::Header::NoFabHeaderMinMax_v1 ||
+           compressed)
+        {
+            hdr.CalculateMinMax(mf, coordinatorProc);
+        }
+
+        if(compressed) {
+            GatherCompressedSizes(mf, hdr, coordinatorProc);
+        }
+
+        bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
+
+        return bytesWritten;
+    }
+#endif
+
+    NFilesIter nfi(nOutFiles, filePrefix, groupSets, setBuf);
+
     if(useSparseFPP) {
         nfi.SetSparseFPP(procsWithDataVector);
     } else if(useDynamicSetSelection) {
         nfi.SetDynamic();
     }
     for( ; nfi.ReadyToWrite(); ++nfi) {
+        if(compressed) {
+            for(const auto &cfab : compressedFabs) {
+                nfi.Stream().write(cfab.data(), cfab.size());
+                bytesWritten += cfab.size();
+            }
+            nfi.Stream().flush();
+            continue;
+        }
         // ---- find the total number of bytes including fab headers if needed
         const FABio &fio = FArrayBox::getFABio();
         int whichRDBytes(whichRD->numBytes()), nFABs(0);
@@ -1095,12 +1643,17 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         coordinatorProc = nfi.CoordinatorProc();
     }
 
-    if(currentVersion == VisMF::Header::Version_v1 ||
-       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(currentVersion == VisMF::Header::Version_v1           ||
+       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       compressed)
     {
         hdr.CalculateMinMax(mf, coordinatorProc);
     }
 
+    if(compressed) {
+        GatherCompressedSizes(mf, hdr, coordinatorProc);
+    }
+
     VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
                        ParallelDescriptor::Communicator());
 
@@ -1110,6 +1663,217 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 }
 
 
+Long
+VisMF::WriteAggregated (const FabArray<FArrayBox> &mf,
+                        const std::string &filePrefix,
+                        VisMF::Header &hdr,
+                        const Vector<Vector<char> > &compressedFabs,
+                        int procToWrite)
+{
+    BL_PROFILE("VisMF::WriteAggregated()");
+
+    Long bytesWritten(0);
+
+#ifdef BL_USE_MPI
+    MPI_Comm comm = ParallelDescriptor::Communicator();
+    const AggregatorGroup &group = GetAggregatorGroup(nAggregatorsPerNode);
+    int groupRank, groupSize;
+    MPI_Comm_rank(group.comm, &groupRank);
+    MPI_Comm_size(group.comm, &groupSize);
+    const int aggregator(0);
+    const int tag(0);    // ---- the messages of a process are received in order
+    const Long blockSize(aggregatorBufferSize);
+
+    auto whichRD = FArrayBox::getDataDescriptor();
+    const bool doConvert(*whichRD != FPC::NativeRealDescriptor());
+    const bool oldHeader(hdr.m_vers == VisMF::Header::Version_v1);
+    const FABio &fio = FArrayBox::getFABio();
+
+    // ---- the bytes of this process are the local fabs in order, as in the NFiles files
+    const int nLocal(mf.local_size());
+    Vector<std::string> fabHeaders(nLocal);
+    Vector<Vector<char> > convertedData(nLocal);
+    Vector<std::unique_ptr<FArrayBox> > hostFabs(nLocal);
+    Vector<std::pair<const char*, Long> > segments;
+    Vector<Long> fabPosition(nLocal);
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const int li(mfi.LocalIndex());
+        fabPosition[li] = bytesWritten;
+        if(IsCompressed(hdr)) {
+            segments.emplace_back(compressedFabs[li].data(), compressedFabs[li].size());
+            bytesWritten += compressedFabs[li].size();
+            continue;
+        }
+        const FArrayBox &fab = mf[mfi];
+        if(oldHeader) {
+            std::stringstream hss;
+            fio.write_header(hss, fab, fab.nComp());
+            fabHeaders[li] = hss.str();
+            segments.emplace_back(fabHeaders[li].data(), fabHeaders[li].size());
+            bytesWritten += fabHeaders[li].size();
+        }
+        Real const* fabdata = fab.dataPtr();
+#ifdef AMREX_USE_GPU
+        if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+            hostFabs[li] = std::make_unique<FArrayBox>(fab.box(), fab.nComp(),
+                                                       The_Pinned_Arena());
+            Gpu::dtoh_memcpy_async(hostFabs[li]->dataPtr(), fab.dataPtr(),
+                                   fab.size()*sizeof(Real));
+            Gpu::streamSynchronize();
+            fabdata = hostFabs[li]->dataPtr();
+        }
+#endif
+        const Long nItems(fab.box().numPts() * mf.nComp());
+        const Long dataSize(nItems * whichRD->numBytes());
+        if(doConvert) {
+            convertedData[li].resize(dataSize);
+            RealDescriptor::convertFromNativeFormat(static_cast<void *> (convertedData[li].data()),
+                                                    nItems, fabdata, *whichRD);
+            segments.emplace_back(convertedData[li].data(), dataSize);
+        } else {
+            segments.emplace_back(reinterpret_cast<const char*>(fabdata), dataSize);
+        }
+        bytesWritten += dataSize;
+    }
+
+    // ---- the processes of a group are written in order into the aggregator's file
+    Long groupOffset(0);
+    BL_MPI_REQUIRE( MPI_Exscan(&bytesWritten, &groupOffset, 1,
+                               ParallelDescriptor::Mpi_typemap<Long>::type(),
+                               MPI_SUM, group.comm) );
+    if(groupRank == aggregator) {
+        groupOffset = 0;
+    }
+    Vector<Long> groupBytes((groupRank == aggregator) ? groupSize : 1);
+    BL_MPI_REQUIRE( MPI_Gather(&bytesWritten, 1, ParallelDescriptor::Mpi_typemap<Long>::type(),
+                               groupBytes.dataPtr(), 1, ParallelDescriptor::Mpi_typemap<Long>::type(),
+                               aggregator, group.comm) );
+
+    //
+    // The file is written in blocks of blockSize bytes.  The other processes
+    // send their bytes split at the block boundaries, so that the aggregator
+    // can receive the next block while it writes the current one.
+    //
+    SegmentCursor cursor(segments);
+
+    if(groupRank != aggregator) {
+        std::array<Vector<char>, 2> sendBuffers;
+        std::array<MPI_Request, 2> reqs{MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+        int ib(0);
+        for(Long pos(0); pos < bytesWritten; ) {
+            const Long fileOffset(groupOffset + pos);
+            const Long n(std::min(bytesWritten - pos, blockSize - fileOffset % blockSize));
+            BL_MPI_REQUIRE( MPI_Wait(&reqs[ib], MPI_STATUS_IGNORE) );
+            sendBuffers[ib].resize(std::max(static_cast<Long>(sendBuffers[ib].size()), n));
+            cursor.copy(sendBuffers[ib].data(), n);
+            BL_MPI_REQUIRE( MPI_Isend(sendBuffers[ib].data(), static_cast<int>(n), MPI_CHAR,
+                                      aggregator, tag, group.comm, &reqs[ib]) );
+            pos += n;
+            ib = 1 - ib;
+        }
+        BL_MPI_REQUIRE( MPI_Waitall(2, reqs.data(), MPI_STATUSES_IGNORE) );
+    } else {
+        Vector<Long> groupOffsets(groupSize+1, 0);
+        std::partial_sum(groupBytes.begin(), groupBytes.end(), groupOffsets.begin()+1);
+        const Long totalBytes(groupOffsets[groupSize]);
+
+        if(totalBytes > 0) {
+            const Long nBlocks((totalBytes + blockSize - 1) / blockSize);
+            std::array<Vector<char>, 2> blocks;
+            std::array<Vector<MPI_Request>, 2> reqs;
+
+            auto postBlock = [&] (Long iblock)
+            {
+                const Long lo(iblock * blockSize);
+                const Long hi(std::min(totalBytes, lo + blockSize));
+                Vector<char> &block = blocks[iblock%2];
+                block.resize(hi - lo);
+                reqs[iblock%2].clear();
+                for(int r(0); r < groupSize; ++r) {
+                    const Long b(std::max(lo, groupOffsets[r]));
+                    const Long e(std::min(hi, groupOffsets[r+1]));
+                    if(b < e) {
+                        if(r == aggregator) {
+                            cursor.copy(block.data() + (b - lo), e - b);
+                        } else {
+                            reqs[iblock%2].push_back(MPI_REQUEST_NULL);
+                            BL_MPI_REQUIRE( MPI_Irecv(block.data() + (b - lo), static_cast<int>(e - b),
+                                                      MPI_CHAR, r, tag, group.comm,
+                                                      &reqs[iblock%2].back()) );
+                        }
+                    }
+                }
+            };
+
+            const std::string fileName(NFilesIter::FileName(group.fileNumber, filePrefix));
+            std::ofstream ofs;
+            ofs.rdbuf()->pubsetbuf(nullptr, 0);    // ---- the blocks are written directly
+            ofs.open(fileName.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+            if( ! ofs.good()) {
+                amrex::FileOpenFailed(fileName);
+            }
+
+            postBlock(0);
+            for(Long iblock(0); iblock < nBlocks; ++iblock) {
+                if(iblock + 1 < nBlocks) {
+                    postBlock(iblock + 1);
+                }
+                Vector<MPI_Request> &blockReqs = reqs[iblock%2];
+                BL_MPI_REQUIRE( MPI_Waitall(static_cast<int>(blockReqs.size()), blockReqs.dataPtr(),
+                                            MPI_STATUSES_IGNORE) );
+                const Vector<char> &block = blocks[iblock%2];
+                ofs.write(block.data(), block.size());
+                if( ! ofs.good()) {
+                    amrex::Error("VisMF::WriteAggregated: failed writing " + fileName);
+                }
+            }
+            ofs.close();
+        }
+    }
+
+    // ---- gather the file numbers and offsets of the fabs
+    const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
+    const int nProcs(ParallelDescriptor::NProcs(comm));
+    const int myProc(ParallelDescriptor::MyProc(comm));
+    Vector<int> nmtags(nProcs,0);
+    Vector<int> offset(nProcs,0);
+    for(int i(0), N(mf.size()); i < N; ++i) {
+        nmtags[pmap[i]] += 2;
+    }
+    for(int i(1); i < nProcs; ++i) {
+        offset[i] = offset[i-1] + nmtags[i-1];
+    }
+
+    Vector<Long> senddata(std::max(1, nmtags[myProc]));
+    for(int li(0); li < nLocal; ++li) {
+        senddata[2*li]   = group.fileNumber;
+        senddata[2*li+1] = groupOffset + fabPosition[li];
+    }
+    Vector<Long> recvdata((myProc == procToWrite) ? 2*mf.size() : 1);
+    BL_MPI_REQUIRE( MPI_Gatherv(senddata.dataPtr(), nmtags[myProc],
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                recvdata.dataPtr(), nmtags.dataPtr(), offset.dataPtr(),
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                procToWrite, comm) );
+
+    if(myProc == procToWrite) {
+        Vector<int> cnt(nProcs,0);
+        for(int j(0), N(mf.size()); j < N; ++j) {
+            const int i(pmap[j]);
+            const Long *fod = recvdata.dataPtr() + offset[i] + cnt[i];
+            hdr.m_fod[j].m_name = VisMF::BaseName(NFilesIter::FileName(static_cast<int>(fod[0]),
+                                                                       filePrefix));
+            hdr.m_fod[j].m_head = fod[1];
+            cnt[i] += 2;
+        }
+    }
+#else
+    amrex::ignore_unused(mf, filePrefix, hdr, compressedFabs, procToWrite);
+#endif
+
+    return bytesWritten;
+}
+
 Long
 VisMF::WriteOnlyHeader (const FabArray<FArrayBox> & mf,
                         const std::string         & mf_name,
@@ -1160,8 +1924,8 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
       coordinatorProc = nfi.CoordinatorProc();
     }
 
-    if(FArrayBox::getFormat() == FABio::FAB_ASCII ||
-       FArrayBox::getFormat() == FABio::FAB_8BIT)
+    if((FArrayBox::getFormat() == FABio::FAB_ASCII ||
+        FArrayBox::getFormat() == FABio::FAB_8BIT) && ! IsCompressed(hdr))
     {
 
 #ifdef BL_USE_MPI
@@ -1291,8 +2055,14 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
               for(int i(0); i < index.size(); ++i) {
                  hdr.m_fod[index[i]].m_name = whichFileName;
                  hdr.m_fod[index[i]].m_head = currentOffset[whichFileNumber];
-                 currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
-                                                   + fabHeaderBytes[index[i]];
+                 if(IsCompressed(hdr)) {
+                   for(Long csize : hdr.m_csize[index[i]]) {
+                     currentOffset[whichFileNumber] += csize;
+                   }
+                 } else {
+                   currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
+                                                     + fabHeaderBytes[index[i]];
+                 }
               }
             }
           }
@@ -1386,7 +2156,9 @@ VisMF::readFAB (int                  idx,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(hdr.m_vers == Header::Version_v1) {
+    if(IsCompressed(hdr)) {
+      readCompressedFAB(*infs, *fab, hdr.m_csize[idx], whichComp);
+    } else if(hdr.m_vers == Header::Version_v1) {
       if(whichComp == -1) {    // ---- read all components
         fab->readFrom(*infs);
       } else {
@@ -1450,7 +2222,9 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(NoFabHeader(hdr)) {
+    if(IsCompressed(hdr)) {
+      readCompressedFAB(*infs, fab, hdr.m_csize[idx], -1);
+    } else if(NoFabHeader(hdr)) {
       Real* fabdata = fab.dataPtr();
 #ifdef AMREX_USE_GPU
       std::unique_ptr<FArrayBox> hostfab;
@@ -1480,6 +2254,58 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
 }
 
 
+void
+VisMF::readCompressedFAB (std::istream &is, FArrayBox &fab,
+                          const Vector<Long> &csize, int whichComp)
+{
+    const Box &bx = fab.box();
+    const Long npts(bx.numPts());
+    int comp0(0), ncomp(fab.nComp());
+    if(whichComp >= 0) {
+      BL_ASSERT(fab.nComp() == 1);
+      comp0 = whichComp;
+    }
+    BL_ASSERT(comp0 + ncomp <= csize.size());
+
+    // ---- the components are stored one after another
+    Long skipBytes(0), readBytes(0);
+    for(int n(0); n < comp0; ++n) {
+      skipBytes += csize[n];
+    }
+    for(int n(comp0); n < comp0 + ncomp; ++n) {
+      readBytes += csize[n];
+    }
+    if(skipBytes > 0) {
+      is.seekg(skipBytes, std::ios::cur);
+    }
+    Vector<char> cdata(readBytes);
+    is.read(cdata.data(), readBytes);
+    if( ! is.good()) {
+      amrex::Error("VisMF::readCompressedFAB:  read failed");
+    }
+
+    Real* fabdata = fab.dataPtr();
+#ifdef AMREX_USE_GPU
+    std::unique_ptr<FArrayBox> hostfab;
+    if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+        hostfab = std::make_unique<FArrayBox>(fab.box(), fab.nComp(), The_Pinned_Arena());
+        fabdata = hostfab->dataPtr();
+    }
+#endif
+    const char *pdata = cdata.data();
+    for(int n(0); n < ncomp; ++n) {
+      VisMFCompress::Decompress(pdata, csize[comp0+n], bx, fabdata + n*npts);
+      pdata += csize[comp0+n];
+    }
+#ifdef AMREX_USE_GPU
+    if (hostfab) {
+        Gpu::htod_memcpy_async(fab.dataPtr(), hostfab->dataPtr(), fab.size()*sizeof(Real));
+        Gpu::streamSynchronize();
+    }
+#endif
+}
+
+
 void
 VisMF::Read (FabArray<FArrayBox> &mf,
              const std::string   &mf_name,
@@ -2129,6 +2955,11 @@ bool VisMF::NoFabHeader(const VisMF::Header &hdr) {
   return false;
 }
 
+bool VisMF::IsCompressed(const VisMF::Header &hdr) {
+  return (hdr.m_vers == VisMF::Header::Compressed_v1 ||
+          hdr.m_vers == VisMF::Header::CompressedLossy_v1);
+}
+
 
 VisMF::PersistentIFStream::PersistentIFStream()
     :
@@ -2254,7 +3085,12 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
 
     RealDescriptor const& whichRD = FPC::NativeRealDescriptor();
 
-    auto hdr = std::make_shared<VisMF::Header>(mf, VisMF::NFiles, VisMF::Header::Version_v1, false);
+    // The compressed versions are supported, otherwise the fabs are written with headers.
+    const bool compressed = currentVersion == VisMF::Header::Compressed_v1
+        ||                  currentVersion == VisMF::Header::CompressedLossy_v1;
+    const VisMF::Header::Version version = compressed ? currentVersion : VisMF::Header::Version_v1;
+
+    auto hdr = std::make_shared<VisMF::Header>(mf, VisMF::NFiles, version, false);
     if (valid_cells_only) hdr->m_ngrow = IntVect(0);
 
     constexpr int sizeof_int64_over_real = sizeof(int64_t) / sizeof(Real);
@@ -2262,7 +3098,7 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
     const int n_global_fabs = mf.size();
     const int ncomp = mf.nComp();
     const Long n_fab_reals = 2*ncomp;
-    const Long n_fab_int64 = 1;
+    const Long n_fab_int64 = compressed ? 1+ncomp : 1;
     const Long n_fab_nums = (n_fab_reals/sizeof_int64_over_real) + n_fab_int64;
     const Long n_local_nums = n_fab_nums * n_local_fabs + 1;
     Vector<int64_t> localdata(n_local_nums);
@@ -2272,6 +3108,21 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
 
     bool strip_ghost = valid_cells_only && mf.nGrowVect() != 0;
 
+    // The staged copies count against the budget until they have been written.
+    Long staged_bytes = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        staged_bytes += ((strip_ghost) ? mfi.validbox() : mfi.fabbox()).numPts()
+            * ncomp * static_cast<Long>(sizeof(Real));
+    }
+    AsyncOut::ReserveStaging(staged_bytes);
+
+    // The data are compressed now, so that only the file I/O is left for later.
+    auto cfabs = std::make_shared<Vector<Vector<char> > >();
+    Vector<Real> steps;
+    if (compressed) {
+        steps = CompressionSteps(mf, version);
+    }
+
     int64_t total_bytes = 0;
     if (localdata.size() > 1) {
         char* pld = (char*)(&(localdata[1]));
@@ -2284,12 +3135,18 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
             const FArrayBox& fab = mf[mfi];
             const Box& bx = mfi.validbox();
 
-            std::stringstream hss;
-            FArrayBox valid_fab(bx, ncomp, false);
-            FArrayBox const& header_fab = (strip_ghost) ? valid_fab : fab;
-            fio.write_header(hss, header_fab, ncomp);
-            total_bytes += static_cast<std::streamoff>(hss.tellp());
-            total_bytes += header_fab.size() * whichRD.numBytes();
+            Vector<Long> csize;
+            if (compressed) {
+                cfabs->push_back(CompressFab(fab, (strip_ghost) ? bx : fab.box(), steps, csize));
+                total_bytes += cfabs->back().size();
+            } else {
+                std::stringstream hss;
+                FArrayBox valid_fab(bx, ncomp, false);
+                FArrayBox const& header_fab = (strip_ghost) ? valid_fab : fab;
+                fio.write_header(hss, header_fab, ncomp);
+                total_bytes += static_cast<std::streamoff>(hss.tellp());
+                total_bytes += header_fab.size() * whichRD.numBytes();
+            }
 
             // compute min and max
             for (int icomp = 0; icomp < ncomp; ++icomp) {
@@ -2300,6 +3157,12 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
                 std::memcpy(pld, &(mm.second), sizeof(Real));
                 pld += sizeof(Real);
             }
+
+            for (int icomp = 0; icomp < static_cast<int>(csize.size()); ++icomp) {
+                int64_t nbytes = csize[icomp];
+                std::memcpy(pld, &nbytes, sizeof(int64_t));
+                pld += sizeof(int64_t);
+            }
         }
     }
     localdata[0] = total_bytes;
@@ -2333,11 +3196,11 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
 #endif
 
     auto myfabs = std::make_shared<Vector<FArrayBox> >();
-    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+    for (MFIter mfi(mf); mfi.isValid() && ! compressed; ++mfi) {
         Box bx = strip_ghost ? mfi.validbox() : mfi.fabbox();
 #ifdef AMREX_USE_GPU
         if (data_on_device) {
-            myfabs->emplace_back(bx, mf.nComp(), The_Pinned_Arena());
+            myfabs->emplace_back(bx, mf.nComp(), AsyncOut::StagingArena());
             auto& new_fab = myfabs->back();
             if (strip_ghost) {
                 new_fab.copy<RunOn::Device>(mf[mfi], bx);
@@ -2350,7 +3213,7 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
             if (is_rvalue && ! strip_ghost) {
                 myfabs->emplace_back(std::move(const_cast<FArrayBox&>(mf[mfi])));
             } else {
-                myfabs->emplace_back(bx, mf.nComp(), The_Cpu_Arena());
+                myfabs->emplace_back(bx, mf.nComp(), AsyncOut::StagingArena());
                 auto& new_fab = myfabs->back();
                 new_fab.copy<RunOn::Host>(mf[mfi], bx);
             }
@@ -2359,7 +3222,7 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
 
     std::shared_ptr<FABio> fabio(new FABio_binary(FPC::NativeRealDescriptor().clone()));
 
-    AsyncOut::Submit([=] ()
+    AsyncOut::SubmitConcurrent([=] ()
     {
         if (myproc == io_proc)
         {
@@ -2370,6 +3233,9 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
             hdr->m_famax.clear();
             hdr->m_famin.resize(ncomp,std::numeric_limits<Real>::max());
             hdr->m_famax.resize(ncomp,std::numeric_limits<Real>::lowest());
+            if (compressed) {
+                hdr->m_csize.resize(n_global_fabs);
+            }
 
             Vector<int64_t> nbytes_on_rank(nprocs,-1L);
             Vector<Vector<int> > gidx(nprocs);
@@ -2417,6 +3283,16 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
                         hdr->m_famax[icomp] = std::max(hdr->m_famax[icomp],cmax);
                     }
 
+                    if (compressed) {
+                        hdr->m_csize[k].resize(ncomp);
+                        for (int icomp = 0; icomp < ncomp; ++icomp) {
+                            int64_t csize;
+                            std::memcpy(&csize, pgd, sizeof(int64_t));
+                            pgd += sizeof(int64_t);
+                            hdr->m_csize[k][icomp] = csize;
+                        }
+                    }
+
                     auto info = AsyncOut::GetWriteInfo(rank);
                     hdr->m_fod[k].m_name = amrex::Concatenate(VisMF::BaseName(mf_name)+FabFileSuffix,
                                                               info.ifile, 5);
@@ -2446,7 +3322,7 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
         AsyncOut::Wait();  // Wait for my turn
 
         auto info = AsyncOut::GetWriteInfo(myproc);
-        if (! myfabs->empty()) {
+        if (! myfabs->empty() || ! cfabs->empty()) {
             std::string file_name = amrex::Concatenate(mf_name + FabFileSuffix, info.ifile, 5);
             std::ofstream ofs;
             ofs.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
@@ -2457,11 +3333,19 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
                 fabio->write_header(ofs, fab, fab.nComp());
                 fabio->write(ofs, fab, 0, fab.nComp());
             }
+            for (auto const& cfab : *cfabs) {
+                ofs.write(cfab.data(), cfab.size());
+            }
             ofs.flush();
             ofs.close();
         }
 
         AsyncOut::Notify();  // Notify others I am done
+
+        AsyncOut::AddBytesWritten(total_bytes);
+        myfabs->clear();
+        cfabs->clear();
+        AsyncOut::ReleaseStaging(staged_bytes);
     });
 }
 
@@ -0,0 +1,240 @@
+
+#include <AMReX_VisMFCompress.H>
+#include <AMReX.H>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace amrex {
+namespace VisMFCompress {
+
+namespace {
+
+enum Mode : char { Raw = 0, XorBytes = 1, Quantized = 2 };
+
+using Bits = std::conditional_t<sizeof(Real) == 8, std::uint64_t, std::uint32_t>;
+constexpr int nbytes_real = static_cast<int>(sizeof(Real));
+
+Bits to_bits (Real x) noexcept
+{
+    Bits b;
+    std::memcpy(&b, &x, sizeof(Real));
+    return b;
+}
+
+Real from_bits (Bits b) noexcept
+{
+    Real x;
+    std::memcpy(&x, &b, sizeof(Real));
+    return x;
+}
+
+void put_varint (std::uint64_t v, Vector<char>& buf)
+{
+    while (v >= 0x80) {
+        buf.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    buf.push_back(static_cast<char>(v));
+}
+
+std::uint64_t get_varint (unsigned char const*& p, unsigned char const* end)
+{
+    std::uint64_t v = 0;
+    int shift = 0;
+    while (true) {
+        if (p == end || shift > 63) {
+            amrex::Error("VisMFCompress::Decompress: corrupted chunk");
+        }
+        const unsigned char c = *p++;
+        v |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+        if ((c & 0x80) == 0) { break; }
+        shift += 7;
+    }
+    return v;
+}
+
+std::uint64_t zigzag (std::int64_t d) noexcept
+{
+    return (static_cast<std::uint64_t>(d) << 1) ^ static_cast<std::uint64_t>(d >> 63);
+}
+
+std::int64_t unzigzag (std::uint64_t u) noexcept
+{
+    return static_cast<std::int64_t>(u >> 1) ^ -static_cast<std::int64_t>(u & 1);
+}
+
+// Lorenzo predictor of q(i,j,k) from the already visited neighbors
+std::int64_t predict (Vector<std::int64_t> const& q, Dim3 const& len,
+                      int i, int j, int k) noexcept
+{
+    auto Q = [&] (int ii, int jj, int kk) -> std::int64_t {
+        return (ii < 0 || jj < 0 || kk < 0) ? 0 : q[ii + len.x*(jj + Long(len.y)*kk)];
+    };
+    return Q(i-1,j,k) + Q(i,j-1,k) + Q(i,j,k-1)
+        -  Q(i-1,j-1,k) - Q(i-1,j,k-1) - Q(i,j-1,k-1)
+        +  Q(i-1,j-1,k-1);
+}
+
+void compress_xor (Real const* src, Long npts, Vector<char>& buf)
+{
+    Bits prev = 0;
+    for (Long n = 0; n < npts; ++n) {
+        const Bits b = to_bits(src[n]);
+        const Bits x = b ^ prev;
+        prev = b;
+        int lz = 0, tz = 0;
+        if (x == 0) {
+            lz = nbytes_real;
+        } else {
+            while (((x >> (8*(nbytes_real-1-lz))) & 0xff) == 0) { ++lz; }
+            while (((x >> (8*tz)) & 0xff) == 0) { ++tz; }
+        }
+        buf.push_back(static_cast<char>((lz << 4) | tz));
+        for (int m = tz; m < nbytes_real-lz; ++m) {
+            buf.push_back(static_cast<char>((x >> (8*m)) & 0xff));
+        }
+    }
+}
+
+void decompress_xor (unsigned char const* p, unsigned char const* end, Long npts, Real* dst)
+{
+    Bits prev = 0;
+    for (Long n = 0; n < npts; ++n) {
+        if (p == end) {
+            amrex::Error("VisMFCompress::Decompress: corrupted chunk");
+        }
+        const int lz = *p >> 4;
+        const int tz = *p & 0xf;
+        ++p;
+        if (lz+tz > nbytes_real || end-p < nbytes_real-lz-tz) {
+            amrex::Error("VisMFCompress::Decompress: corrupted chunk");
+        }
+        Bits x = 0;
+        for (int m = tz; m < nbytes_real-lz; ++m) {
+            x |= static_cast<Bits>(*p++) << (8*m);
+        }
+        prev ^= x;
+        dst[n] = from_bits(prev);
+    }
+}
+
+// Returns false if the error of some value would be more than step/2.
+bool compress_quantized (Real const* src, Box const& box, Real step, Vector<char>& buf)
+{
+    const Dim3 len = amrex::length(box);
+    const Long npts = box.numPts();
+    // Quantized values must be exactly representable as Real.
+    const Real qmax = (sizeof(Real) == 8) ? Real(4.e15) : Real(8.e6);
+    const Real half = Real(0.5)*step;
+    Vector<std::int64_t> q(npts);
+    for (Long n = 0; n < npts; ++n) {
+        const Real r = src[n] / step;
+        if (!(std::abs(r) < qmax)) { return false; } // also catches NaN
+        std::int64_t iq = std::llround(r);
+        // The division may have rounded r to the wrong side of a half step.
+        if (std::abs(Real(iq)*step - src[n]) > half) {
+            if        (std::abs(Real(iq-1)*step - src[n]) <= half) {
+                --iq;
+            } else if (std::abs(Real(iq+1)*step - src[n]) <= half) {
+                ++iq;
+            } else {
+                return false;
+            }
+        }
+        q[n] = iq;
+    }
+
+    for (int k = 0; k < len.z; ++k) {
+    for (int j = 0; j < len.y; ++j) {
+    for (int i = 0; i < len.x; ++i) {
+        const Long n = i + len.x*(j + Long(len.y)*k);
+        put_varint(zigzag(q[n] - predict(q, len, i, j, k)), buf);
+    }}}
+    return true;
+}
+
+void decompress_quantized (unsigned char const* p, unsigned char const* end, Box const& box,
+                           Real step, Real* dst)
+{
+    const Dim3 len = amrex::length(box);
+    Vector<std::int64_t> q(box.numPts());
+    for (int k = 0; k < len.z; ++k) {
+    for (int j = 0; j < len.y; ++j) {
+    for (int i = 0; i < len.x; ++i) {
+        const Long n = i + len.x*(j + Long(len.y)*k);
+        q[n] = predict(q, len, i, j, k) + unzigzag(get_varint(p, end));
+        dst[n] = Real(q[n])*step;
+    }}}
+}
+
+}
+
+Long
+Compress (Real const* src, Box const& box, Real step, Vector<char>& buf)
+{
+    const Long n0 = buf.size();
+    const Long npts = box.numPts();
+    const Long rawbytes = npts*nbytes_real;
+    buf.reserve(n0 + 1 + sizeof(double) + rawbytes + npts);
+
+    if (step > Real(0.0)) {
+        buf.push_back(Quantized);
+        const double dstep = step;
+        const char* ps = reinterpret_cast<const char*>(&dstep);
+        buf.insert(buf.end(), ps, ps+sizeof(double));
+        if (compress_quantized(src, box, step, buf)) {
+            return buf.size() - n0;
+        }
+        buf.resize(n0);
+    }
+
+    buf.push_back(XorBytes);
+    compress_xor(src, npts, buf);
+
+    if (static_cast<Long>(buf.size()) - n0 > 1 + rawbytes) {
+        // Incompressible, store as is
+        buf.resize(n0);
+        buf.push_back(Raw);
+        const char* ps = reinterpret_cast<const char*>(src);
+        buf.insert(buf.end(), ps, ps+rawbytes);
+    }
+
+    return buf.size() - n0;
+}
+
+void
+Decompress (char const* src, Long nbytes, Box const& box, Real* dst)
+{
+    if (nbytes < 1) {
+        amrex::Error("VisMFCompress::Decompress: corrupted chunk");
+    }
+    auto p = reinterpret_cast<unsigned char const*>(src);
+    auto end = p + nbytes;
+    const char mode = static_cast<char>(*p++);
+    const Long npts = box.numPts();
+
+    if (mode == Raw) {
+        if (end-p != npts*nbytes_real) {
+            amrex::Error("VisMFCompress::Decompress: corrupted chunk");
+        }
+        std::memcpy(dst, p, npts*nbytes_real);
+    } else if (mode == XorBytes) {
+        decompress_xor(p, end, npts, dst);
+    } else if (mode == Quantized) {
+        if (end-p < static_cast<Long>(sizeof(double))) {
+            amrex::Error("VisMFCompress::Decompress: corrupted chunk");
+        }
+        double dstep;
+        std::memcpy(&dstep, p, sizeof(double));
+        p += sizeof(double);
+        decompress_quantized(p, end, box, static_cast<Real>(dstep), dst);
+    } else {
+        amrex::Error("VisMFCompress::Decompress: unknown mode");
+    }
+}
+
+}
+}
@@ -103,6 +103,26 @@ Parser::maxStackSize () const
     }
 }
 
+int
+Parser::numRegisters () const
+{
+    if (m_data && m_data->m_parser) {
+        return m_data->m_num_registers;
+    } else {
+        return 0;
+    }
+}
+
+void
+Parser::setRegisterBytecode (bool flag)
+{
+    if (m_data) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_data->m_host_executor == nullptr,
+                                         "Parser::setRegisterBytecode must be called before compile");
+        m_data->m_register_bytecode = flag;
+    }
+}
+
 std::string
 Parser::expr () const
 {
@@ -0,0 +1,727 @@
+#include <AMReX_Parser_RegExe.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace amrex {
+
+namespace {
+
+// pow(x,n) with an integer n and |n| <= this is computed by multiplications.
+constexpr int parser_reg_max_powi = 16;
+
+// A value is either a compile time constant or a virtual register.
+struct RegValue
+{
+    bool is_const = false;
+    double v = 0.0;
+    int r = -1;
+};
+
+// An instruction operating on virtual registers.  The operands not used by
+// an instruction are -1.
+struct RegCode
+{
+    parser_reg_t op = PARSER_REG_END;
+    int d = -1;
+    int a = -1;
+    int b = -1;
+    double v = 0.0;
+    int f = 0;
+    std::size_t target = 0; // For IF and JUMP, the instruction to go to
+};
+
+class RegLowering
+{
+public:
+
+    explicit RegLowering (int nvars) : m_nvars(nvars), m_nvregs(nvars), m_neg_of(nvars,-1) {}
+
+    RegValue lower (struct parser_node* node);
+
+    Vector<char> finalize (RegValue const& result);
+
+private:
+
+    using Key = std::tuple<int,int,int,int,std::uint64_t>;
+
+    static RegValue constant (double v) { return RegValue{true, v, -1}; }
+    static RegValue reg (int r) { return RegValue{false, 0.0, r}; }
+
+    int emit (parser_reg_t op, int a, int b, double v = 0.0, int f = 0);
+    int new_vreg ();
+    bool is_neg (RegValue const& x, int& src) const;
+    int materialize (RegValue const& x);
+    void move (int d, RegValue const& x);
+    void leave_scope (std::size_t ntable, std::size_t nlocals);
+
+    RegValue symbol (struct parser_symbol* sym);
+    RegValue binary (parser_node_t type, RegValue const& a, RegValue const& b);
+    RegValue neg (RegValue const& a);
+    RegValue f1 (parser_f1_t ftype, RegValue const& a);
+    RegValue f2 (parser_f2_t ftype, RegValue const& a, RegValue const& b);
+    RegValue powi (RegValue const& a, int n);
+    RegValue ifelse (struct parser_f3* node);
+
+    int m_nvars;
+    int m_nvregs;
+    std::vector<RegCode> m_code;
+    // If virtual register i holds -r[j], m_neg_of[i] is j.  Otherwise, it's -1.
+    std::vector<int> m_neg_of;
+    // For common subexpression elimination.  The keys are also logged so
+    // that the values computed in a branch of if can be forgotten.
+    std::map<Key,int> m_table;
+    std::vector<Key> m_table_log;
+    std::vector<std::pair<std::string,RegValue>> m_locals;
+};
+
+int
+RegLowering::emit (parser_reg_t op, int a, int b, double v, int f)
+{
+    if ((op == PARSER_REG_ADD || op == PARSER_REG_MUL) && b < a) {
+        std::swap(a,b);
+    }
+    std::uint64_t vbits;
+    std::memcpy(&vbits, &v, sizeof(double));
+    Key key{op, a, b, f, vbits};
+    auto it = m_table.find(key);
+    if (it != m_table.end()) {
+        return it->second;
+    }
+
+    RegCode c;
+    c.op = op;
+    c.d = new_vreg();
+    if (op == PARSER_REG_NEG) { m_neg_of[c.d] = a; }
+    c.a = a;
+    c.b = b;
+    c.v = v;
+    c.f = f;
+    m_code.push_back(c);
+    m_table.emplace(key, c.d);
+    m_table_log.push_back(key);
+    return c.d;
+}
+
+int
+RegLowering::new_vreg ()
+{
+    m_neg_of.push_back(-1);
+    return m_nvregs++;
+}
+
+bool
+RegLowering::is_neg (RegValue const& x, int& src) const
+{
+    if (x.is_const || m_neg_of[x.r] < 0) {
+        return false;
+    } else {
+        src = m_neg_of[x.r];
+        return true;
+    }
+}
+
+int
+RegLowering::materialize (RegValue const& x)
+{
+    return x.is_const ? emit(PARSER_REG_LDC, -1, -1, x.v) : x.r;
+}
+
+void
+RegLowering::move (int d, RegValue const& x)
+{
+    RegCode c;
+    c.d = d;
+    if (x.is_const) {
+        c.op = PARSER_REG_LDC;
+        c.v = x.v;
+    } else {
+        c.op = PARSER_REG_MOV;
+        c.a = x.r;
+    }
+    m_code.push_back(c);
+}
+
+void
+RegLowering::leave_scope (std::size_t ntable, std::size_t nlocals)
+{
+    while (m_table_log.size() > ntable) {
+        m_table.erase(m_table_log.back());
+        m_table_log.pop_back();
+    }
+    m_locals.resize(nlocals);
+}
+
+RegValue
+RegLowering::symbol (struct parser_symbol* sym)
+{
+    for (auto it = m_locals.rbegin(); it != m_locals.rend(); ++it) {
+        if (it->first == sym->name) {
+            return it->second;
+        }
+    }
+    if (sym->ip < 0 || sym->ip >= m_nvars) {
+        throw std::runtime_error(std::string("Unknown variable ") + sym->name);
+    }
+    return reg(sym->ip);
+}
+
+RegValue
+RegLowering::binary (parser_node_t type, RegValue const& a, RegValue const& b)
+{
+    // Negations are folded into the constants, which is exact.
+    int src;
+    switch (type)
+    {
+    case PARSER_ADD:
+        if (a.is_const && b.is_const) { return constant(a.v + b.v); }
+        if (a.is_const) { return binary(PARSER_ADD, b, a); }
+        if (b.is_const) {
+            if (is_neg(a, src)) { return reg(emit(PARSER_REG_SUB_C, src, -1, b.v)); }
+            return reg(emit(PARSER_REG_ADD_C, a.r, -1, b.v));
+        }
+        return reg(emit(PARSER_REG_ADD, a.r, b.r));
+    case PARSER_SUB:
+        if (a.is_const && b.is_const) { return constant(a.v - b.v); }
+        if (a.is_const) {
+            if (is_neg(b, src)) { return reg(emit(PARSER_REG_ADD_C, src, -1, a.v)); }
+            return reg(emit(PARSER_REG_SUB_C, b.r, -1, a.v));
+        }
+        if (b.is_const) { return binary(PARSER_ADD, a, constant(-b.v)); }
+        return reg(emit(PARSER_REG_SUB, a.r, b.r));
+    case PARSER_MUL:
+        if (a.is_const && b.is_const) { return constant(a.v * b.v); }
+        if (a.is_const) { return binary(PARSER_MUL, b, a); }
+        if (b.is_const) {
+            if (is_neg(a, src)) { return reg(emit(PARSER_REG_MUL_C, src, -1, -b.v)); }
+            return reg(emit(PARSER_REG_MUL_C, a.r, -1, b.v));
+        }
+        return reg(emit(PARSER_REG_MUL, a.r, b.r));
+    case PARSER_DIV:
+        if (a.is_const && b.is_const) { return constant(a.v / b.v); }
+        if (a.is_const) {
+            if (is_neg(b, src)) { return reg(emit(PARSER_REG_DIV_C, src, -1, -a.v)); }
+            return reg(emit(PARSER_REG_DIV_C, b.r, -1, a.v));
+        }
+        // Same as the stack executor, x/c is computed as x*(1/c).
+        if (b.is_const) { return binary(PARSER_MUL, a, constant(1.0/b.v)); }
+        return reg(emit(PARSER_REG_DIV, a.r, b.r));
+    default:
+        amrex::Abort("parser_reg_compile: unknown binary operation " + std::to_string(type));
+        return RegValue{};
+    }
+}
+
+RegValue
+RegLowering::neg (RegValue const& a)
+{
+    int src;
+    if (a.is_const) {
+        return constant(-a.v);
+    } else if (is_neg(a, src)) {
+        return reg(src);
+    } else {
+        return reg(emit(PARSER_REG_NEG, a.r, -1));
+    }
+}
+
+RegValue
+RegLowering::powi (RegValue const& a, int n)
+{
+    if (n == 0) { return constant(1.0); }
+    int m = std::abs(n);
+    RegValue result;
+    bool has_result = false;
+    RegValue base = a;
+    while (true) {
+        if (m & 1) {
+            result = has_result ? binary(PARSER_MUL, result, base) : base;
+            has_result = true;
+        }
+        m >>= 1;
+        if (m == 0) { break; }
+        base = binary(PARSER_MUL, base, base);
+    }
+    if (n < 0) {
+        result = binary(PARSER_DIV, constant(1.0), result);
+    }
+    return result;
+}
+
+RegValue
+RegLowering::f1 (parser_f1_t ftype, RegValue const& a)
+{
+    switch (ftype)
+    {
+    case PARSER_POW_M3: return powi(a,-3);
+    case PARSER_POW_M2: return powi(a,-2);
+    case PARSER_POW_M1: return powi(a,-1);
+    case PARSER_POW_P1: return a;
+    case PARSER_POW_P2: return powi(a,2);
+    case PARSER_POW_P3: return powi(a,3);
+    default:
+        if (a.is_const) {
+            return constant(parser_call_f1(ftype, a.v));
+        } else {
+            return reg(emit(PARSER_REG_F1, a.r, -1, 0.0, ftype));
+        }
+    }
+}
+
+RegValue
+RegLowering::f2 (parser_f2_t ftype, RegValue const& a, RegValue const& b)
+{
+    if (a.is_const && b.is_const) {
+        return constant(parser_call_f2(ftype, a.v, b.v));
+    } else if (ftype == PARSER_POW && b.is_const && std::floor(b.v) == b.v
+               && std::abs(b.v) <= parser_reg_max_powi) {
+        return powi(a, static_cast<int>(b.v));
+    } else {
+        int ra = materialize(a);
+        int rb = materialize(b);
+        return reg(emit(PARSER_REG_F2, ra, rb, 0.0, ftype));
+    }
+}
+
+RegValue
+RegLowering::ifelse (struct parser_f3* node)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(node->ftype == PARSER_IF,
+                                     "parser_reg_compile: unknown f3 type");
+    RegValue cond = lower(node->n1);
+    if (cond.is_const) {
+        return (cond.v != 0.0) ? lower(node->n2) : lower(node->n3);
+    }
+
+    // Both branches write their results to this register.  Values computed
+    // in a branch are only visible in that branch.
+    int result = new_vreg();
+
+    std::size_t iif = m_code.size();
+    RegCode cif;
+    cif.op = PARSER_REG_IF;
+    cif.a = cond.r;
+    m_code.push_back(cif);
+
+    std::size_t ntable = m_table_log.size();
+    std::size_t nlocals = m_locals.size();
+    move(result, lower(node->n2));
+    leave_scope(ntable, nlocals);
+
+    std::size_t ijump = m_code.size();
+    RegCode cjump;
+    cjump.op = PARSER_REG_JUMP;
+    m_code.push_back(cjump);
+
+    m_code[iif].target = m_code.size();
+    move(result, lower(node->n3));
+    leave_scope(ntable, nlocals);
+
+    m_code[ijump].target = m_code.size();
+
+    return reg(result);
+}
+
+RegValue
+RegLowering::lower (struct parser_node* node)
+{
+    switch (node->type)
+    {
+    case PARSER_NUMBER:
+        return constant(((struct parser_number*)node)->value);
+    case PARSER_SYMBOL:
+        return symbol((struct parser_symbol*)node);
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+    {
+        RegValue a = lower(node->l);
+        RegValue b = lower(node->r);
+        return binary(node->type, a, b);
+    }
+    case PARSER_ADD_PP:
+    case PARSER_SUB_PP:
+    case PARSER_MUL_PP:
+    case PARSER_DIV_PP:
+    {
+        // For *_PP, the symbols are stored in the l and r nodes.
+        RegValue a = lower(node->l);
+        RegValue b = lower(node->r);
+        parser_node_t type = (node->type == PARSER_ADD_PP) ? PARSER_ADD
+            :                (node->type == PARSER_SUB_PP) ? PARSER_SUB
+            :                (node->type == PARSER_MUL_PP) ? PARSER_MUL : PARSER_DIV;
+        return binary(type, a, b);
+    }
+    case PARSER_ADD_VP:
+    case PARSER_SUB_VP:
+    case PARSER_MUL_VP:
+    case PARSER_DIV_VP:
+    {
+        // For *_VP, the value is in lvp.v and the symbol is in the r node.
+        RegValue b = lower(node->r);
+        parser_node_t type = (node->type == PARSER_ADD_VP) ? PARSER_ADD
+            :                (node->type == PARSER_SUB_VP) ? PARSER_SUB
+            :                (node->type == PARSER_MUL_VP) ? PARSER_MUL : PARSER_DIV;
+        return binary(type, constant(node->lvp.v), b);
+    }
+    case PARSER_NEG:
+    case PARSER_NEG_P:
+        return neg(lower(node->l));
+    case PARSER_F1:
+        return f1(((struct parser_f1*)node)->ftype, lower(((struct parser_f1*)node)->l));
+    case PARSER_F2:
+    {
+        RegValue a = lower(((struct parser_f2*)node)->l);
+        RegValue b = lower(((struct parser_f2*)node)->r);
+        return f2(((struct parser_f2*)node)->ftype, a, b);
+    }
+    case PARSER_F3:
+        return ifelse((struct parser_f3*)node);
+    case PARSER_ASSIGN:
+    {
+        auto asgn = (struct parser_assign*)node;
+        RegValue v = lower(asgn->v);
+        m_locals.emplace_back(asgn->s->name, v);
+        return v;
+    }
+    case PARSER_LIST:
+        lower(node->l);
+        return lower(node->r);
+    default:
+        amrex::Abort("parser_reg_compile: unknown node type " + std::to_string(node->type));
+        return RegValue{};
+    }
+}
+
+Vector<char>
+RegLowering::finalize (RegValue const& result)
+{
+    const int rresult = materialize(result);
+    const auto ncode = static_cast<int>(m_code.size());
+
+    // Dead code elimination.  There are no backward jumps, so one backward
+    // pass is enough.
+    std::vector<char> needed(m_nvregs, 0);
+    std::vector<char> keep(ncode, 0);
+    needed[rresult] = 1;
+    for (int i = ncode-1; i >= 0; --i) {
+        auto const& c = m_code[i];
+        if (c.op == PARSER_REG_IF || c.op == PARSER_REG_JUMP) {
+            keep[i] = 1;
+            if (c.a >= 0) { needed[c.a] = 1; }
+        } else if (needed[c.d]) {
+            keep[i] = 1;
+            if (c.a >= 0) { needed[c.a] = 1; }
+            if (c.b >= 0) { needed[c.b] = 1; }
+        }
+    }
+
+    // Register allocation.  Because the code is structured and only jumps
+    // forward, a value is live from its first definition to its last use in
+    // program order.  A register is reused after the last use of its value.
+    std::vector<int> last_use(m_nvregs, -1);
+    for (int i = 0; i < ncode; ++i) {
+        if (keep[i]) {
+            if (m_code[i].a >= 0) { last_use[m_code[i].a] = i; }
+            if (m_code[i].b >= 0) { last_use[m_code[i].b] = i; }
+        }
+    }
+    last_use[rresult] = ncode;
+
+    std::vector<int> phys(m_nvregs, -1);
+    for (int i = 0; i < m_nvars; ++i) { phys[i] = i; }
+    std::vector<int> free_regs;
+    int nregs = m_nvars;
+    for (int i = 0; i < ncode; ++i) {
+        if (!keep[i]) { continue; }
+        auto const& c = m_code[i];
+        if (c.a >= m_nvars && last_use[c.a] == i) {
+            free_regs.push_back(phys[c.a]);
+        }
+        if (c.b >= m_nvars && c.b != c.a && last_use[c.b] == i) {
+            free_regs.push_back(phys[c.b]);
+        }
+        if (c.d >= 0 && phys[c.d] < 0) {
+            if (free_regs.empty()) {
+                phys[c.d] = nregs++;
+            } else {
+                phys[c.d] = free_regs.back();
+                free_regs.pop_back();
+            }
+        }
+    }
+
+    std::vector<int> new_index(ncode+1);
+    int ninsts = 0;
+    for (int i = 0; i < ncode; ++i) {
+        new_index[i] = ninsts;
+        if (keep[i]) { ++ninsts; }
+    }
+    new_index[ncode] = ninsts;
+
+    Vector<char> bytecode(sizeof(ParserRegHeader) + (ninsts+1)*sizeof(ParserRegInst));
+
+    ParserRegHeader header;
+    header.nvars = m_nvars;
+    header.nregs = nregs;
+    header.ninsts = ninsts+1;
+    std::memcpy(bytecode.data(), &header, sizeof(ParserRegHeader));
+
+    char* p = bytecode.data() + sizeof(ParserRegHeader);
+    for (int i = 0; i < ncode; ++i) {
+        if (!keep[i]) { continue; }
+        auto const& c = m_code[i];
+        ParserRegInst inst{};
+        inst.op = c.op;
+        inst.d = (c.d >= 0) ? phys[c.d] : 0;
+        inst.a = (c.a >= 0) ? phys[c.a] : 0;
+        inst.b = (c.b >= 0) ? phys[c.b] : 0;
+        if (c.op == PARSER_REG_IF || c.op == PARSER_REG_JUMP) {
+            inst.b = new_index[c.target] - (new_index[i]+1);
+        }
+        if (c.op == PARSER_REG_F1 || c.op == PARSER_REG_F2) {
+            inst.f = c.f;
+        } else {
+            inst.v = c.v;
+        }
+        std::memcpy(p, &inst, sizeof(ParserRegInst));
+        p += sizeof(ParserRegInst);
+    }
+
+    ParserRegInst end{};
+    end.op = PARSER_REG_END;
+    end.a = phys[rresult];
+    std::memcpy(p, &end, sizeof(ParserRegInst));
+
+    return bytecode;
+}
+
+}
+
+Vector<char>
+parser_reg_compile (struct amrex_parser* parser, int nvars)
+{
+    RegLowering lowering(nvars);
+    RegValue result = lowering.lower(parser->ast);
+    return lowering.finalize(result);
+}
+
+namespace {
+
+template <typename G>
+AMREX_FORCE_INLINE void
+parser_batch_f1 (double* d, double const* a, G const& g)
+{
+    for (int l = 0; l < AMREX_PARSER_BATCH_SIZE; ++l) {
+        d[l] = g(a[l]);
+    }
+}
+
+template <typename G>
+AMREX_FORCE_INLINE void
+parser_batch_f2 (double* d, double const* a, double const* b, G const& g)
+{
+    for (int l = 0; l < AMREX_PARSER_BATCH_SIZE; ++l) {
+        d[l] = g(a[l], b[l]);
+    }
+}
+
+void
+parser_batch_call_f1 (parser_f1_t type, double* d, double const* a)
+{
+    switch (type) {
+    case PARSER_SQRT:
+        parser_batch_f1(d, a, [] (double x) { return std::sqrt(x); });
+        break;
+    case PARSER_ABS:
+        parser_batch_f1(d, a, [] (double x) { return std::abs(x); });
+        break;
+    case PARSER_FLOOR:
+        parser_batch_f1(d, a, [] (double x) { return std::floor(x); });
+        break;
+    case PARSER_CEIL:
+        parser_batch_f1(d, a, [] (double x) { return std::ceil(x); });
+        break;
+    default:
+        parser_batch_f1(d, a, [=] (double x) { return parser_call_f1(type, x); });
+    }
+}
+
+void
+parser_batch_call_f2 (parser_f2_t type, double* d, double const* a, double const* b)
+{
+    switch (type) {
+    case PARSER_GT:
+        parser_batch_f2(d, a, b, [] (double x, double y) { return (x > y) ? 1.0 : 0.0; });
+        break;
+    case PARSER_LT:
+        parser_batch_f2(d, a, b, [] (double x, double y) { return (x < y) ? 1.0 : 0.0; });
+        break;
+    case PARSER_GEQ:
+        parser_batch_f2(d, a, b, [] (double x, double y) { return (x >= y) ? 1.0 : 0.0; });
+        break;
+    case PARSER_LEQ:
+        parser_batch_f2(d, a, b, [] (double x, double y) { return (x <= y) ? 1.0 : 0.0; });
+        break;
+    case PARSER_EQ:
+        parser_batch_f2(d, a, b, [] (double x, double y) { return (x == y) ? 1.0 : 0.0; });
+        break;
+    case PARSER_NEQ:
+        parser_batch_f2(d, a, b, [] (double x, double y) { return (x != y) ? 1.0 : 0.0; });
+        break;
+    case PARSER_AND:
+        parser_batch_f2(d, a, b, [] (double x, double y)
+                        { return ((x != 0.0) && (y != 0.0)) ? 1.0 : 0.0; });
+        break;
+    case PARSER_OR:
+        parser_batch_f2(d, a, b, [] (double x, double y)
+                        { return ((x != 0.0) || (y != 0.0)) ? 1.0 : 0.0; });
+        break;
+    case PARSER_MIN:
+        parser_batch_f2(d, a, b, [] (double x, double y) { return (x < y) ? x : y; });
+        break;
+    case PARSER_MAX:
+        parser_batch_f2(d, a, b, [] (double x, double y) { return (x > y) ? x : y; });
+        break;
+    default:
+        parser_batch_f2(d, a, b, [=] (double x, double y) { return parser_call_f2(type, x, y); });
+    }
+}
+
+// Evaluate a block of AMREX_PARSER_BATCH_SIZE points.  Register i of lane l
+// is r[i*AMREX_PARSER_BATCH_SIZE+l].  The results of the first nlanes lanes
+// are stored in result.
+void
+parser_reg_run_batch (ParserRegInst const* ip, double* r, int nregs, int nlanes,
+                      double* result)
+{
+    constexpr int W = AMREX_PARSER_BATCH_SIZE;
+    while (true) {
+        double* rd = r + ip->d*W;
+        double const* ra = r + ip->a*W;
+        double const* rb = r + ip->b*W;
+        double const v = ip->v;
+        switch (ip->op)
+        {
+        case PARSER_REG_END:
+            for (int l = 0; l < nlanes; ++l) { result[l] = ra[l]; }
+            return;
+        case PARSER_REG_MOV:
+            for (int l = 0; l < W; ++l) { rd[l] = ra[l]; }
+            break;
+        case PARSER_REG_LDC:
+            for (int l = 0; l < W; ++l) { rd[l] = v; }
+            break;
+        case PARSER_REG_ADD:
+            for (int l = 0; l < W; ++l) { rd[l] = ra[l] + rb[l]; }
+            break;
+        case PARSER_REG_SUB:
+            for (int l = 0; l < W; ++l) { rd[l] = ra[l] - rb[l]; }
+            break;
+        case PARSER_REG_MUL:
+            for (int l = 0; l < W; ++l) { rd[l] = ra[l] * rb[l]; }
+            break;
+        case PARSER_REG_DIV:
+            for (int l = 0; l < W; ++l) { rd[l] = ra[l] / rb[l]; }
+            break;
+        case PARSER_REG_ADD_C:
+            for (int l = 0; l < W; ++l) { rd[l] = ra[l] + v; }
+            break;
+        case PARSER_REG_MUL_C:
+            for (int l = 0; l < W; ++l) { rd[l] = ra[l] * v; }
+            break;
+        case PARSER_REG_SUB_C:
+            for (int l = 0; l < W; ++l) { rd[l] = v - ra[l]; }
+            break;
+        case PARSER_REG_DIV_C:
+            for (int l = 0; l < W; ++l) { rd[l] = v / ra[l]; }
+            break;
+        case PARSER_REG_NEG:
+            for (int l = 0; l < W; ++l) { rd[l] = -ra[l]; }
+            break;
+        case PARSER_REG_F1:
+            parser_batch_call_f1(static_cast<parser_f1_t>(ip->f), rd, ra);
+            break;
+        case PARSER_REG_F2:
+            parser_batch_call_f2(static_cast<parser_f2_t>(ip->f), rd, ra, rb);
+            break;
+        case PARSER_REG_IF:
+        {
+            int ntrue = 0;
+            for (int l = 0; l < W; ++l) { ntrue += (ra[l] != 0.0); }
+            if (ntrue == 0) {
+                ip += ip->b;
+            } else if (ntrue != W) {
+                // The lanes take different branches.  Finish them one by one.
+                std::vector<double> rl(nregs);
+                for (int l = 0; l < nlanes; ++l) {
+                    for (int i = 0; i < nregs; ++i) {
+                        rl[i] = r[i*W+l];
+                    }
+                    result[l] = parser_reg_exec(ip, rl.data());
+                }
+                return;
+            }
+            break;
+        }
+        case PARSER_REG_JUMP:
+            ip += ip->b;
+            break;
+        default:
+            amrex::Abort("parser_reg_run_batch: unknown instruction");
+            return;
+        }
+        ++ip;
+    }
+}
+
+}
+
+void
+parser_eval_batch (char* p, int nvars, int npts, double const* const* x, double* result)
+{
+    if (*((parser_exe_t*)p) != PARSER_EXE_REGISTERS) {
+        std::vector<double> xn(nvars);
+        for (int n = 0; n < npts; ++n) {
+            for (int i = 0; i < nvars; ++i) {
+                xn[i] = x[i][n];
+            }
+            result[n] = parser_exe_eval(p, xn.data());
+        }
+        return;
+    }
+
+    auto const* header = (ParserRegHeader const*)p;
+    auto const* ip = (ParserRegInst const*)(p + sizeof(ParserRegHeader));
+    AMREX_ASSERT(header->nvars == nvars);
+
+    constexpr int W = AMREX_PARSER_BATCH_SIZE;
+    const int nregs = std::max(header->nregs, 1);
+    std::vector<double> r(nregs*W);
+    for (int begin = 0; begin < npts; begin += W) {
+        const int nlanes = std::min(W, npts-begin);
+        for (int i = 0; i < nvars; ++i) {
+            double const* xi = x[i] + begin;
+            double* ri = r.data() + i*W;
+            for (int l = 0; l < nlanes; ++l) {
+                ri[l] = xi[l];
+            }
+            // Pad the last block so that every lane holds a valid point.
+            for (int l = nlanes; l < W; ++l) {
+                ri[l] = xi[nlanes-1];
+            }
+        }
+        parser_reg_run_batch(ip, r.data(), nregs, nlanes, result+begin);
+    }
+}
+
+}
@@ -23,6 +23,7 @@ AMREX_EXPORT Vector<std::unique_ptr<IndexSpace> > IndexSpace::m_instance;
 AMREX_EXPORT int max_grid_size = 64;
 AMREX_EXPORT bool extend_domain_face = true;
 AMREX_EXPORT int num_coarsen_opt = 0;
+AMREX_EXPORT bool use_interval_bounds = true;
 
 void Initialize ()
 {
@@ -30,6 +31,7 @@ void Initialize ()
     pp.queryAdd("max_grid_size", max_grid_size);
     pp.queryAdd("extend_domain_face", extend_domain_face);
     pp.queryAdd("num_coarsen_opt", num_coarsen_opt);
+    pp.queryAdd("use_interval_bounds", use_interval_bounds);
 
     amrex::ExecOnFinalize(Finalize);
 }
@@ -216,6 +218,8 @@ Build (const Geometry& geom, int required_coarsening_level,
         pp.queryAdd("stl_center", stl_center);
         int stl_reverse_normal = 0;
         pp.queryAdd("stl_reverse_normal", stl_reverse_normal);
+        bool stl_use_bvh = true;
+        pp.queryAdd("stl_use_bvh", stl_use_bvh);
         IndexSpace::push(new IndexSpaceSTL(stl_file, stl_scale,
                                            {stl_center[0], stl_center[1], stl_center[2]},
                                            stl_reverse_normal,
@@ -223,7 +227,7 @@ Build (const Geometry& geom, int required_coarsening_level,
                                            max_coarsening_level, ngrow,
                                            build_coarse_level_by_coarsening,
                                            a_extend_domain_face,
-                                           a_num_coarsen_opt));
+                                           a_num_coarsen_opt, stl_use_bvh));
     }
     else
     {
@@ -1,6 +1,7 @@
 #include <AMReX_EB_STL_utils.H>
 #include <AMReX_EB_triGeomOps_K.H>
 #include <AMReX_IntConv.H>
+#include <algorithm>
 #include <cstring>
 
 namespace amrex
@@ -29,6 +30,99 @@ namespace {
         }
     }
 
+    // Does the box of a BVH node intersect the box [a,b]?
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool node_box_intersects (STLtools::BVHNode const& node, Real const a[3], Real const b[3])
+    {
+        return !(a[0] > node.hi.x || b[0] < node.lo.x ||
+                 a[1] > node.hi.y || b[1] < node.lo.y ||
+                 a[2] > node.hi.z || b[2] < node.lo.z);
+    }
+
+    // Does line ab intersect with the box of a BVH node?
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool node_line_intersects (STLtools::BVHNode const& node, Real const a[3], Real const b[3])
+    {
+        Real const lo[] = {node.lo.x, node.lo.y, node.lo.z};
+        Real const hi[] = {node.hi.x, node.hi.y, node.hi.z};
+        Real tmin = 0._rt;
+        Real tmax = 1._rt;
+        for (int d = 0; d < 3; ++d) {
+            Real dir = b[d] - a[d];
+            if (dir == 0._rt) {
+                if (a[d] < lo[d] || a[d] > hi[d]) { return false; }
+            } else {
+                Real t0 = (lo[d]-a[d]) / dir;
+                Real t1 = (hi[d]-a[d]) / dir;
+                if (t0 > t1) {
+                    Real tmp = t0;
+                    t0 = t1;
+                    t1 = tmp;
+                }
+                tmin = amrex::max(tmin, t0);
+                tmax = amrex::min(tmax, t1);
+                if (tmin > tmax) { return false; }
+            }
+        }
+        return true;
+    }
+
+    // Call f(i) for the triangles in the leaves of the BVH whose nodes pass
+    // node_test, or for all triangles if there is no BVH, until f returns
+    // true.
+    template <typename NF, typename F>
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    void bvh_for_each (STLtools::BVHNode const* nodes, int num_tri,
+                       NF const& node_test, F const& f)
+    {
+        if (nodes == nullptr) {
+            for (int i = 0; i < num_tri; ++i) {
+                if (f(i)) { return; }
+            }
+        } else {
+            int stack[STLtools::bvh_max_depth+1];
+            int sp = 0;
+            stack[sp++] = 0;
+            while (sp > 0) {
+                STLtools::BVHNode const& node = nodes[stack[--sp]];
+                if (node_test(node)) {
+                    if (node.ntri > 0) {
+                        for (int i = node.first; i < node.first+node.ntri; ++i) {
+                            if (f(i)) { return; }
+                        }
+                    } else {
+                        stack[sp++] = node.first+1;
+                        stack[sp++] = node.first;
+                    }
+                }
+            }
+        }
+    }
+
+    // Number of triangles intersecting with line ab
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    int num_line_tri_intersects (Real a[3], Real b[3], STLtools::Triangle const* tri_pts,
+                                 STLtools::BVHNode const* nodes, int num_tri)
+    {
+        int num_intersects = 0;
+        bvh_for_each(nodes, num_tri,
+                     [&] (STLtools::BVHNode const& node) {
+                         return node_line_intersects(node, a, b);
+                     },
+                     [&] (int i) {
+                         if (line_tri_intersects(a, b, tri_pts[i])) {
+                             ++num_intersects;
+                         }
+                         return false;
+                     });
+        return num_intersects;
+    }
+
+    Real xdim3_comp (XDim3 const& v, int d)
+    {
+        return (d == 0) ? v.x : ((d == 1) ? v.y : v.z);
+    }
+
     // Sign for 3 points on a plane.  This computes the sign of
     // (p2-p1)x(p3-2).  It is used to determine if a point is inside a
     // triangle in 2d.
@@ -242,6 +336,10 @@ STLtools::prepare ()
     if (!ParallelDescriptor::IOProcessor()) {
         m_tri_pts_h.resize(m_num_tri);
     }
+    ParallelDescriptor::Bcast((char*)(m_tri_pts_h.data()), m_num_tri*sizeof(Triangle));
+
+    // This reorders the triangles.
+    build_bvh();
 
     //device vectors
     m_tri_pts_d.resize(m_num_tri);
@@ -413,6 +511,132 @@ STLtools::prepare ()
     m_boundry_is_outside = num_isects % 2 == 0;
 }
 
+void
+STLtools::build_bvh ()
+{
+    BL_PROFILE("STLtools::build_bvh()");
+
+    m_bvh_nodes_d.clear();
+    if (!m_use_bvh || m_num_tri == 0) { return; }
+
+    double t0 = amrex::second();
+
+    // The BVH is built top down by splitting the triangles at the median
+    // of their centroids along the longest extent of the centroids.  The
+    // centroids are stored contiguously with the indices of the triangles.
+    struct Centroid {
+        Real c[3];
+        int i;
+    };
+    auto const& tris = m_tri_pts_h;
+    Vector<Centroid> cents(m_num_tri);
+    for (int n = 0; n < m_num_tri; ++n) {
+        for (int d = 0; d < 3; ++d) {
+            cents[n].c[d] = xdim3_comp(tris[n].v1,d) + xdim3_comp(tris[n].v2,d)
+                + xdim3_comp(tris[n].v3,d);
+        }
+        cents[n].i = n;
+    }
+
+    struct Range {
+        int node, begin, end, depth;
+    };
+    Vector<BVHNode> nodes(1);
+    nodes.reserve(2*(m_num_tri/bvh_leaf_size)+1);
+    Vector<Range> todo{Range{0, 0, m_num_tri, 0}};
+    while (!todo.empty()) {
+        Range r = todo.back();
+        todo.pop_back();
+        if (r.end - r.begin <= bvh_leaf_size) {
+            nodes[r.node].first = r.begin;
+            nodes[r.node].ntri = r.end - r.begin;
+        } else {
+            AMREX_ALWAYS_ASSERT(r.depth < bvh_max_depth);
+            constexpr Real big = std::numeric_limits<Real>::max();
+            Real clo[3] = {big,big,big}, chi[3] = {-big,-big,-big};
+            for (int n = r.begin; n < r.end; ++n) {
+                for (int d = 0; d < 3; ++d) {
+                    clo[d] = amrex::min(clo[d], cents[n].c[d]);
+                    chi[d] = amrex::max(chi[d], cents[n].c[d]);
+                }
+            }
+            int dir = 0;
+            for (int d = 1; d < 3; ++d) {
+                if (chi[d]-clo[d] > chi[dir]-clo[dir]) { dir = d; }
+            }
+            int mid = (r.begin + r.end) / 2;
+            std::nth_element(cents.begin()+r.begin, cents.begin()+mid, cents.begin()+r.end,
+                             [=] (Centroid const& a, Centroid const& b) {
+                                 return a.c[dir] < b.c[dir];
+                             });
+            int child = static_cast<int>(nodes.size());
+            nodes.resize(child+2);
+            nodes[r.node].first = child;
+            nodes[r.node].ntri = 0;
+            todo.push_back(Range{child+1, mid, r.end, r.depth+1});
+            todo.push_back(Range{child, r.begin, mid, r.depth+1});
+        }
+    }
+
+    // Store the triangles in the order of the leaves.
+    {
+        Gpu::PinnedVector<Triangle> tmp(m_num_tri);
+        for (int n = 0; n < m_num_tri; ++n) {
+            tmp[n] = tris[cents[n].i];
+        }
+        std::swap(m_tri_pts_h, tmp);
+    }
+
+    // The boxes are computed bottom up.  The children of a node come after
+    // it in nodes.
+    for (int inode = static_cast<int>(nodes.size())-1; inode >= 0; --inode) {
+        BVHNode& node = nodes[inode];
+        if (node.ntri > 0) {
+            Triangle const& tri0 = tris[node.first];
+            node.lo = tri0.v1;
+            node.hi = tri0.v1;
+            for (int n = node.first; n < node.first+node.ntri; ++n) {
+                Triangle const& tri = tris[n];
+                node.lo.x = amrex::min(node.lo.x, tri.v1.x, tri.v2.x, tri.v3.x);
+                node.lo.y = amrex::min(node.lo.y, tri.v1.y, tri.v2.y, tri.v3.y);
+                node.lo.z = amrex::min(node.lo.z, tri.v1.z, tri.v2.z, tri.v3.z);
+                node.hi.x = amrex::max(node.hi.x, tri.v1.x, tri.v2.x, tri.v3.x);
+                node.hi.y = amrex::max(node.hi.y, tri.v1.y, tri.v2.y, tri.v3.y);
+                node.hi.z = amrex::max(node.hi.z, tri.v1.z, tri.v2.z, tri.v3.z);
+            }
+        } else {
+            BVHNode const& c0 = nodes[node.first];
+            BVHNode const& c1 = nodes[node.first+1];
+            node.lo = XDim3{amrex::min(c0.lo.x,c1.lo.x), amrex::min(c0.lo.y,c1.lo.y),
+                            amrex::min(c0.lo.z,c1.lo.z)};
+            node.hi = XDim3{amrex::max(c0.hi.x,c1.hi.x), amrex::max(c0.hi.y,c1.hi.y),
+                            amrex::max(c0.hi.z,c1.hi.z)};
+        }
+    }
+
+    // The boxes are enlarged slightly so that the intersection tests of
+    // lines and boxes are robust against roundoff errors.
+    Real scale = 0._rt;
+    for (int d = 0; d < 3; ++d) {
+        scale = amrex::max(scale, std::abs(xdim3_comp(nodes[0].lo,d)),
+                           std::abs(xdim3_comp(nodes[0].hi,d)));
+    }
+    Real const eps = Real(128.) * std::numeric_limits<Real>::epsilon() * scale;
+    for (auto& node : nodes) {
+        node.lo.x -= eps; node.lo.y -= eps; node.lo.z -= eps;
+        node.hi.x += eps; node.hi.y += eps; node.hi.z += eps;
+    }
+
+    m_bvh_nodes_d.resize(nodes.size());
+    Gpu::copyAsync(Gpu::hostToDevice, nodes.begin(), nodes.end(), m_bvh_nodes_d.begin());
+    Gpu::streamSynchronize();
+
+    if (amrex::Verbose() > 0) {
+        amrex::Print() << "    Built BVH with " << nodes.size() << " nodes in "
+                       << amrex::second()-t0 << " seconds" << std::endl;
+    }
+}
+
 void
 STLtools::fill (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
                 Real outside_value, Real inside_value) const
@@ -423,6 +647,7 @@ STLtools::fill (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
     const auto dx  = geom.CellSizeArray();
 
     const Triangle* tri_pts = m_tri_pts_d.data();
+    const BVHNode* bvh = m_bvh_nodes_d.empty() ? nullptr : m_bvh_nodes_d.data();
     XDim3 ptmin = m_ptmin;
     XDim3 ptmax = m_ptmax;
     XDim3 ptref = m_ptref;
@@ -447,11 +672,7 @@ STLtools::fill (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
             coords[2] >= ptmin.z && coords[2] <= ptmax.z)
         {
             Real pr[]={ptref.x, ptref.y, ptref.z};
-            for (int tr=0; tr < num_triangles; ++tr) {
-                if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                    ++num_intersects;
-                }
-            }
+            num_intersects = num_line_tri_intersects(pr, coords, tri_pts, bvh, num_triangles);
         }
         ma[box_no](i,j,k) = (num_intersects % 2 == 0) ? reference_value : other_value;
     });
@@ -491,6 +712,7 @@ STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
     {
         int num_triangles = m_num_tri;
         const Triangle* tri_pts = m_tri_pts_d.data();
+        const BVHNode* bvh = m_bvh_nodes_d.empty() ? nullptr : m_bvh_nodes_d.data();
         XDim3 ptmin = m_ptmin;
         XDim3 ptmax = m_ptmax;
         XDim3 ptref = m_ptref;
@@ -517,11 +739,7 @@ STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
                 coords[2] >= ptmin.z && coords[2] <= ptmax.z)
             {
                 Real pr[]={ptref.x, ptref.y, ptref.z};
-                for (int tr=0; tr < num_triangles; ++tr) {
-                    if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                        ++num_intersects;
-                    }
-                }
+                num_intersects = num_line_tri_intersects(pr, coords, tri_pts, bvh, num_triangles);
             }
 
             return (num_intersects % 2 == 0) ? ref_value : 1-ref_value;
@@ -548,6 +766,7 @@ STLtools::fillFab (BaseFab<Real>& levelset, const Geometry& geom, RunOn, Box con
     const auto dx  = geom.CellSizeArray();
 
     const Triangle* tri_pts = m_tri_pts_d.data();
+    const BVHNode* bvh = m_bvh_nodes_d.empty() ? nullptr : m_bvh_nodes_d.data();
     XDim3 ptmin = m_ptmin;
     XDim3 ptmax = m_ptmax;
     XDim3 ptref = m_ptref;
@@ -572,11 +791,7 @@ STLtools::fillFab (BaseFab<Real>& levelset, const Geometry& geom, RunOn, Box con
             coords[2] >= ptmin.z && coords[2] <= ptmax.z)
         {
             Real pr[]={ptref.x, ptref.y, ptref.z};
-            for (int tr=0; tr < num_triangles; ++tr) {
-                if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                    ++num_intersects;
-                }
-            }
+            num_intersects = num_line_tri_intersects(pr, coords, tri_pts, bvh, num_triangles);
         }
         a(i,j,k) = (num_intersects % 2 == 0) ? reference_value : other_value;
     });
@@ -595,6 +810,7 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
 
     const Triangle* tri_pts = m_tri_pts_d.data();
     const XDim3* tri_norm = m_tri_normals_d.data();
+    const BVHNode* bvh = m_bvh_nodes_d.empty() ? nullptr : m_bvh_nodes_d.data();
 
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         Array4<Real> const& inter = inter_arr[idim];
@@ -612,10 +828,17 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
                          plo[2]+k*dx[2]
 #endif
                 };
+                // The box of the edge
+                Real elo[] = {p1.x, p1.y, p1.z};
+                Real ehi[] = {p1.x, p1.y, p1.z};
+                ehi[idim] += dx[idim];
+                auto edge_test = [&] (BVHNode const& node) {
+                    return node_box_intersects(node, elo, ehi);
+                };
+                bool found = false;
                 if (idim == 0) {
                     Real x2 = plo[0]+(i+1)*dx[0];
-                    int it;
-                    for (it=0; it < num_triangles; ++it) {
+                    bvh_for_each(bvh, num_triangles, edge_test, [&] (int it) {
                         auto const& tri = tri_pts[it];
                         auto tmp = edge_tri_intersects(p1.x, x2, p1.y, p1.z,
                                                        tri.v1, tri.v2, tri.v3,
@@ -623,16 +846,16 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
                                                        lst(i+1,j,k)-lst(i,j,k));
                         if (tmp.first) {
                             r = tmp.second;
-                            break;
+                            found = true;
                         }
-                    }
-                    if (it == num_triangles) {
+                        return found;
+                    });
+                    if (!found) {
                         r = (lst(i,j,k) > 0._rt) ? p1.x : x2;
                     }
                 } else if (idim == 1) {
                     Real y2 = plo[1]+(j+1)*dx[1];
-                    int it;
-                    for (it=0; it < num_triangles; ++it) {
+                    bvh_for_each(bvh, num_triangles, edge_test, [&] (int it) {
                         auto const& tri = tri_pts[it];
                         auto const& norm = tri_norm[it];
                         auto tmp = edge_tri_intersects(p1.y, y2, p1.z, p1.x,
@@ -643,16 +866,16 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
                                                        lst(i,j+1,k)-lst(i,j,k));
                         if (tmp.first) {
                             r = tmp.second;
-                            break;
+                            found = true;
                         }
-                    }
-                    if (it == num_triangles) {
+                        return found;
+                    });
+                    if (!found) {
                         r = (lst(i,j,k) > 0._rt) ? p1.y : y2;
                     }
                 } else {
                     Real z2 = plo[2]+(k+1)*dx[2];
-                    int it;
-                    for (it=0; it < num_triangles; ++it) {
+                    bvh_for_each(bvh, num_triangles, edge_test, [&] (int it) {
                         auto const& tri = tri_pts[it];
                         auto const& norm = tri_norm[it];
                         auto tmp = edge_tri_intersects(p1.z, z2, p1.x, p1.y,
@@ -663,10 +886,11 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
                                                        lst(i,j,k+1)-lst(i,j,k));
                         if (tmp.first) {
                             r = tmp.second;
-                            break;
+                            found = true;
                         }
-                    }
-                    if (it == num_triangles) {
+                        return found;
+                    });
+                    if (!found) {
                         r = (lst(i,j,k) > 0._rt) ? p1.z : z2;
                     }
                 }
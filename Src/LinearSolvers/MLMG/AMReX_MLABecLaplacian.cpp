@@ -3,6 +3,7 @@
 #include <AMReX_MultiFabUtil.H>
 
 #include <AMReX_MLABecLap_K.H>
+#include <AMReX_MLLinOp_K.H>
 
 namespace amrex {
 
@@ -123,6 +124,7 @@ MLABecLaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 {
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(alpha.nComp() == 1,
                                      "MLABecLaplacian::setACoeffs: alpha is supposed to be single component.");
+    if (isFrozenAndUnchanged(m_a_coeffs[amrlev][0], 0, alpha, 0, 1)) { return; }
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
     m_needs_update = true;
 }
@@ -140,6 +142,7 @@ MLABecLaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 void
 MLABecLaplacian::setACoeffs (int amrlev, Real alpha)
 {
+    if (isFrozenAndUnchanged(m_a_coeffs[amrlev][0], 0, alpha, 1)) { return; }
     m_a_coeffs[amrlev][0].setVal(alpha);
     m_needs_update = true;
 }
@@ -160,6 +163,14 @@ MLABecLaplacian::setBCoeffs (int amrlev,
 {
     const int ncomp = getNComp();
     AMREX_ALWAYS_ASSERT(beta[0]->nComp() == 1 || beta[0]->nComp() == ncomp);
+    bool unchanged = true;
+    for (int idim = 0; idim < AMREX_SPACEDIM && unchanged; ++idim) {
+        for (int icomp = 0; icomp < ncomp && unchanged; ++icomp) {
+            const int scomp = (beta[idim]->nComp() == ncomp) ? icomp : 0;
+            unchanged = isFrozenAndUnchanged(m_b_coeffs[amrlev][0][idim], icomp, *beta[idim], scomp, 1);
+        }
+    }
+    if (unchanged) { return; }
     if (beta[0]->nComp() == ncomp)
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
             for (int icomp = 0; icomp < ncomp; ++icomp) {
@@ -188,6 +199,11 @@ MLABecLaplacian::setBCoeffs (int amrlev,
 void
 MLABecLaplacian::setBCoeffs (int amrlev, Real beta)
 {
+    bool unchanged = true;
+    for (int idim = 0; idim < AMREX_SPACEDIM && unchanged; ++idim) {
+        unchanged = isFrozenAndUnchanged(m_b_coeffs[amrlev][0][idim], 0, beta, getNComp());
+    }
+    if (unchanged) { return; }
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         m_b_coeffs[amrlev][0][idim].setVal(beta);
     }
@@ -208,6 +224,13 @@ void
 MLABecLaplacian::setBCoeffs (int amrlev, Vector<Real> const& beta)
 {
     const int ncomp = getNComp();
+    bool unchanged = true;
+    for (int idim = 0; idim < AMREX_SPACEDIM && unchanged; ++idim) {
+        for (int icomp = 0; icomp < ncomp && unchanged; ++icomp) {
+            unchanged = isFrozenAndUnchanged(m_b_coeffs[amrlev][0][idim], icomp, beta[icomp], 1);
+        }
+    }
+    if (unchanged) { return; }
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         for (int icomp = 0; icomp < ncomp; ++icomp) {
             m_b_coeffs[amrlev][0][idim].setVal(beta[icomp]);
@@ -481,9 +504,48 @@ MLABecLaplacian::prepareForSolve ()
 
     update_singular_flags();
 
+    update_float_coeffs();
+
     m_needs_update = false;
 }
 
+void
+MLABecLaplacian::update_float_coeffs ()
+{
+    if (!info.mixed_precision) return;
+
+    BL_PROFILE("MLABecLaplacian::update_float_coeffs()");
+
+    const int ncomp = getNComp();
+    if (m_a_coeffs_f.empty()) {
+        m_a_coeffs_f.resize(m_num_amr_levels);
+        m_b_coeffs_f.resize(m_num_amr_levels);
+        for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev) {
+            m_a_coeffs_f[amrlev].resize(m_num_mg_levels[amrlev]);
+            m_b_coeffs_f[amrlev].resize(m_num_mg_levels[amrlev]);
+            for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev) {
+                m_a_coeffs_f[amrlev][mglev].define(m_grids[amrlev][mglev],
+                                                   m_dmap[amrlev][mglev], 1, 0);
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    m_b_coeffs_f[amrlev][mglev][idim].define
+                        (m_b_coeffs[amrlev][mglev][idim].boxArray(),
+                         m_dmap[amrlev][mglev], ncomp, 0);
+                }
+            }
+        }
+    }
+
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev) {
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev) {
+            m_a_coeffs_f[amrlev][mglev].LocalCopy(m_a_coeffs[amrlev][mglev], 0, 0, 1, IntVect(0));
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                m_b_coeffs_f[amrlev][mglev][idim].LocalCopy(m_b_coeffs[amrlev][mglev][idim],
+                                                            0, 0, ncomp, IntVect(0));
+            }
+        }
+    }
+}
+
 void
 MLABecLaplacian::update_singular_flags ()
 {
@@ -513,15 +575,37 @@ MLABecLaplacian::update_singular_flags ()
     }
 }
 
+void
+MLABecLaplacian::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc_mode,
+                        StateMode s_mode, const MLMGBndry* bndry) const
+{
+    if (s_mode == StateMode::Correction && !m_a_coeffs_f.empty()) {
+        BL_PROFILE("MLABecLaplacian::apply(float)");
+        applyBC(amrlev, mglev, in, bc_mode, s_mode, bndry);
+        FapplyImpl(amrlev, mglev, out, in, m_a_coeffs_f[amrlev][mglev],
+                   amrex::GetArrOfConstPtrs(m_b_coeffs_f[amrlev][mglev]));
+    } else {
+        MLCellLinOp::apply(amrlev, mglev, out, in, bc_mode, s_mode, bndry);
+    }
+}
+
 void
 MLABecLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) const
 {
     BL_PROFILE("MLABecLaplacian::Fapply()");
+    FapplyImpl(amrlev, mglev, out, in, m_a_coeffs[amrlev][mglev],
+               amrex::GetArrOfConstPtrs(m_b_coeffs[amrlev][mglev]));
+}
 
-    const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
-    AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
-                 const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
-                 const MultiFab& bzcoef = m_b_coeffs[amrlev][mglev][2];);
+template <typename MF>
+void
+MLABecLaplacian::FapplyImpl (int amrlev, int mglev, MultiFab& out, const MultiFab& in,
+                             MF const& acoef,
+                             Array<MF const*,AMREX_SPACEDIM> const& bcoef) const
+{
+    AMREX_D_TERM(MF const& bxcoef = *bcoef[0];,
+                 MF const& bycoef = *bcoef[1];,
+                 MF const& bzcoef = *bcoef[2];);
 
     const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
 
@@ -646,6 +730,107 @@ MLABecLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
     }
 }
 
+bool
+MLABecLaplacian::correctionResidualRestriction (int amrlev, int mglev, MultiFab& crse_resid,
+                                                MultiFab& x, const MultiFab& b)
+{
+    // The tensor operator has its own apply, and the overset mask is not
+    // supported by the fused kernel.
+    if (isTensorOp() || m_overset_mask[amrlev][mglev] || !isMFIterSafe(amrlev, mglev, mglev+1)) {
+        return false;
+    }
+
+    BL_PROFILE("MLABecLaplacian::correctionResidualRestriction()");
+    applyBC(amrlev, mglev, x, BCMode::Homogeneous, StateMode::Correction);
+#ifdef AMREX_SOFT_PERF_COUNTERS
+    perf_counters.apply(x);
+    perf_counters.restrict(crse_resid);
+#endif
+    if (!m_a_coeffs_f.empty()) {
+        CorResRestrictImpl(amrlev, mglev, crse_resid, x, b, m_a_coeffs_f[amrlev][mglev],
+                           amrex::GetArrOfConstPtrs(m_b_coeffs_f[amrlev][mglev]));
+    } else {
+        CorResRestrictImpl(amrlev, mglev, crse_resid, x, b, m_a_coeffs[amrlev][mglev],
+                           amrex::GetArrOfConstPtrs(m_b_coeffs[amrlev][mglev]));
+    }
+    return true;
+}
+
+template <typename MF>
+void
+MLABecLaplacian::CorResRestrictImpl (int amrlev, int mglev, MultiFab& crse_resid,
+                                     const MultiFab& x, const MultiFab& b, MF const& acoef,
+                                     Array<MF const*,AMREX_SPACEDIM> const& bcoef) const
+{
+    AMREX_D_TERM(MF const& bxcoef = *bcoef[0];,
+                 MF const& bycoef = *bcoef[1];,
+                 MF const& bzcoef = *bcoef[2];);
+
+    const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
+
+    Dim3 ratio3 = {1,1,1};
+    IntVect ratio = (amrlev > 0) ? IntVect(2) : mg_coarsen_ratio_vec[mglev];
+    AMREX_D_TERM(ratio3.x = ratio[0];,
+                 ratio3.y = ratio[1];,
+                 ratio3.z = ratio[2];);
+
+    const Real ascalar = m_a_scalar;
+    const Real bscalar = m_b_scalar;
+
+    const int ncomp = getNComp();
+
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion() && crse_resid.isFusingCandidate()) {
+        const auto& cma = crse_resid.arrays();
+        const auto& xma = x.const_arrays();
+        const auto& bma = b.const_arrays();
+        const auto& ama = acoef.const_arrays();
+        AMREX_D_TERM(const auto& bxma = bxcoef.const_arrays();,
+                     const auto& byma = bycoef.const_arrays();,
+                     const auto& bzma = bzcoef.const_arrays(););
+        ParallelFor(crse_resid, IntVect(0), ncomp,
+        [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+        {
+            mllinop_restrict_res(i,j,k,n, cma[box_no], ratio3,
+            [=] (int ii, int jj, int kk, int nn) -> Real
+            {
+                return mlabeclap_corres(ii,jj,kk,nn, xma[box_no], bma[box_no], ama[box_no],
+                                        AMREX_D_DECL(bxma[box_no],byma[box_no],bzma[box_no]),
+                                        dxinv, ascalar, bscalar);
+            });
+        });
+        Gpu::streamSynchronize();
+    } else
+#endif
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        {
+            Vector<Real> rowbuf;
+            for (MFIter mfi(crse_resid, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                const auto& cfab = crse_resid.array(mfi);
+                const auto& xfab = x.const_array(mfi);
+                const auto& bfab = b.const_array(mfi);
+                const auto& afab = acoef.const_array(mfi);
+                AMREX_D_TERM(const auto& bxfab = bxcoef.const_array(mfi);,
+                             const auto& byfab = bycoef.const_array(mfi);,
+                             const auto& bzfab = bzcoef.const_array(mfi););
+                rowbuf.resize(bx.length(0)*ratio3.x);
+                mllinop_restrict_res(bx, ncomp, cfab, ratio3,
+                [=] (int i, int j, int k, int n) -> Real
+                {
+                    return mlabeclap_corres(i,j,k,n, xfab, bfab, afab,
+                                            AMREX_D_DECL(bxfab,byfab,bzfab),
+                                            dxinv, ascalar, bscalar);
+                }, rowbuf.data());
+            }
+        }
+    }
+}
+
 void
 MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, int redblack) const
 {
@@ -656,11 +841,28 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
         regular_coarsening = mg_coarsen_ratio_vec[mglev-1] == mg_coarsen_ratio;
     }
 
-    const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
+    // The line solve needs the coefficients in Real.
+    if (!m_a_coeffs_f.empty() && (regular_coarsening || m_overset_mask[amrlev][mglev])) {
+        FsmoothImpl(amrlev, mglev, sol, rhs, redblack, regular_coarsening,
+                    m_a_coeffs_f[amrlev][mglev],
+                    amrex::GetArrOfConstPtrs(m_b_coeffs_f[amrlev][mglev]));
+    } else {
+        FsmoothImpl(amrlev, mglev, sol, rhs, redblack, regular_coarsening,
+                    m_a_coeffs[amrlev][mglev],
+                    amrex::GetArrOfConstPtrs(m_b_coeffs[amrlev][mglev]));
+    }
+}
+
+template <typename MF>
+void
+MLABecLaplacian::FsmoothImpl (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                              int redblack, bool regular_coarsening, MF const& acoef,
+                              Array<MF const*,AMREX_SPACEDIM> const& bcoef) const
+{
     AMREX_ALWAYS_ASSERT(acoef.nGrowVect() == 0);
-    AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
-                 const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
-                 const MultiFab& bzcoef = m_b_coeffs[amrlev][mglev][2];);
+    AMREX_D_TERM(MF const& bxcoef = *bcoef[0];,
+                 MF const& bycoef = *bcoef[1];,
+                 MF const& bzcoef = *bcoef[2];);
     const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
     const auto& maskvals  = m_maskvals [amrlev][mglev];
 
@@ -828,7 +1030,7 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                               AMREX_D_DECL(f1fab,f3fab,f5fab),
                               vbx, redblack);
                 });
-            } else {
+            } else if constexpr (std::is_same<MF,MultiFab>::value) {
                 Gpu::LaunchSafeGuard lsg(false); // xxxxx gpu todo
                 // line solve does not with with GPU
                 AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
@@ -947,6 +1149,8 @@ MLABecLaplacian::update ()
 
     update_singular_flags();
 
+    update_float_coeffs();
+
     m_needs_update = false;
 }
 
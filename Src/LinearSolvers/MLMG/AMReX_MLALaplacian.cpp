@@ -62,6 +62,7 @@ void
 MLALaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 {
     const int ncomp = getNComp();
+    if (isFrozenAndUnchanged(m_a_coeffs[amrlev][0], 0, alpha, 0, ncomp)) { return; }
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, ncomp, 0);
     m_needs_update = true;
 }
@@ -0,0 +1,807 @@
+#include <AMReX_MLAMG.H>
+#include <AMReX_MLCellLinOp.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+namespace amrex {
+
+namespace {
+
+using Matrix = MLAMG::Matrix;
+
+void spmv (Matrix const& A, Real const* x, Real* y)
+{
+    for (int i = 0; i < A.nrows; ++i) {
+        Real s = 0;
+        for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k) {
+            s += A.val[k]*x[A.col[k]];
+        }
+        y[i] = s;
+    }
+}
+
+// r = b - A x
+void residual (Matrix const& A, Real const* x, Real const* b, Real* r)
+{
+    for (int i = 0; i < A.nrows; ++i) {
+        Real s = b[i];
+        for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k) {
+            s -= A.val[k]*x[A.col[k]];
+        }
+        r[i] = s;
+    }
+}
+
+void gauss_seidel (Matrix const& A, Vector<Real> const& dinv, Real* x, Real const* b,
+                   bool forward)
+{
+    for (int ii = 0; ii < A.nrows; ++ii) {
+        const int i = forward ? ii : A.nrows-1-ii;
+        Real s = b[i];
+        for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k) {
+            s -= A.val[k]*x[A.col[k]];
+        }
+        x[i] += dinv[i]*s;
+    }
+}
+
+Matrix transpose (Matrix const& A)
+{
+    Matrix T;
+    T.nrows = A.ncols;
+    T.ncols = A.nrows;
+    T.rowptr.assign(T.nrows+1, 0);
+    for (int c : A.col) { ++T.rowptr[c+1]; }
+    for (int i = 0; i < T.nrows; ++i) { T.rowptr[i+1] += T.rowptr[i]; }
+    T.col.resize(A.col.size());
+    T.val.resize(A.val.size());
+    Vector<int> pos(T.rowptr.begin(), T.rowptr.end()-1);
+    for (int i = 0; i < A.nrows; ++i) {
+        for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k) {
+            const int p = pos[A.col[k]]++;
+            T.col[p] = i;
+            T.val[p] = A.val[k];
+        }
+    }
+    return T;
+}
+
+// C = A B with Gustavson's row by row algorithm.
+Matrix multiply (Matrix const& A, Matrix const& B)
+{
+    Matrix C;
+    C.nrows = A.nrows;
+    C.ncols = B.ncols;
+    C.rowptr.resize(C.nrows+1);
+    C.rowptr[0] = 0;
+    Vector<int> marker(B.ncols, -1);
+    for (int i = 0; i < A.nrows; ++i) {
+        const int row_start = static_cast<int>(C.col.size());
+        for (int ka = A.rowptr[i]; ka < A.rowptr[i+1]; ++ka) {
+            const int j = A.col[ka];
+            const Real a = A.val[ka];
+            for (int kb = B.rowptr[j]; kb < B.rowptr[j+1]; ++kb) {
+                const int c = B.col[kb];
+                if (marker[c] < row_start) {
+                    marker[c] = static_cast<int>(C.col.size());
+                    C.col.push_back(c);
+                    C.val.push_back(a*B.val[kb]);
+                } else {
+                    C.val[marker[c]] += a*B.val[kb];
+                }
+            }
+        }
+        C.rowptr[i+1] = static_cast<int>(C.col.size());
+    }
+    return C;
+}
+
+Vector<Real> diagonal (Matrix const& A)
+{
+    Vector<Real> d(A.nrows, 0);
+    for (int i = 0; i < A.nrows; ++i) {
+        for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k) {
+            if (A.col[k] == i) { d[i] += A.val[k]; }
+        }
+    }
+    return d;
+}
+
+// Aggregation of strongly connected rows in three passes (Vanek, Mandel
+// and Brezina 1996).  Rows without strong connections are not aggregated.
+Vector<int> aggregate (Matrix const& A, Vector<Real> const& d, Real theta, int& naggs)
+{
+    const int n = A.nrows;
+    Vector<int> sptr(n+1, 0);
+    Vector<int> scol;
+    Vector<Real> sval;
+    for (int i = 0; i < n; ++i) {
+        for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k) {
+            const int j = A.col[k];
+            const Real a = std::abs(A.val[k]);
+            if (j != i && a > 0 && a >= theta*std::sqrt(std::abs(d[i]*d[j]))) {
+                scol.push_back(j);
+                sval.push_back(a);
+            }
+        }
+        sptr[i+1] = static_cast<int>(scol.size());
+    }
+
+    Vector<int> agg(n, -1);
+    naggs = 0;
+
+    // Aggregates of rows whose strong neighbors are all free
+    for (int i = 0; i < n; ++i) {
+        if (agg[i] != -1 || sptr[i] == sptr[i+1]) { continue; }
+        bool free = true;
+        for (int k = sptr[i]; k < sptr[i+1] && free; ++k) {
+            free = agg[scol[k]] == -1;
+        }
+        if (free) {
+            agg[i] = naggs;
+            for (int k = sptr[i]; k < sptr[i+1]; ++k) { agg[scol[k]] = naggs; }
+            ++naggs;
+        }
+    }
+
+    // Attach the remaining rows to the strongest neighboring aggregate
+    Vector<int> agg1 = agg;
+    for (int i = 0; i < n; ++i) {
+        if (agg1[i] != -1) { continue; }
+        Real smax = 0;
+        for (int k = sptr[i]; k < sptr[i+1]; ++k) {
+            if (agg1[scol[k]] != -1 && sval[k] > smax) {
+                smax = sval[k];
+                agg[i] = agg1[scol[k]];
+            }
+        }
+    }
+
+    // Aggregate the rows that are still left with their free neighbors
+    for (int i = 0; i < n; ++i) {
+        if (agg[i] != -1 || sptr[i] == sptr[i+1]) { continue; }
+        agg[i] = naggs;
+        for (int k = sptr[i]; k < sptr[i+1]; ++k) {
+            if (agg[scol[k]] == -1) { agg[scol[k]] = naggs; }
+        }
+        ++naggs;
+    }
+
+    return agg;
+}
+
+// Prolongation (I - omega D^{-1} A) P0, where P0 is the piecewise constant
+// interpolation from the aggregates, and omega = 4/(3 rho(D^{-1} A)) with
+// the Gershgorin bound of the spectral radius.
+Matrix smoothed_prolongation (Matrix const& A, Vector<Real> const& d,
+                              Vector<int> const& agg, int naggs)
+{
+    const int n = A.nrows;
+
+    Matrix P0;
+    P0.nrows = n;
+    P0.ncols = naggs;
+    P0.rowptr.resize(n+1);
+    P0.rowptr[0] = 0;
+    for (int i = 0; i < n; ++i) {
+        if (agg[i] >= 0) {
+            P0.col.push_back(agg[i]);
+            P0.val.push_back(1.0);
+        }
+        P0.rowptr[i+1] = static_cast<int>(P0.col.size());
+    }
+
+    Real rho = 0;
+    for (int i = 0; i < n; ++i) {
+        if (d[i] == 0) { continue; }
+        Real s = 0;
+        for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k) { s += std::abs(A.val[k]); }
+        rho = amrex::max(rho, s/std::abs(d[i]));
+    }
+    const Real omega = (rho > 0) ? Real(4./3.)/rho : Real(0.);
+
+    Matrix S;
+    S.nrows = n;
+    S.ncols = n;
+    S.rowptr.resize(n+1);
+    S.rowptr[0] = 0;
+    for (int i = 0; i < n; ++i) {
+        if (d[i] == 0) {
+            S.col.push_back(i);
+            S.val.push_back(1.0);
+        } else {
+            const Real f = -omega/d[i];
+            bool has_diag = false;
+            for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k) {
+                S.col.push_back(A.col[k]);
+                if (A.col[k] == i && !has_diag) {
+                    S.val.push_back(Real(1.)+f*d[i]);
+                    has_diag = true;
+                } else if (A.col[k] == i) {
+                    S.val.push_back(0.);
+                } else {
+                    S.val.push_back(f*A.val[k]);
+                }
+            }
+        }
+        S.rowptr[i+1] = static_cast<int>(S.col.size());
+    }
+
+    return multiply(S, P0);
+}
+
+}
+
+MLAMG::MLAMG (MLLinOp& a_lp)
+    : Lp(a_lp),
+      mglev(a_lp.NMGLevels(0)-1)
+{}
+
+MLAMG::~MLAMG () = default;
+
+void
+MLAMG::assemble ()
+{
+    BL_PROFILE("MLAMG::assemble()");
+
+    auto const* cellop = dynamic_cast<MLCellLinOp const*>(&Lp);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(cellop != nullptr && Lp.getNComp() == 1,
+                                     "MLAMG only works with single-component cell-centered operators");
+
+    const BoxArray& ba = Lp.m_grids[amrlev][mglev];
+    const DistributionMapping& dm = Lp.m_dmap[amrlev][mglev];
+    const Geometry& geom = Lp.m_geom[amrlev][mglev];
+    const Box& domain = geom.Domain();
+
+    AMREX_ALWAYS_ASSERT(ba.numPts() < Long(std::numeric_limits<int>::max()));
+
+    // The rows are numbered by rank of the bottom communicator first, and
+    // then by box, so that an all-gather of the local rows gives the
+    // global vector.
+    const int nprocs = ParallelContext::NProcsSub();
+    const int myproc = ParallelContext::MyProcSub();
+    m_counts.assign(nprocs, 0);
+    m_displs.assign(nprocs, 0);
+    m_box_offset.resize(ba.size());
+    for (int ib = 0; ib < ba.size(); ++ib) {
+        const int rank = ParallelContext::global_to_local_rank(dm[ib]);
+        m_counts[rank] += static_cast<int>(ba[ib].numPts());
+    }
+    for (int rank = 1; rank < nprocs; ++rank) {
+        m_displs[rank] = m_displs[rank-1] + m_counts[rank-1];
+    }
+    {
+        Vector<int> pos = m_displs;
+        for (int ib = 0; ib < ba.size(); ++ib) {
+            const int rank = ParallelContext::global_to_local_rank(dm[ib]);
+            m_box_offset[ib] = pos[rank];
+            pos[rank] += static_cast<int>(ba[ib].numPts());
+        }
+    }
+
+    // Each row couples to the cells within the given radius.  The cells
+    // are colored so that they have different colors within any such
+    // neighborhood, and the color is periodic across periodic boundaries.
+    const int radius = cellop->isCrossStencil() ? amrex::max(1, Lp.getMaxOrder()-2) : 2;
+    IntVect period, stride;
+    int ncolors = 1;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        int m = 2*radius+1;
+        if (geom.isPeriodic(idim)) {
+            const int len = domain.length(idim);
+            m = len;
+            for (int mm = 2*radius+1; mm <= len; ++mm) {
+                if (len % mm == 0) { m = mm; break; }
+            }
+        }
+        period[idim] = m;
+        stride[idim] = ncolors;
+        ncolors *= m;
+    }
+
+    IntVect ng(1);
+    if (Lp.hasHiddenDimension()) { ng[Lp.hiddenDirection()] = 0; }
+    Any ax = Lp.AnyMake(amrlev, mglev, ng);
+    Any ay = Lp.AnyMake(amrlev, mglev, IntVect(0));
+    MultiFab& x = ax.get<MultiFab>();
+    MultiFab& y = ay.get<MultiFab>();
+
+    struct Entry { int row; int col; Real val; };
+    Vector<Entry> entries;
+    Vector<Real> hy;
+    Long ndropped = 0;
+    const IntVect dlo = domain.smallEnd();
+    const IntVect dhi = domain.bigEnd();
+
+    for (int color = 0; color < ncolors; ++color)
+    {
+        IntVect cv;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            cv[idim] = (color / stride[idim]) % period[idim];
+        }
+
+        x.setVal(0.0);
+        for (MFIter mfi(x); mfi.isValid(); ++mfi)
+        {
+            Box const& bx = mfi.validbox();
+            Array4<Real> const& a = x.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                IntVect iv(AMREX_D_DECL(i,j,k));
+                bool on = true;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    on = on && ((iv[idim]-dlo[idim]) % period[idim] == cv[idim]);
+                }
+                a(i,j,k) = on ? 1.0 : 0.0;
+            });
+        }
+
+        Lp.apply(amrlev, mglev, y, x, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+        for (MFIter mfi(y); mfi.isValid(); ++mfi)
+        {
+            Box const& bx = mfi.validbox();
+            const int ib = mfi.index();
+            hy.resize(bx.numPts());
+            Gpu::copy(Gpu::deviceToHost, y[mfi].dataPtr(), y[mfi].dataPtr()+hy.size(), hy.begin());
+
+            int l = 0;
+            for (BoxIterator bit(bx); bit.ok(); ++bit, ++l) {
+                const Real v = hy[l];
+                if (v == 0) { continue; }
+
+                // The only cell of this color that the row couples to
+                const IntVect iv = bit();
+                IntVect q = iv;
+                bool found = true;
+                for (int idim = 0; idim < AMREX_SPACEDIM && found; ++idim) {
+                    found = false;
+                    for (int o = -radius; o <= radius; ++o) {
+                        int qd = iv[idim] + o;
+                        if (qd < dlo[idim] || qd > dhi[idim]) {
+                            if (!geom.isPeriodic(idim)) { continue; }
+                            const int len = domain.length(idim);
+                            qd = dlo[idim] + ((qd-dlo[idim]) % len + len) % len;
+                        }
+                        if ((qd-dlo[idim]) % period[idim] == cv[idim]) {
+                            q[idim] = qd;
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+
+                int jb = -1;
+                if (found) {
+                    if (ba[ib].contains(q)) {
+                        jb = ib;
+                    } else {
+                        auto const& isects = ba.intersections(Box(q,q), true, 0);
+                        if (!isects.empty()) { jb = isects[0].first; }
+                    }
+                }
+
+                if (jb < 0) {
+                    ++ndropped;
+                } else {
+                    Box const& qbx = ba[jb];
+                    const int col = m_box_offset[jb] + static_cast<int>(qbx.index(q));
+                    entries.push_back(Entry{m_box_offset[ib]+l, col, v});
+                }
+            }
+        }
+    }
+
+    ParallelAllReduce::Sum(ndropped, ParallelContext::CommunicatorSub());
+    if (ndropped > 0) {
+        amrex::Warning("MLAMG: the operator couples cells beyond the assumed stencil");
+    }
+
+    std::sort(entries.begin(), entries.end(), [] (Entry const& a, Entry const& b)
+              { return (a.row < b.row) || (a.row == b.row && a.col < b.col); });
+
+    // Local rows, with identity rows for cells that the operator does not
+    // touch (e.g., covered cells).
+    const int nlocal = m_counts[myproc];
+    const int row0 = m_displs[myproc];
+    Vector<int> rowlen(nlocal, 0);
+    Vector<int> lcol;
+    Vector<Real> lval;
+    lcol.reserve(entries.size());
+    lval.reserve(entries.size());
+    {
+        Long ie = 0;
+        for (int i = 0; i < nlocal; ++i) {
+            const int row = row0 + i;
+            for (; ie < entries.size() && entries[ie].row == row; ++ie) {
+                lcol.push_back(entries[ie].col);
+                lval.push_back(entries[ie].val);
+                ++rowlen[i];
+            }
+            if (rowlen[i] == 0) {
+                lcol.push_back(row);
+                lval.push_back(1.0);
+                rowlen[i] = 1;
+            }
+        }
+    }
+
+    const int N = static_cast<int>(ba.numPts());
+    Matrix& A = m_levels[0].A;
+    A.nrows = N;
+    A.ncols = N;
+    A.rowptr.resize(N+1);
+
+#ifdef BL_USE_MPI
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+    const int nnz_local = static_cast<int>(lcol.size());
+    Vector<int> nnz_counts(nprocs), nnz_displs(nprocs, 0);
+    BL_MPI_REQUIRE( MPI_Allgather(&nnz_local, 1, MPI_INT, nnz_counts.data(), 1, MPI_INT, comm) );
+    for (int rank = 1; rank < nprocs; ++rank) {
+        nnz_displs[rank] = nnz_displs[rank-1] + nnz_counts[rank-1];
+    }
+    const int nnz = nnz_displs[nprocs-1] + nnz_counts[nprocs-1];
+    A.col.resize(nnz);
+    A.val.resize(nnz);
+    Vector<int> grow(N);
+    BL_MPI_REQUIRE( MPI_Allgatherv(rowlen.data(), nlocal, MPI_INT, grow.data(),
+                                   m_counts.data(), m_displs.data(), MPI_INT, comm) );
+    BL_MPI_REQUIRE( MPI_Allgatherv(lcol.data(), nnz_local, MPI_INT, A.col.data(),
+                                   nnz_counts.data(), nnz_displs.data(), MPI_INT, comm) );
+    BL_MPI_REQUIRE( MPI_Allgatherv(lval.data(), nnz_local,
+                                   ParallelDescriptor::Mpi_typemap<Real>::type(), A.val.data(),
+                                   nnz_counts.data(), nnz_displs.data(),
+                                   ParallelDescriptor::Mpi_typemap<Real>::type(), comm) );
+#else
+    Vector<int> grow = std::move(rowlen);
+    A.col = std::move(lcol);
+    A.val = std::move(lval);
+#endif
+
+    A.rowptr[0] = 0;
+    for (int i = 0; i < N; ++i) {
+        A.rowptr[i+1] = A.rowptr[i] + grow[i];
+    }
+}
+
+void
+MLAMG::setup ()
+{
+    BL_PROFILE("MLAMG::setup()");
+
+    m_levels.clear();
+    m_levels.resize(1);
+    assemble();
+
+    while (static_cast<int>(m_levels.size()) < max_levels &&
+           m_levels.back().A.nrows > max_coarse_size)
+    {
+        Level& fine = m_levels.back();
+        const Vector<Real> d = diagonal(fine.A);
+        int naggs = 0;
+        const Vector<int> agg = aggregate(fine.A, d, strength_threshold, naggs);
+        if (naggs == 0 || 10*Long(naggs) > 9*Long(fine.A.nrows)) { break; }
+
+        fine.P = smoothed_prolongation(fine.A, d, agg, naggs);
+        fine.R = transpose(fine.P);
+        Matrix Ac = multiply(fine.R, multiply(fine.A, fine.P));
+
+        m_levels.emplace_back();
+        m_levels.back().A = std::move(Ac);
+    }
+
+    for (auto& lev : m_levels) {
+        const int n = lev.A.nrows;
+        lev.dinv = diagonal(lev.A);
+        for (auto& v : lev.dinv) { v = (v != 0) ? Real(1.)/v : Real(0.); }
+        lev.x.resize(n);
+        lev.b.resize(n);
+        lev.r.resize(n);
+    }
+
+    factorCoarsest();
+
+    if (verbose > 0) {
+        amrex::Print() << "MLAMG: " << m_levels.size() << " levels\n";
+        for (int ilev = 0; ilev < getNumLevels(); ++ilev) {
+            amrex::Print() << "    level " << ilev << ": " << m_levels[ilev].A.nrows << " rows, "
+                           << m_levels[ilev].A.col.size() << " nonzeros\n";
+        }
+    }
+}
+
+void
+MLAMG::factorCoarsest ()
+{
+    m_lu.clear();
+    m_piv.clear();
+
+    Matrix const& A = m_levels.back().A;
+    const int n = A.nrows;
+    if (n > max_dense_size) { return; }
+
+    m_lu.assign(std::size_t(n)*n, 0);
+    m_piv.resize(n);
+    Real amax = 0;
+    for (int i = 0; i < n; ++i) {
+        for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k) {
+            m_lu[std::size_t(i)*n+A.col[k]] += A.val[k];
+            amax = amrex::max(amax, std::abs(A.val[k]));
+        }
+    }
+
+    // A pivot that vanishes (e.g., for singular problems) is replaced, so
+    // that the component in the null space is left arbitrary.
+    const Real tiny = Real(1.e-10)*amax;
+    for (int k = 0; k < n; ++k) {
+        int p = k;
+        for (int i = k+1; i < n; ++i) {
+            if (std::abs(m_lu[std::size_t(i)*n+k]) > std::abs(m_lu[std::size_t(p)*n+k])) { p = i; }
+        }
+        m_piv[k] = p;
+        if (p != k) {
+            for (int j = 0; j < n; ++j) {
+                std::swap(m_lu[std::size_t(k)*n+j], m_lu[std::size_t(p)*n+j]);
+            }
+        }
+        Real const pivot = m_lu[std::size_t(k)*n+k];
+        if (std::abs(pivot) <= tiny) {
+            m_lu[std::size_t(k)*n+k] = amax;
+            for (int i = k+1; i < n; ++i) { m_lu[std::size_t(i)*n+k] = 0; }
+            continue;
+        }
+        for (int i = k+1; i < n; ++i) {
+            Real& l = m_lu[std::size_t(i)*n+k];
+            if (l == 0) { continue; }
+            l /= pivot;
+            for (int j = k+1; j < n; ++j) {
+                m_lu[std::size_t(i)*n+j] -= l*m_lu[std::size_t(k)*n+j];
+            }
+        }
+    }
+}
+
+void
+MLAMG::vcycle (int ilev)
+{
+    Level& lev = m_levels[ilev];
+    const int n = lev.A.nrows;
+
+    if (ilev == getNumLevels()-1)
+    {
+        if (m_lu.empty()) {
+            std::fill(lev.x.begin(), lev.x.end(), Real(0.));
+            for (int i = 0; i < 10; ++i) {
+                gauss_seidel(lev.A, lev.dinv, lev.x.data(), lev.b.data(), true);
+                gauss_seidel(lev.A, lev.dinv, lev.x.data(), lev.b.data(), false);
+            }
+        } else {
+            Real* x = lev.x.data();
+            std::copy(lev.b.begin(), lev.b.end(), x);
+            for (int k = 0; k < n; ++k) {
+                std::swap(x[k], x[m_piv[k]]);
+            }
+            for (int i = 1; i < n; ++i) {
+                Real s = x[i];
+                for (int j = 0; j < i; ++j) { s -= m_lu[std::size_t(i)*n+j]*x[j]; }
+                x[i] = s;
+            }
+            for (int i = n-1; i >= 0; --i) {
+                Real s = x[i];
+                for (int j = i+1; j < n; ++j) { s -= m_lu[std::size_t(i)*n+j]*x[j]; }
+                x[i] = s/m_lu[std::size_t(i)*n+i];
+            }
+        }
+        return;
+    }
+
+    std::fill(lev.x.begin(), lev.x.end(), Real(0.));
+    for (int i = 0; i < nsmooth; ++i) {
+        gauss_seidel(lev.A, lev.dinv, lev.x.data(), lev.b.data(), true);
+    }
+
+    Level& crse = m_levels[ilev+1];
+    residual(lev.A, lev.x.data(), lev.b.data(), lev.r.data());
+    spmv(lev.R, lev.r.data(), crse.b.data());
+
+    vcycle(ilev+1);
+
+    for (int i = 0; i < n; ++i) {
+        for (int k = lev.P.rowptr[i]; k < lev.P.rowptr[i+1]; ++k) {
+            lev.x[i] += lev.P.val[k]*crse.x[lev.P.col[k]];
+        }
+    }
+
+    for (int i = 0; i < nsmooth; ++i) {
+        gauss_seidel(lev.A, lev.dinv, lev.x.data(), lev.b.data(), false);
+    }
+}
+
+void
+MLAMG::precond (Vector<Real>& z, Vector<Real> const& r)
+{
+    Level& lev = m_levels[0];
+    std::copy(r.begin(), r.end(), lev.b.begin());
+    vcycle(0);
+    std::copy(lev.x.begin(), lev.x.end(), z.begin());
+}
+
+void
+MLAMG::gather (Vector<Real>& v, const MultiFab& mf) const
+{
+    const int myproc = ParallelContext::MyProcSub();
+    const int nlocal = m_counts[myproc];
+    Gpu::DeviceVector<Real> dbuf(nlocal);
+    Real* p = dbuf.data();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real const> const& a = mf.const_array(mfi);
+        Real* pb = p + (m_box_offset[mfi.index()] - m_displs[myproc]);
+        const auto lo = amrex::lbound(bx);
+        const auto len = amrex::length(bx);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            pb[(i-lo.x) + (j-lo.y)*len.x + (k-lo.z)*len.x*len.y] = a(i,j,k);
+        });
+    }
+
+    v.resize(m_levels[0].A.nrows);
+#ifdef BL_USE_MPI
+    Vector<Real> sendbuf(nlocal);
+    Gpu::copy(Gpu::deviceToHost, dbuf.begin(), dbuf.end(), sendbuf.begin());
+    BL_MPI_REQUIRE( MPI_Allgatherv(sendbuf.data(), nlocal,
+                                   ParallelDescriptor::Mpi_typemap<Real>::type(),
+                                   v.data(), m_counts.data(), m_displs.data(),
+                                   ParallelDescriptor::Mpi_typemap<Real>::type(),
+                                   ParallelContext::CommunicatorSub()) );
+#else
+    Gpu::copy(Gpu::deviceToHost, dbuf.begin(), dbuf.end(), v.begin());
+#endif
+}
+
+void
+MLAMG::scatter (MultiFab& mf, Vector<Real> const& v) const
+{
+    const int myproc = ParallelContext::MyProcSub();
+    const int nlocal = m_counts[myproc];
+    Gpu::DeviceVector<Real> dbuf(nlocal);
+    Gpu::copy(Gpu::hostToDevice, v.begin()+m_displs[myproc], v.begin()+m_displs[myproc]+nlocal,
+              dbuf.begin());
+    Real const* p = dbuf.data();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = mf.array(mfi);
+        Real const* pb = p + (m_box_offset[mfi.index()] - m_displs[myproc]);
+        const auto lo = amrex::lbound(bx);
+        const auto len = amrex::length(bx);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            a(i,j,k) = pb[(i-lo.x) + (j-lo.y)*len.x + (k-lo.z)*len.x*len.y];
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+int
+MLAMG::solve (MultiFab& sol, const MultiFab& rhs, Real eps_rel, Real eps_abs)
+{
+    BL_PROFILE("MLAMG::solve()");
+
+    if (m_levels.empty()) { setup(); }
+
+    Matrix const& A = m_levels[0].A;
+    const int n = A.nrows;
+
+    auto dot = [n] (Vector<Real> const& a, Vector<Real> const& b) {
+        Real s = 0;
+        for (int i = 0; i < n; ++i) { s += a[i]*b[i]; }
+        return s;
+    };
+    auto norm_inf = [n] (Vector<Real> const& a) {
+        Real s = 0;
+        for (int i = 0; i < n; ++i) { s = amrex::max(s, std::abs(a[i])); }
+        return s;
+    };
+
+    // The initial guess is zero.
+    Vector<Real> r;
+    gather(r, rhs);
+    Vector<Real> x(n, 0), rh(r), p(n, 0), ph(n), v(n, 0), s(n), sh(n), t(n);
+
+    Real rnorm = norm_inf(r);
+    const Real rnorm0 = rnorm;
+
+    if (verbose > 0) {
+        amrex::Print() << "MLAMG: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+
+    int ret = 0;
+    iter = 1;
+    Real rho_1 = 0, alpha = 0, omega = 0;
+
+    if (rnorm0 == 0 || rnorm0 < eps_abs) {
+        iter = 0;
+        scatter(sol, x);
+        return ret;
+    }
+
+    for (; iter <= maxiter; ++iter)
+    {
+        const Real rho = dot(rh, r);
+        if (rho == 0) { ret = 1; break; }
+        if (iter == 1) {
+            p = r;
+        } else {
+            const Real beta = (rho/rho_1)*(alpha/omega);
+            for (int i = 0; i < n; ++i) { p[i] = r[i] + beta*(p[i] - omega*v[i]); }
+        }
+        precond(ph, p);
+        spmv(A, ph.data(), v.data());
+
+        const Real rhTv = dot(rh, v);
+        if (rhTv == 0) { ret = 2; break; }
+        alpha = rho/rhTv;
+        for (int i = 0; i < n; ++i) {
+            x[i] += alpha*ph[i];
+            s[i] = r[i] - alpha*v[i];
+        }
+
+        rnorm = norm_inf(s);
+        if (verbose > 2) {
+            amrex::Print() << "MLAMG: Half Iter " << std::setw(11) << iter
+                           << " rel. err. " << rnorm/rnorm0 << '\n';
+        }
+        if (rnorm < eps_rel*rnorm0 || rnorm < eps_abs) { break; }
+
+        precond(sh, s);
+        spmv(A, sh.data(), t.data());
+
+        const Real tt = dot(t, t);
+        if (tt == 0) { ret = 3; break; }
+        omega = dot(t, s)/tt;
+        for (int i = 0; i < n; ++i) {
+            x[i] += omega*sh[i];
+            r[i] = s[i] - omega*t[i];
+        }
+
+        rnorm = norm_inf(r);
+        if (verbose > 2) {
+            amrex::Print() << "MLAMG: Iteration " << std::setw(11) << iter
+                           << " rel. err. " << rnorm/rnorm0 << '\n';
+        }
+        if (rnorm < eps_rel*rnorm0 || rnorm < eps_abs) { break; }
+
+        if (omega == 0) { ret = 4; break; }
+        rho_1 = rho;
+    }
+
+    if (verbose > 0) {
+        amrex::Print() << "MLAMG: Final: Iteration " << std::setw(4) << iter
+                       << " rel. err. " << rnorm/rnorm0 << '\n';
+    }
+
+    if (ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs) {
+        if (verbose > 0) {
+            amrex::Warning("MLAMG: failed to converge!");
+        }
+        ret = 8;
+    }
+
+    if (!((ret == 0 || ret == 8) && rnorm < rnorm0)) {
+        std::fill(x.begin(), x.end(), Real(0.));
+    }
+    scatter(sol, x);
+
+    return ret;
+}
+
+}
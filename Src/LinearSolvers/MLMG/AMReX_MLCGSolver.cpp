@@ -49,6 +49,43 @@ sxay (MultiFab&       ss,
     sxay(ss,xx,a,yy,0,nghost);
 }
 
+// Non-blocking global reduction of a few local values.  The values are
+// reduced in place, and are valid after wait() returns.
+class NonBlockingReduce
+{
+public:
+    NonBlockingReduce (detail::ReduceOp op, Real* v, int n, MPI_Comm comm)
+    {
+#ifdef BL_USE_MPI
+        BL_MPI_REQUIRE( MPI_Iallreduce(MPI_IN_PLACE, v, n,
+                                       ParallelDescriptor::Mpi_typemap<Real>::type(),
+                                       detail::mpi_ops[static_cast<int>(op)], comm, &m_req) );
+#else
+        amrex::ignore_unused(op,v,n,comm);
+#endif
+    }
+
+    NonBlockingReduce (const NonBlockingReduce&) = delete;
+    NonBlockingReduce& operator= (const NonBlockingReduce&) = delete;
+
+    ~NonBlockingReduce () { wait(); }
+
+    void wait ()
+    {
+#ifdef BL_USE_MPI
+        if (m_req != MPI_REQUEST_NULL) {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            BL_MPI_REQUIRE( MPI_Wait(&m_req, MPI_STATUS_IGNORE) );
+        }
+#endif
+    }
+
+private:
+#ifdef BL_USE_MPI
+    MPI_Request m_req = MPI_REQUEST_NULL;
+#endif
+};
+
 }
 
 MLCGSolver::MLCGSolver (MLMG* a_mlmg, MLLinOp& _lp, Type _typ)
@@ -73,6 +110,10 @@ MLCGSolver::solve (MultiFab&       sol,
 {
     if (solver_type == Type::BiCGStab) {
         return solve_bicgstab(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::PipeCG) {
+        return solve_pipecg(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::PipeBiCGStab) {
+        return solve_pipebicgstab(sol,rhs,eps_rel,eps_abs);
     } else {
         return solve_cg(sol,rhs,eps_rel,eps_abs);
     }
@@ -403,6 +444,391 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     return ret;
 }
 
+int
+MLCGSolver::solve_pipecg (MultiFab&       sol,
+                          const MultiFab& rhs,
+                          Real            eps_rel,
+                          Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipecg");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // w is the operand of Lp.apply and needs ghost cells.
+    MultiFab w(ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    w.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    r.setVal(0.0);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    Real       rnorm    = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeCG: Initial error (error0) :        " << rnorm0 << '\n';
+    }
+
+    int  ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 ) {
+            amrex::Print() << "MLCGSolver_PipeCG: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    Lp.apply(amrlev, mglev, w, r, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+    Real gamma_1 = 0, alpha = 0;
+
+    for (; iter <= maxiter; ++iter)
+    {
+        //
+        // The reductions for gamma = (r,r), delta = (w,r) and the norm of
+        // r overlap with q = A w.
+        //
+        Real dots[2] = { dotxy(r,r,true), dotxy(w,r,true) };
+        NonBlockingReduce dots_reduce(detail::ReduceOp::sum, dots, 2, Lp.BottomCommunicator());
+        Real rnorm_cur = norm_inf(r,true);
+        NonBlockingReduce norm_reduce(detail::ReduceOp::max, &rnorm_cur, 1, Lp.BottomCommunicator());
+
+        Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+        dots_reduce.wait();
+        norm_reduce.wait();
+        const Real gamma = dots[0];
+        const Real delta = dots[1];
+
+        if ( iter > 1 )
+        {
+            rnorm = rnorm_cur;
+
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_PipeCG:   Iteration"
+                               << std::setw(4) << iter-1
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) { --iter; break; }
+        }
+
+        if ( gamma == 0 )
+        {
+            ret = 1; break;
+        }
+
+        Real beta, denom;
+        if (iter == 1)
+        {
+            beta = 0;
+            denom = delta;
+        }
+        else
+        {
+            beta = gamma/gamma_1;
+            denom = delta - beta*gamma/alpha;
+        }
+        if ( denom != Real(0.0) )
+        {
+            alpha = gamma/denom;
+        }
+        else
+        {
+            ret = 1; break;
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipeCG:"
+                           << " iter " << iter
+                           << " gamma " << gamma
+                           << " alpha " << alpha << '\n';
+        }
+
+        if (iter == 1)
+        {
+            MultiFab::Copy(z,q,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(z, q, beta, z, nghost);
+            sxay(s, w, beta, s, nghost);
+            sxay(p, r, beta, p, nghost);
+        }
+        sxay(sol, sol,  alpha, p, nghost);
+        sxay(  r,   r, -alpha, s, nghost);
+        sxay(  w,   w, -alpha, z, nghost);
+
+        gamma_1 = gamma;
+    }
+
+    if ( iter > maxiter )
+    {
+        iter = maxiter;
+        rnorm = norm_inf(r);
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeCG: Final Iteration"
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipeCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_pipebicgstab (MultiFab&       sol,
+                                const MultiFab& rhs,
+                                Real            eps_rel,
+                                Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipebicgstab");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // r, w and z are the operands of Lp.apply and need ghost cells.
+    MultiFab r(ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    MultiFab w(ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    MultiFab z(ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    r.setVal(0.0);
+    w.setVal(0.0);
+    z.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab rh   (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab y    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab t    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab v    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    p.setVal(0.0);
+    s.setVal(0.0);
+    v.setVal(0.0);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+
+    sol.setVal(0);
+
+    Real rnorm = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeBiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+    int ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 )
+        {
+            amrex::Print() << "MLCGSolver_PipeBiCGStab: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    Lp.apply(amrlev, mglev, w, r, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    Lp.normalize(amrlev, mglev, w);
+    Lp.apply(amrlev, mglev, t, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    Lp.normalize(amrlev, mglev, t);
+
+    Real rho = dotxy(rh,r);
+    Real alpha = 0;
+    {
+        const Real rhTw = dotxy(rh,w);
+        if ( rho == 0 )
+        {
+            ret = 1;
+        }
+        else if ( rhTw == 0 )
+        {
+            ret = 2;
+        }
+        else
+        {
+            alpha = rho/rhTw;
+        }
+    }
+    Real beta = 0, omega = 0;
+
+    for (; ret == 0 && iter <= maxiter; ++iter)
+    {
+        if ( iter > 1 )
+        {
+            sxay(p, p, -omega, s, nghost);
+            sxay(p, r,   beta, p, nghost);
+            sxay(s, s, -omega, z, nghost);
+            sxay(s, w,   beta, s, nghost);
+            sxay(z, z, -omega, v, nghost);
+            sxay(z, t,   beta, z, nghost);
+        }
+        else
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(z,t,0,0,ncomp,nghost);
+        }
+        sxay(q, r, -alpha, s, nghost);
+        sxay(y, w, -alpha, z, nghost);
+
+        //
+        // The reduction for (q,y) and (y,y) overlaps with v = A z.
+        //
+        Real qy_yy[2] = { dotxy(q,y,true), dotxy(y,y,true) };
+        {
+            NonBlockingReduce reduce(detail::ReduceOp::sum, qy_yy, 2, Lp.BottomCommunicator());
+            Lp.apply(amrlev, mglev, v, z, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+            Lp.normalize(amrlev, mglev, v);
+        }
+
+        if ( qy_yy[1] != Real(0.0) )
+        {
+            omega = qy_yy[0]/qy_yy[1];
+        }
+        else
+        {
+            ret = 3; break;
+        }
+
+        sxay(sol, sol, alpha, p, nghost);
+        sxay(sol, sol, omega, q, nghost);
+        sxay(r, q, -omega, y, nghost);
+        sxay(t, t, -alpha, v, nghost);
+        sxay(w, y, -omega, t, nghost);
+
+        //
+        // The reductions for the next alpha and beta and the norm of r
+        // overlap with t = A w.
+        //
+        Real dots[4] = { dotxy(rh,r,true), dotxy(rh,w,true), dotxy(rh,s,true), dotxy(rh,z,true) };
+        rnorm = norm_inf(r,true);
+        {
+            NonBlockingReduce dots_reduce(detail::ReduceOp::sum, dots, 4, Lp.BottomCommunicator());
+            NonBlockingReduce norm_reduce(detail::ReduceOp::max, &rnorm, 1, Lp.BottomCommunicator());
+            Lp.apply(amrlev, mglev, t, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+            Lp.normalize(amrlev, mglev, t);
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipeBiCGStab: Iteration "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+
+        if ( omega == 0 )
+        {
+            ret = 4; break;
+        }
+
+        const Real rho_1 = rho;
+        rho = dots[0];
+        if ( rho == 0 )
+        {
+            ret = 1; break;
+        }
+        beta = (rho/rho_1)*(alpha/omega);
+        const Real denom = dots[1] + beta*dots[2] - beta*omega*dots[3];
+        if ( denom != Real(0.0) )
+        {
+            alpha = rho/denom;
+        }
+        else
+        {
+            ret = 2; break;
+        }
+    }
+
+    if ( iter > maxiter ) { iter = maxiter; }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeBiCGStab: Final: Iteration "
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipeBiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
 Real
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
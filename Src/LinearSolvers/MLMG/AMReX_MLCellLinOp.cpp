@@ -489,6 +489,10 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
     BL_PROFILE("MLCellLinOp::smooth()");
+    if (m_smoother == LinOpSmoother::chebyshev) {
+        chebyshevSmooth(amrlev, mglev, sol, rhs);
+        return;
+    }
     for (int redblack = 0; redblack < 2; ++redblack)
     {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
@@ -501,6 +505,138 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
     }
 }
 
+void
+MLCellLinOp::chebyshevSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs) const
+{
+    BL_PROFILE("MLCellLinOp::chebyshevSmooth()");
+
+    // Target the eigenvalues of D^{-1} A with large magnitudes.
+    const Real lambda_max = Real(1.1)*m_cheby_lambda_max[amrlev][mglev];
+    const Real lambda_min = Real(0.1)*m_cheby_lambda_max[amrlev][mglev];
+    const Real theta = Real(0.5)*(lambda_max+lambda_min);
+    const Real delta = Real(0.5)*(lambda_max-lambda_min);
+    const Real sigma = theta/delta;
+    Real rho = Real(1.0)/sigma;
+
+    const int ncomp = getNComp();
+    MultiFab r(sol.boxArray(), sol.DistributionMap(), ncomp, 0, MFInfo(), *m_factory[amrlev][mglev]);
+    MultiFab d(sol.boxArray(), sol.DistributionMap(), ncomp, sol.nGrowVect(), MFInfo(),
+               *m_factory[amrlev][mglev]);
+    d.setBndry(0.0);
+    MultiFab const& dinv = m_cheby_dinv[amrlev][mglev];
+
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+
+    // r = rhs - A sol, d = D^{-1} r / theta, sol += d
+    apply(amrlev, mglev, r, sol, BCMode::Homogeneous, StateMode::Correction);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(r, mfi_info); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<Real> const& ra = r.array(mfi);
+        Array4<Real> const& da = d.array(mfi);
+        Array4<Real> const& xa = sol.array(mfi);
+        Array4<Real const> const& ba = rhs.const_array(mfi);
+        Array4<Real const> const& dinva = dinv.const_array(mfi);
+        const Real thetainv = Real(1.0)/theta;
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, ncomp, i, j, k, n,
+        {
+            ra(i,j,k,n) = ba(i,j,k,n) - ra(i,j,k,n);
+            da(i,j,k,n) = thetainv*dinva(i,j,k,n)*ra(i,j,k,n);
+            xa(i,j,k,n) += da(i,j,k,n);
+        });
+    }
+
+    MultiFab ad;
+    if (m_chebyshev_degree > 1) {
+        ad.define(sol.boxArray(), sol.DistributionMap(), ncomp, 0, MFInfo(), *m_factory[amrlev][mglev]);
+    }
+    for (int deg = 1; deg < m_chebyshev_degree; ++deg) {
+        // r -= A d, d = c1 d + c2 D^{-1} r, sol += d
+        apply(amrlev, mglev, ad, d, BCMode::Homogeneous, StateMode::Correction);
+        const Real rho_new = Real(1.0)/(Real(2.0)*sigma-rho);
+        const Real c1 = rho_new*rho;
+        const Real c2 = Real(2.0)*rho_new/delta;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(r, mfi_info); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const& ra = r.array(mfi);
+            Array4<Real> const& da = d.array(mfi);
+            Array4<Real> const& xa = sol.array(mfi);
+            Array4<Real const> const& ada = ad.const_array(mfi);
+            Array4<Real const> const& dinva = dinv.const_array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, ncomp, i, j, k, n,
+            {
+                ra(i,j,k,n) -= ada(i,j,k,n);
+                da(i,j,k,n) = c1*da(i,j,k,n) + c2*dinva(i,j,k,n)*ra(i,j,k,n);
+                xa(i,j,k,n) += da(i,j,k,n);
+            });
+        }
+        rho = rho_new;
+    }
+}
+
+void
+MLCellLinOp::beginPrecondBC ()
+{
+    BL_PROFILE("MLCellLinOp::beginPrecondBC()");
+
+    MLLinOp::beginPrecondBC();
+
+    if (m_bndry_sol_zero.empty())
+    {
+        const int ncomp = getNComp();
+        IntVect ng(1);
+        if (hasHiddenDimension()) ng[hiddenDirection()] = 0;
+
+        m_bndry_sol_zero.resize(m_num_amr_levels);
+        for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+        {
+            m_bndry_sol_zero[amrlev] = std::make_unique<MLMGBndry>(m_grids[amrlev][0],
+                                                                   m_dmap[amrlev][0],
+                                                                   ncomp, m_geom[amrlev][0]);
+            MultiFab zero(m_grids[amrlev][0], m_dmap[amrlev][0], ncomp, ng);
+            zero.setVal(0.0);
+
+            int br_ref_ratio = -1;
+            if (amrlev == 0 && needsCoarseDataForBC())
+            {
+                br_ref_ratio = m_coarse_data_crse_ratio > 0 ? m_coarse_data_crse_ratio : 2;
+                BoxArray cba = m_grids[amrlev][0];
+                cba.coarsen(br_ref_ratio);
+                BndryRegister crse_zero(cba, m_dmap[amrlev][0], 0, 1, 2, ncomp);
+                crse_zero.setVal(0.0);
+                m_bndry_sol_zero[amrlev]->setBndryValues(crse_zero, 0, zero, 0, 0, ncomp,
+                                                         IntVect(br_ref_ratio));
+                br_ref_ratio = m_coarse_data_crse_ratio;
+            }
+            else
+            {
+                m_bndry_sol_zero[amrlev]->setPhysBndryValues(zero, 0, 0, ncomp);
+                br_ref_ratio = (amrlev == 0) ? 1 : m_amr_ref_ratio[amrlev-1];
+            }
+            m_bndry_sol_zero[amrlev]->setLOBndryConds(m_lobc, m_hibc, br_ref_ratio,
+                                                      m_coarse_bc_loc);
+        }
+    }
+
+    std::swap(m_bndry_sol, m_bndry_sol_zero);
+}
+
+void
+MLCellLinOp::endPrecondBC ()
+{
+    std::swap(m_bndry_sol, m_bndry_sol_zero);
+
+    MLLinOp::endPrecondBC();
+}
+
 void
 MLCellLinOp::updateSolBC (int amrlev, const MultiFab& crse_bcdata) const
 {
@@ -1246,6 +1382,86 @@ MLCellLinOp::prepareForSolve ()
     }
 }
 
+void
+MLCellLinOp::prepareSmoother ()
+{
+    m_cheby_lambda_max.clear();
+    m_cheby_dinv.clear();
+    if (m_smoother != LinOpSmoother::chebyshev) return;
+
+    BL_PROFILE("MLCellLinOp::prepareSmoother()");
+
+    // Power iterations for the eigenvalue of D^{-1} A with the largest
+    // magnitude
+    constexpr int niters = 20;
+    const int ncomp = getNComp();
+    m_cheby_lambda_max.resize(m_num_amr_levels);
+    m_cheby_dinv.resize(m_num_amr_levels);
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        m_cheby_lambda_max[amrlev].resize(m_num_mg_levels[amrlev], Real(0.0));
+        m_cheby_dinv[amrlev].resize(m_num_mg_levels[amrlev]);
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
+            IntVect ng(1);
+            if (hasHiddenDimension()) ng[hiddenDirection()] = 0;
+            MultiFab x(m_grids[amrlev][mglev], m_dmap[amrlev][mglev], ncomp, ng, MFInfo(),
+                       *m_factory[amrlev][mglev]);
+            MultiFab y(m_grids[amrlev][mglev], m_dmap[amrlev][mglev], ncomp, 0, MFInfo(),
+                       *m_factory[amrlev][mglev]);
+            x.setBndry(0.0);
+
+            // Start from pseudo-random values that do not depend on the
+            // domain decomposition.
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            for (MFIter mfi(x,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                Array4<Real> const& xa = x.array(mfi);
+                AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, ncomp, i, j, k, n,
+                {
+                    unsigned int h = static_cast<unsigned int>(i)*73856093u
+                        ^ static_cast<unsigned int>(j)*19349663u
+                        ^ static_cast<unsigned int>(k)*83492791u
+                        ^ static_cast<unsigned int>(n)*2654435761u;
+                    h = (h ^ (h >> 15)) * 2246822519u;
+                    h = h ^ (h >> 13);
+                    xa(i,j,k,n) = Real(h & 0xFFFFFFu) / Real(0xFFFFFFu) - Real(0.5);
+                });
+            }
+
+            Real xnorm = std::sqrt(MultiFab::Dot(x, 0, x, 0, ncomp, 0));
+            Real lambda = Real(0.0);
+            for (int iter = 0; iter < niters && xnorm > Real(0.0); ++iter) {
+                apply(amrlev, mglev, y, x, BCMode::Homogeneous, StateMode::Correction);
+                normalize(amrlev, mglev, y);
+                const Real ynorm = std::sqrt(MultiFab::Dot(y, 0, y, 0, ncomp, 0));
+                // Some operators (e.g., MLPoisson) are negative definite.
+                const Real xdoty = MultiFab::Dot(x, 0, y, 0, ncomp, 0);
+                lambda = std::copysign(ynorm / xnorm, xdoty);
+                if (ynorm == Real(0.0)) break;
+                MultiFab::Copy(x, y, 0, 0, ncomp, 0);
+                x.mult(Real(1.0)/ynorm, 0, ncomp, 0);
+                xnorm = Real(1.0);
+            }
+            m_cheby_lambda_max[amrlev][mglev] = lambda;
+
+            // The operators scale by the inverse of the diagonal in normalize.
+            m_cheby_dinv[amrlev][mglev].define(m_grids[amrlev][mglev], m_dmap[amrlev][mglev],
+                                               ncomp, 0, MFInfo(), *m_factory[amrlev][mglev]);
+            m_cheby_dinv[amrlev][mglev].setVal(Real(1.0));
+            normalize(amrlev, mglev, m_cheby_dinv[amrlev][mglev]);
+
+            if (verbose >= 2) {
+                amrex::Print() << "MLCellLinOp::prepareSmoother: Chebyshev eigenvalue estimate "
+                               << lambda << " on AMR level " << amrlev << " MG level " << mglev << "\n";
+            }
+        }
+    }
+}
+
 Real
 MLCellLinOp::xdoty (int /*amrlev*/, int /*mglev*/, const MultiFab& x, const MultiFab& y, bool local) const
 {
@@ -123,6 +123,7 @@ MLEBABecLap::setScalars (Real a, Real b)
 void
 MLEBABecLap::setACoeffs (int amrlev, const MultiFab& alpha)
 {
+    if (isFrozenAndUnchanged(m_a_coeffs[amrlev][0], 0, alpha, 0, 1)) { return; }
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
     m_needs_update = true;
 }
@@ -130,6 +131,7 @@ MLEBABecLap::setACoeffs (int amrlev, const MultiFab& alpha)
 void
 MLEBABecLap::setACoeffs (int amrlev, Real alpha)
 {
+    if (isFrozenAndUnchanged(m_a_coeffs[amrlev][0], 0, alpha, 1)) { return; }
     m_a_coeffs[amrlev][0].setVal(alpha);
     m_needs_update = true;
 }
@@ -141,9 +143,19 @@ MLEBABecLap::setBCoeffs (int amrlev, const Array<MultiFab const*,AMREX_SPACEDIM>
     const int ncomp = getNComp();
     const int beta_ncomp = beta[0]->nComp();
 
+    AMREX_ALWAYS_ASSERT(beta_ncomp == 1 || beta_ncomp == ncomp);
+
+    bool unchanged = (m_beta_loc == a_beta_loc);
+    for (int idim = 0; idim < AMREX_SPACEDIM && unchanged; ++idim) {
+        for (int icomp = 0; icomp < ncomp && unchanged; ++icomp) {
+            const int scomp = (beta_ncomp == ncomp) ? icomp : 0;
+            unchanged = isFrozenAndUnchanged(m_b_coeffs[amrlev][0][idim], icomp, *beta[idim], scomp, 1);
+        }
+    }
+    if (unchanged) { return; }
+
     m_beta_loc     = a_beta_loc;
 
-    AMREX_ALWAYS_ASSERT(beta_ncomp == 1 || beta_ncomp == ncomp);
     if (beta[0]->nComp() == ncomp) {
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
             for (int icomp = 0; icomp < ncomp; ++icomp) {
@@ -163,6 +175,11 @@ MLEBABecLap::setBCoeffs (int amrlev, const Array<MultiFab const*,AMREX_SPACEDIM>
 void
 MLEBABecLap::setBCoeffs (int amrlev, Real beta)
 {
+    bool unchanged = (m_beta_loc == Location::FaceCenter);
+    for (int idim = 0; idim < AMREX_SPACEDIM && unchanged; ++idim) {
+        unchanged = isFrozenAndUnchanged(m_b_coeffs[amrlev][0][idim], 0, beta, getNComp());
+    }
+    if (unchanged) { return; }
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         m_b_coeffs[amrlev][0][idim].setVal(beta);
     }
@@ -174,6 +191,13 @@ void
 MLEBABecLap::setBCoeffs (int amrlev, Vector<Real> const& beta)
 {
     const int ncomp = getNComp();
+    bool unchanged = (m_beta_loc == Location::FaceCenter);
+    for (int idim = 0; idim < AMREX_SPACEDIM && unchanged; ++idim) {
+        for (int icomp = 0; icomp < ncomp && unchanged; ++icomp) {
+            unchanged = isFrozenAndUnchanged(m_b_coeffs[amrlev][0][idim], icomp, beta[icomp], 1);
+        }
+    }
+    if (unchanged) { return; }
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         for (int icomp = 0; icomp < ncomp; ++icomp) {
             m_b_coeffs[amrlev][0][idim].setVal(beta[icomp]);
@@ -1012,7 +1036,7 @@ MLEBABecLap::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
 
     int m_is_inhomog = bc_mode == BCMode::Inhomogeneous;
     int flagbc = m_is_inhomog;
-    m_is_eb_inhomog = s_mode == StateMode::Solution;
+    m_is_eb_inhomog = s_mode == StateMode::Solution && !m_precond_mode;
     const int imaxorder = maxorder;
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(imaxorder <= 4, "MLEBABecLap::applyBC: maxorder too high");
 
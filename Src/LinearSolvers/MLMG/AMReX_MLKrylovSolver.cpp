@@ -0,0 +1,323 @@
+#include <AMReX_MLKrylovSolver.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_ParallelReduce.H>
+
+#include <cmath>
+#include <iomanip>
+
+namespace amrex {
+
+MLKrylovSolver::MLKrylovSolver (MLMG& a_mlmg, Type a_type)
+    : mlmg(a_mlmg), linop(a_mlmg.linop), solver_type(a_type)
+{}
+
+Real
+MLKrylovSolver::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs,
+                       Real a_tol_rel, Real a_tol_abs)
+{
+    BL_PROFILE("MLKrylovSolver::solve()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(linop.isCellCentered(),
+                                     "MLKrylovSolver: only cell-centered operators are supported");
+
+    namrlevs = mlmg.numAMRLevels();
+    ncomp = linop.getNComp();
+    iter = 0;
+
+    const auto& amrrr = linop.AMRRefRatio();
+    m_fine_mask.clear();
+    m_fine_mask.resize(namrlevs);
+    m_weight.assign(namrlevs, Real(1.0));
+    for (int alev = 0; alev < namrlevs-1; ++alev) {
+        m_fine_mask[alev] = amrex::makeFineMask(a_rhs[alev]->boxArray(),
+                                                a_rhs[alev]->DistributionMap(),
+                                                a_rhs[alev+1]->boxArray(),
+                                                IntVect(amrrr[alev]), 1, 0);
+        m_weight[alev+1] = m_weight[alev] / Real(AMREX_D_TERM(amrrr[alev],*amrrr[alev],*amrrr[alev]));
+    }
+
+    Vector<MultiFab> r;
+    makeVec(r, 0);
+    computeResidual(r, a_sol, a_rhs);
+
+    Real rhsnorm0 = dotxy(a_rhs, a_rhs);
+    Real resnorm0 = dotxy(amrex::GetVecOfConstPtrs(r), amrex::GetVecOfConstPtrs(r));
+    ParallelAllReduce::Sum<Real>({rhsnorm0, resnorm0}, ParallelContext::CommunicatorSub());
+    rhsnorm0 = std::sqrt(rhsnorm0);
+    resnorm0 = std::sqrt(resnorm0);
+
+    if (verbose >= 1) {
+        amrex::Print() << "MLKrylovSolver: Initial rhs               = " << rhsnorm0 << "\n"
+                       << "MLKrylovSolver: Initial residual (resid0) = " << resnorm0 << "\n";
+    }
+
+    const Real max_norm = std::max(rhsnorm0, resnorm0);
+    const Real res_target = std::max(a_tol_abs, std::max(a_tol_rel,Real(1.e-16))*max_norm);
+
+    Real resnorm = resnorm0;
+    if (resnorm0 <= res_target) {
+        if (verbose >= 1) {
+            amrex::Print() << "MLKrylovSolver: No iterations needed\n";
+        }
+        return resnorm0;
+    }
+
+    int status;
+    if (solver_type == Type::FGMRES) {
+        status = solve_fgmres(a_sol, a_rhs, r, resnorm, res_target);
+    } else {
+        status = solve_cg(a_sol, a_rhs, r, resnorm, res_target);
+    }
+
+    if (status != 0) {
+        if (verbose > 0) {
+            amrex::Print() << "MLKrylovSolver: Failed to converge after " << iter << " iterations."
+                           << " resid, resid/resid0 = " << resnorm << ", "
+                           << resnorm/resnorm0 << "\n";
+        }
+        amrex::Abort("MLKrylovSolver failed");
+    }
+
+    if (verbose >= 1) {
+        amrex::Print() << "MLKrylovSolver: Final Iter. " << iter
+                       << " resid, resid/resid0 = " << resnorm << ", "
+                       << resnorm/resnorm0 << "\n";
+    }
+
+    return resnorm;
+}
+
+// Right preconditioned flexible GMRES(m) of Saad.  The Krylov basis of
+// the preconditioned vectors is kept, so the preconditioner may change
+// from one iteration to the next.
+int
+MLKrylovSolver::solve_fgmres (const Vector<MultiFab*>& sol, const Vector<MultiFab const*>& rhs,
+                              Vector<MultiFab>& r, Real& resnorm, Real res_target)
+{
+    BL_PROFILE("MLKrylovSolver::fgmres()");
+
+    const int m = std::max(restart, 1);
+    Vector<Vector<MultiFab> > V(m+1);
+    Vector<Vector<MultiFab> > Z(m);
+    Vector<MultiFab> w;
+    makeVec(w, 0);
+
+    Vector<Real> H((m+1)*m);
+    Vector<Real> cs(m), sn(m), g(m+1), y(m);
+    auto h = [&] (int i, int j) -> Real& { return H[i+j*(m+1)]; };
+
+    while (true)
+    {
+        if (V[0].empty()) { makeVec(V[0], 0); }
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            MultiFab::Copy(V[0][alev], r[alev], 0, 0, ncomp, 0);
+            V[0][alev].mult(Real(1.0)/resnorm);
+        }
+        std::fill(g.begin(), g.end(), Real(0.0));
+        g[0] = resnorm;
+
+        int j = 0;
+        while (j < m && iter < maxiter)
+        {
+            if (Z[j].empty()) { makeVec(Z[j], 1); }
+            mlmg.precond(amrex::GetVecOfPtrs(Z[j]), amrex::GetVecOfConstPtrs(V[j]), precond_iters);
+            mlmg.applyPrecond(amrex::GetVecOfPtrs(w), amrex::GetVecOfPtrs(Z[j]));
+
+            // Modified Gram-Schmidt
+            for (int i = 0; i <= j; ++i) {
+                Real hij = dotxy(w, V[i]);
+                ParallelAllReduce::Sum(hij, ParallelContext::CommunicatorSub());
+                h(i,j) = hij;
+                for (int alev = 0; alev < namrlevs; ++alev) {
+                    MultiFab::Saxpy(w[alev], -hij, V[i][alev], 0, 0, ncomp, 0);
+                }
+            }
+            const Real hnorm = norm2(w);
+            h(j+1,j) = hnorm;
+            if (hnorm > Real(0.0)) {
+                if (V[j+1].empty()) { makeVec(V[j+1], 0); }
+                for (int alev = 0; alev < namrlevs; ++alev) {
+                    MultiFab::Copy(V[j+1][alev], w[alev], 0, 0, ncomp, 0);
+                    V[j+1][alev].mult(Real(1.0)/hnorm);
+                }
+            }
+
+            // Givens rotations
+            for (int i = 0; i < j; ++i) {
+                const Real t = cs[i]*h(i,j) + sn[i]*h(i+1,j);
+                h(i+1,j) = -sn[i]*h(i,j) + cs[i]*h(i+1,j);
+                h(i,j) = t;
+            }
+            const Real d = std::sqrt(h(j,j)*h(j,j) + h(j+1,j)*h(j+1,j));
+            cs[j] = h(j,j) / d;
+            sn[j] = h(j+1,j) / d;
+            h(j,j) = d;
+            h(j+1,j) = Real(0.0);
+            g[j+1] = -sn[j]*g[j];
+            g[j] = cs[j]*g[j];
+
+            ++j;
+            ++iter;
+            resnorm = std::abs(g[j]);
+            if (verbose >= 2) {
+                amrex::Print() << "MLKrylovSolver: FGMRES iteration " << std::setw(3) << iter
+                               << " resid = " << resnorm << "\n";
+            }
+            if (resnorm <= res_target || hnorm == Real(0.0)) { break; }
+        }
+
+        for (int i = j-1; i >= 0; --i) {
+            Real t = g[i];
+            for (int k = i+1; k < j; ++k) {
+                t -= h(i,k)*y[k];
+            }
+            y[i] = t / h(i,i);
+        }
+        for (int i = 0; i < j; ++i) {
+            for (int alev = 0; alev < namrlevs; ++alev) {
+                MultiFab::Saxpy(*sol[alev], y[i], Z[i][alev], 0, 0, ncomp, 0);
+            }
+        }
+
+        // The true residual decides the convergence.
+        computeResidual(r, sol, rhs);
+        resnorm = norm2(r);
+        if (resnorm <= res_target) {
+            return 0;
+        } else if (iter >= maxiter) {
+            return 1;
+        }
+    }
+}
+
+// Flexible preconditioned CG with the Polak-Ribiere formula for beta.
+int
+MLKrylovSolver::solve_cg (const Vector<MultiFab*>& sol, const Vector<MultiFab const*>& rhs,
+                          Vector<MultiFab>& r, Real& resnorm, Real res_target)
+{
+    BL_PROFILE("MLKrylovSolver::cg()");
+
+    Vector<MultiFab> z, p, q;
+    makeVec(z, 1);
+    makeVec(p, 1);
+    makeVec(q, 0);
+
+    mlmg.precond(amrex::GetVecOfPtrs(z), amrex::GetVecOfConstPtrs(r), precond_iters);
+    Real rz = dotxy(r, z);
+    ParallelAllReduce::Sum(rz, ParallelContext::CommunicatorSub());
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        MultiFab::Copy(p[alev], z[alev], 0, 0, ncomp, 0);
+    }
+
+    int status = 1;
+    while (iter < maxiter)
+    {
+        mlmg.applyPrecond(amrex::GetVecOfPtrs(q), amrex::GetVecOfPtrs(p));
+        Real pq = dotxy(p, q);
+        ParallelAllReduce::Sum(pq, ParallelContext::CommunicatorSub());
+        if (pq == Real(0.0)) { break; }
+
+        const Real alpha = rz / pq;
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            MultiFab::Saxpy(*sol[alev],  alpha, p[alev], 0, 0, ncomp, 0);
+            MultiFab::Saxpy(  r[alev],  -alpha, q[alev], 0, 0, ncomp, 0);
+        }
+
+        ++iter;
+        resnorm = norm2(r);
+        if (verbose >= 2) {
+            amrex::Print() << "MLKrylovSolver: CG iteration " << std::setw(3) << iter
+                           << " resid = " << resnorm << "\n";
+        }
+        if (resnorm <= res_target) {
+            status = 0;
+            break;
+        }
+
+        mlmg.precond(amrex::GetVecOfPtrs(z), amrex::GetVecOfConstPtrs(r), precond_iters);
+        // (z_new, r_new - r_old) = -alpha (z_new, q)
+        Real rz_new = dotxy(r, z);
+        Real zq = dotxy(z, q);
+        ParallelAllReduce::Sum<Real>({rz_new, zq}, ParallelContext::CommunicatorSub());
+        const Real beta = -alpha*zq / rz;
+        rz = rz_new;
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            MultiFab::Xpay(p[alev], beta, z[alev], 0, 0, ncomp, 0);
+        }
+    }
+
+    // The true residual decides the convergence.
+    computeResidual(r, sol, rhs);
+    resnorm = norm2(r);
+    if (status == 0 && resnorm > res_target) { status = 1; }
+    return status;
+}
+
+void
+MLKrylovSolver::makeVec (Vector<MultiFab>& v, int nghost) const
+{
+    v.resize(namrlevs);
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        IntVect ng(nghost);
+        if (linop.hasHiddenDimension()) { ng[linop.hiddenDirection()] = 0; }
+        v[alev].define(linop.m_grids[alev][0], linop.m_dmap[alev][0], ncomp, ng,
+                       MFInfo(), *linop.Factory(alev));
+        v[alev].setVal(0.0);
+    }
+}
+
+void
+MLKrylovSolver::computeResidual (Vector<MultiFab>& r, const Vector<MultiFab*>& sol,
+                                 const Vector<MultiFab const*>& rhs)
+{
+    mlmg.compResidual(amrex::GetVecOfPtrs(r), sol, rhs);
+
+    // The residual of a singular system is projected onto the range of
+    // the operator.  Because the covered cells hold the average of the
+    // fine cells, the offset computed on the coarsest AMR level is that of
+    // the composite residual.
+    if (linop.isSingular(0) && linop.getEnforceSingularSolvable())
+    {
+        Vector<Any> a(namrlevs);
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            a[alev] = MultiFab(r[alev], amrex::make_alias, 0, ncomp);
+        }
+        auto const& offset = linop.getSolvabilityOffset(0, 0, a[0]);
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            linop.fixSolvabilityByOffset(alev, 0, a[alev], offset);
+        }
+    }
+}
+
+Real
+MLKrylovSolver::dotxy (const Vector<MultiFab const*>& x, const Vector<MultiFab const*>& y) const
+{
+    Real r = 0.0;
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        Real rlev;
+        if (alev < namrlevs-1) {
+            rlev = MultiFab::Dot(m_fine_mask[alev], *x[alev], 0, *y[alev], 0, ncomp, 0, true);
+        } else {
+            rlev = MultiFab::Dot(*x[alev], 0, *y[alev], 0, ncomp, 0, true);
+        }
+        r += m_weight[alev] * rlev;
+    }
+    return r;
+}
+
+Real
+MLKrylovSolver::dotxy (const Vector<MultiFab>& x, const Vector<MultiFab>& y) const
+{
+    return dotxy(amrex::GetVecOfConstPtrs(x), amrex::GetVecOfConstPtrs(y));
+}
+
+Real
+MLKrylovSolver::norm2 (const Vector<MultiFab>& x) const
+{
+    Real r = dotxy(x, x);
+    ParallelAllReduce::Sum(r, ParallelContext::CommunicatorSub());
+    return std::sqrt(r);
+}
+
+}
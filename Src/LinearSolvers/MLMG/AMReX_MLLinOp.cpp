@@ -560,6 +560,54 @@ MLLinOp::make (Vector<Vector<Any> >& mf, IntVect const& ng) const
     }
 }
 
+bool
+MLLinOp::isFrozenAndUnchanged (MultiFab const& dst, int dcomp, MultiFab const& src,
+                               int scomp, int ncomp) const
+{
+    if (!info.frozen_operator || !m_prepared) { return false; }
+
+    ReduceOps<ReduceOpSum> reduce_op;
+    ReduceData<int> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    for (MFIter mfi(dst); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real const> const& d = dst.const_array(mfi);
+        Array4<Real const> const& s = src.const_array(mfi);
+        reduce_op.eval(bx, ncomp, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) -> ReduceTuple
+        {
+            return { (d(i,j,k,dcomp+n) == s(i,j,k,scomp+n)) ? 0 : 1 };
+        });
+    }
+    int ndiff = amrex::get<0>(reduce_data.value(reduce_op));
+    ParallelAllReduce::Sum(ndiff, ParallelContext::CommunicatorSub());
+    return ndiff == 0;
+}
+
+bool
+MLLinOp::isFrozenAndUnchanged (MultiFab const& dst, int dcomp, Real val, int ncomp) const
+{
+    if (!info.frozen_operator || !m_prepared) { return false; }
+
+    ReduceOps<ReduceOpSum> reduce_op;
+    ReduceData<int> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    for (MFIter mfi(dst); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real const> const& d = dst.const_array(mfi);
+        reduce_op.eval(bx, ncomp, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) -> ReduceTuple
+        {
+            return { (d(i,j,k,dcomp+n) == val) ? 0 : 1 };
+        });
+    }
+    int ndiff = amrex::get<0>(reduce_data.value(reduce_op));
+    ParallelAllReduce::Sum(ndiff, ParallelContext::CommunicatorSub());
+    return ndiff == 0;
+}
+
 void
 MLLinOp::setDomainBC (const Array<BCType,AMREX_SPACEDIM>& a_lobc,
                       const Array<BCType,AMREX_SPACEDIM>& a_hibc) noexcept
@@ -1036,6 +1084,15 @@ MLLinOp::AnyCorrectionResidual (int amrlev, int mglev, Any& resid, Any& x, const
                        (crse_bcdata) ? &(crse_bcdata->get<MultiFab>()) : nullptr);
 }
 
+bool
+MLLinOp::AnyCorrectionResidualRestriction (int amrlev, int mglev, Any& crse_resid, Any& x,
+                                           const Any& b)
+{
+    AMREX_ASSERT(x.is<MultiFab>());
+    return correctionResidualRestriction(amrlev, mglev, crse_resid.get<MultiFab>(),
+                                         x.get<MultiFab>(), b.get<MultiFab>());
+}
+
 void
 MLLinOp::AnyReflux (int clev, Any& res, const Any& crse_sol, const Any& crse_rhs,
                     Any& fine_res, Any& fine_sol, const Any& fine_rhs)
@@ -45,7 +45,105 @@ MLMG::MLMG (MLLinOp& a_lp)
 {}
 
 MLMG::~MLMG ()
-{}
+{
+    // In frozen operator mode, the setup is handed over to the next MLMG
+    // object built with the same operator.
+    if (keep_frozen_setup && linop_prepared)
+    {
+        FrozenSetup s;
+        s.cf_strategy = cf_strategy;
+        s.solve_called = solve_called;
+        s.sol = std::move(sol);
+        s.rhs = std::move(rhs);
+        s.sol_is_alias = std::move(sol_is_alias);
+        s.res = std::move(res);
+        s.cor = std::move(cor);
+        s.cor_hold = std::move(cor_hold);
+        s.rescor = std::move(rescor);
+        s.ns_linop = std::move(ns_linop);
+        s.ns_mlmg = std::move(ns_mlmg);
+        s.ns_sol = std::move(ns_sol);
+        s.ns_rhs = std::move(ns_rhs);
+        s.amg_solver = std::move(amg_solver);
+#if defined(AMREX_USE_HYPRE) && (AMREX_SPACEDIM > 1)
+        s.hypre_solver = std::move(hypre_solver);
+        s.hypre_bndry = std::move(hypre_bndry);
+        s.hypre_node_solver = std::move(hypre_node_solver);
+#endif
+#ifdef AMREX_USE_PETSC
+        s.petsc_solver = std::move(petsc_solver);
+        s.petsc_bndry = std::move(petsc_bndry);
+#endif
+        linop.m_frozen_setup = std::move(s);
+    }
+}
+
+void
+MLMG::reuseFrozenSetup ()
+{
+    if (linop_prepared || !linop.isFrozenOperator() ||
+        !linop.m_frozen_setup.is<FrozenSetup>()) {
+        return;
+    }
+
+    auto& s = linop.m_frozen_setup.get<FrozenSetup>();
+    if (s.cf_strategy != cf_strategy) { return; }
+
+    solve_called = s.solve_called;
+    sol = std::move(s.sol);
+    rhs = std::move(s.rhs);
+    sol_is_alias = std::move(s.sol_is_alias);
+    res = std::move(s.res);
+    cor = std::move(s.cor);
+    cor_hold = std::move(s.cor_hold);
+    rescor = std::move(s.rescor);
+    ns_linop = std::move(s.ns_linop);
+    ns_mlmg = std::move(s.ns_mlmg);
+    ns_sol = std::move(s.ns_sol);
+    ns_rhs = std::move(s.ns_rhs);
+    amg_solver = std::move(s.amg_solver);
+#if defined(AMREX_USE_HYPRE) && (AMREX_SPACEDIM > 1)
+    hypre_solver = std::move(s.hypre_solver);
+    hypre_bndry = std::move(s.hypre_bndry);
+    hypre_node_solver = std::move(s.hypre_node_solver);
+#endif
+#ifdef AMREX_USE_PETSC
+    petsc_solver = std::move(s.petsc_solver);
+    petsc_bndry = std::move(s.petsc_bndry);
+#endif
+    linop.m_frozen_setup = Any();
+    linop_prepared = true;
+
+    if (verbose >= 2) {
+        amrex::Print() << "MLMG: Reusing the frozen setup\n";
+    }
+}
+
+void
+MLMG::prepareLinOp ()
+{
+    if (!linop_prepared) {
+        linop.prepareForSolve();
+        linop_prepared = true;
+    } else if (linop.needsUpdate()) {
+        linop.update();
+
+        amg_solver.reset();
+
+#if defined(AMREX_USE_HYPRE) && (AMREX_SPACEDIM > 1)
+        hypre_solver.reset();
+        hypre_bndry.reset();
+        hypre_node_solver.reset();
+#endif
+
+#ifdef AMREX_USE_PETSC
+        petsc_solver.reset();
+        petsc_bndry.reset();
+#endif
+    }
+    linop.m_prepared = true;
+    keep_frozen_setup = linop.isFrozenOperator();
+}
 
 Real
 MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs,
@@ -153,6 +251,10 @@ MLMG::solve (Vector<Any>& a_sol, const Vector<Any>& a_rhs,
 
             converged = false;
 
+            // The preconditioner does a fixed number of cycles without
+            // testing for convergence after the last one.
+            if (precond_mode && iter == niters-1) { break; }
+
             // Test convergence on the fine amr level
             computeResidual(finest_amr_lev);
 
@@ -238,6 +340,7 @@ MLMG::solve (Vector<Any>& a_sol, const Vector<Any>& a_rhs,
         if (ParallelContext::MyProcSub() == 0)
         {
             amrex::AllPrint() << "MLMG: Timers: Solve = " << timer[solve_time]
+                              << " Setup = " << timer[setup_time]
                               << " Iter = " << timer[iter_time]
                               << " Bottom = " << timer[bottom_time] << "\n";
         }
@@ -430,6 +533,15 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
             skip_fillboundary = false;
         }
 
+        // res_crse = R(res - L(cor)) in one pass, skipping rescor, if the
+        // operator supports it
+        if (fuse_kernels && verbose < 4 && cf_strategy != CFStrategy::ghostnodes &&
+            linop.AnyCorrectionResidualRestriction(amrlev, mglev, res[amrlev][mglev+1],
+                                                   cor[amrlev][mglev], res[amrlev][mglev]))
+        {
+            continue;
+        }
+
         // rescor = res - L(cor)
         computeResOfCorrection(amrlev, mglev);
 
@@ -727,12 +839,24 @@ MLMG::actualBottomSolve ()
         {
             bottomSolveWithPETSc(x, *bottom_b);
         }
+        else if (bottom_solver == BottomSolver::amg)
+        {
+            int ret = bottomSolveWithAMG(x, *bottom_b);
+            // If the AMG solve failed then set the correction to zero
+            if (ret != 0) {
+                linop.AnySetToZero(cor[amrlev][mglev]);
+            }
+        }
         else
         {
             MLCGSolver::Type cg_type;
             if (bottom_solver == BottomSolver::cg ||
                 bottom_solver == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
+            } else if (bottom_solver == BottomSolver::pipecg) {
+                cg_type = MLCGSolver::Type::PipeCG;
+            } else if (bottom_solver == BottomSolver::pipebicgstab) {
+                cg_type = MLCGSolver::Type::PipeBiCGStab;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
             }
@@ -788,6 +912,35 @@ MLMG::bottomSolveWithCG (Any& x, const Any& b, MLCGSolver::Type type)
     return ret;
 }
 
+int
+MLMG::bottomSolveWithAMG (Any& a_x, const Any& a_b)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(linop.isCellCentered() && linop.getNComp() == 1,
+                                     "BottomSolver::amg only works with single-component cell-centered operators");
+    AMREX_ASSERT(a_x.is<MultiFab>());
+
+    if (amg_solver == nullptr) {
+        amg_solver = std::make_unique<MLAMG>(linop);
+    }
+    amg_solver->setVerbose(bottom_verbose);
+    amg_solver->setMaxIter(bottom_maxiter);
+
+    int ret = amg_solver->solve(a_x.get<MultiFab>(), a_b.get<MultiFab>(),
+                                bottom_reltol, bottom_abstol);
+    if (ret != 0 && verbose > 1) {
+        amrex::Print() << "MLMG: Bottom solve failed.\n";
+    }
+    m_niters_cg.push_back(amg_solver->getNumIters());
+
+    const int amrlev = 0;
+    const int mglev = linop.NMGLevels(amrlev) - 1;
+    if (ret == 0 && linop.isSingular(amrlev) && linop.getEnforceSingularSolvable())
+    {
+        makeSolvable(amrlev, mglev, a_x);
+    }
+    return ret;
+}
+
 // Compute single-level masked inf-norm of Residual (res).
 Real
 MLMG::ResNormInf (int alev, bool local)
@@ -833,27 +986,22 @@ MLMG::prepareForSolve (Vector<Any>& a_sol, const Vector<Any>& a_rhs)
     AMREX_ASSERT(namrlevs <= a_rhs.size());
 
     timer.assign(ntimers, 0.0);
+    const double setup_start_time = amrex::second();
 
     IntVect ng_rhs(0);
     IntVect ng_sol(1);
     if (linop.hasHiddenDimension()) ng_sol[linop.hiddenDirection()] = 0;
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
+    reuseFrozenSetup();
 
-#if defined(AMREX_USE_HYPRE) && (AMREX_SPACEDIM > 1)
-        hypre_solver.reset();
-        hypre_bndry.reset();
-        hypre_node_solver.reset();
-#endif
+    const bool update_smoother = !linop_prepared || linop.needsUpdate()
+        || linop.getSmoother() != smoother;
+    linop.setSmoother(smoother, chebyshev_degree);
 
-#ifdef AMREX_USE_PETSC
-        petsc_solver.reset();
-        petsc_bndry.reset();
-#endif
+    prepareLinOp();
+
+    if (update_smoother) {
+        linop.prepareSmoother();
     }
 
     sol.resize(namrlevs);
@@ -873,7 +1021,7 @@ MLMG::prepareForSolve (Vector<Any>& a_sol, const Vector<Any>& a_rhs)
         }
         else
         {
-            if (!solve_called) {
+            if (!solve_called || sol_is_alias[alev]) {
                 sol[alev] = linop.AnyMake(alev, 0, ng_sol);
             }
             linop.AnyCopy(sol[alev], a_sol[alev], IntVect(0));
@@ -892,7 +1040,9 @@ MLMG::prepareForSolve (Vector<Any>& a_sol, const Vector<Any>& a_rhs)
         linop.AnyCopy(rhs[alev], a_rhs[alev], ng_rhs);
         linop.applyMetricTerm(alev, 0, rhs[alev]);
         linop.unimposeNeumannBC(alev, rhs[alev]);
-        linop.applyInhomogNeumannTerm(alev, rhs[alev]);
+        if (!precond_mode) {
+            linop.applyInhomogNeumannTerm(alev, rhs[alev]);
+        }
         linop.applyOverset(alev, rhs[alev]);
         linop.scaleRHS(alev, rhs[alev]);
 
@@ -996,6 +1146,8 @@ MLMG::prepareForSolve (Vector<Any>& a_sol, const Vector<Any>& a_rhs)
                            << "      # of grids in N-Solve: " << ns_linop->m_grids[0][0].size() << "\n";
         }
     }
+
+    timer[setup_time] = amrex::second() - setup_start_time;
 }
 
 void
@@ -1148,6 +1300,8 @@ MLMG::compResidual (const Vector<MultiFab*>& a_res, const Vector<MultiFab*>& a_s
 {
     BL_PROFILE("MLMG::compResidual()");
 
+    reuseFrozenSetup();
+
     const int ncomp = linop.getNComp();
     IntVect ng_sol(1);
     if (linop.hasHiddenDimension()) ng_sol[linop.hiddenDirection()] = 0;
@@ -1171,12 +1325,7 @@ MLMG::compResidual (const Vector<MultiFab*>& a_res, const Vector<MultiFab*>& a_s
         }
     }
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
+    prepareLinOp();
 
     const auto& amrrr = linop.AMRRefRatio();
 
@@ -1221,6 +1370,8 @@ MLMG::apply (const Vector<MultiFab*>& out, const Vector<MultiFab*>& a_in)
 {
     BL_PROFILE("MLMG::apply()");
 
+    reuseFrozenSetup();
+
     Vector<MultiFab*> in(namrlevs);
     Vector<MultiFab> in_raii(namrlevs);
     Vector<MultiFab> rh(namrlevs);
@@ -1257,16 +1408,13 @@ MLMG::apply (const Vector<MultiFab*>& out, const Vector<MultiFab*>& a_in)
         rh[alev].setVal(0.0);
     }
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
+    prepareLinOp();
 
-    for (int alev = 0; alev < namrlevs; ++alev) {
-        Any a(MultiFab(rh[alev], amrex::make_alias, 0, rh[alev].nComp()));
-        linop.applyInhomogNeumannTerm(alev, a);
+    if (!precond_mode) {
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            Any a(MultiFab(rh[alev], amrex::make_alias, 0, rh[alev].nComp()));
+            linop.applyInhomogNeumannTerm(alev, a);
+        }
     }
 
     const auto& amrrr = linop.AMRRefRatio();
@@ -1299,6 +1447,41 @@ MLMG::apply (const Vector<MultiFab*>& out, const Vector<MultiFab*>& a_in)
     }
 }
 
+void
+MLMG::applyPrecond (const Vector<MultiFab*>& out, const Vector<MultiFab*>& in)
+{
+    precond_mode = true;
+    linop.beginPrecondBC();
+    apply(out, in);
+    linop.endPrecondBC();
+    precond_mode = false;
+}
+
+void
+MLMG::precond (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs,
+               int a_niters)
+{
+    BL_PROFILE("MLMG::precond()");
+
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        a_sol[alev]->setVal(0.0);
+    }
+
+    const int verbose_save = verbose;
+    const int fixed_iters_save = do_fixed_number_of_iters;
+    verbose = 0;
+    do_fixed_number_of_iters = a_niters;
+
+    precond_mode = true;
+    linop.beginPrecondBC();
+    solve(a_sol, a_rhs, Real(0.0), Real(0.0));
+    linop.endPrecondBC();
+    precond_mode = false;
+
+    verbose = verbose_save;
+    do_fixed_number_of_iters = fixed_iters_save;
+}
+
 void
 MLMG::makeSolvable ()
 {
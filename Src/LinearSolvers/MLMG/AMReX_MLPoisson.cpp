@@ -1,6 +1,7 @@
 
 #include <AMReX_MLPoisson.H>
 #include <AMReX_MLPoisson_K.H>
+#include <AMReX_MLLinOp_K.H>
 #include <AMReX_MLALaplacian.H>
 
 namespace amrex {
@@ -204,6 +205,79 @@ MLPoisson::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) con
     }
 }
 
+bool
+MLPoisson::correctionResidualRestriction (int amrlev, int mglev, MultiFab& crse_resid,
+                                          MultiFab& x, const MultiFab& b)
+{
+    if (m_overset_mask[amrlev][mglev] || m_has_metric_term || hasHiddenDimension()
+        || !isMFIterSafe(amrlev, mglev, mglev+1))
+    {
+        return false;
+    }
+
+    BL_PROFILE("MLPoisson::correctionResidualRestriction()");
+    applyBC(amrlev, mglev, x, BCMode::Homogeneous, StateMode::Correction);
+#ifdef AMREX_SOFT_PERF_COUNTERS
+    perf_counters.apply(x);
+    perf_counters.restrict(crse_resid);
+#endif
+
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+    AMREX_D_TERM(const Real dhx = dxinv[0]*dxinv[0];,
+                 const Real dhy = dxinv[1]*dxinv[1];,
+                 const Real dhz = dxinv[2]*dxinv[2];);
+
+    Dim3 ratio3 = {1,1,1};
+    IntVect ratio = (amrlev > 0) ? IntVect(2) : mg_coarsen_ratio_vec[mglev];
+    AMREX_D_TERM(ratio3.x = ratio[0];,
+                 ratio3.y = ratio[1];,
+                 ratio3.z = ratio[2];);
+
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion() && crse_resid.isFusingCandidate()) {
+        auto const& cma = crse_resid.arrays();
+        auto const& xma = x.const_arrays();
+        auto const& bma = b.const_arrays();
+        ParallelFor(crse_resid,
+        [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
+        {
+            mllinop_restrict_res(i,j,k,0, cma[box_no], ratio3,
+            [=] (int ii, int jj, int kk, int) -> Real
+            {
+                amrex::ignore_unused(jj,kk);
+                return mlpoisson_corres(AMREX_D_DECL(ii,jj,kk), xma[box_no], bma[box_no],
+                                        AMREX_D_DECL(dhx,dhy,dhz));
+            });
+        });
+        Gpu::streamSynchronize();
+    } else
+#endif
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        {
+            Vector<Real> rowbuf;
+            for (MFIter mfi(crse_resid, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                const auto& cfab = crse_resid.array(mfi);
+                const auto& xfab = x.const_array(mfi);
+                const auto& bfab = b.const_array(mfi);
+                rowbuf.resize(bx.length(0)*ratio3.x);
+                mllinop_restrict_res(bx, 1, cfab, ratio3,
+                [=] (int i, int j, int k, int) -> Real
+                {
+                    amrex::ignore_unused(j,k);
+                    return mlpoisson_corres(AMREX_D_DECL(i,j,k), xfab, bfab,
+                                            AMREX_D_DECL(dhx,dhy,dhz));
+                }, rowbuf.data());
+            }
+        }
+    }
+    return true;
+}
+
 void
 MLPoisson::normalize (int amrlev, int mglev, MultiFab& mf) const
 {
@@ -0,0 +1,135 @@
+#include <AMReX.H>
+#include <AMReX_AmrMesh.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+// Tag thin spherical shells, which produces many small clusters on the
+// fine levels.
+class ShellMesh
+    : public AmrMesh
+{
+public:
+    ShellMesh (Geometry const& level_0_geom, AmrInfo const& amr_info)
+        : AmrMesh(level_0_geom, amr_info)
+    {}
+
+    void ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/) override
+    {
+        const auto problo = Geom(lev).ProbLoArray();
+        const auto dx = Geom(lev).CellSizeArray();
+        const Real width = 1.5_rt*dx[0];
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+        {
+            Box const& bx = mfi.validbox();
+            Array4<char> const& tag = tags.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                amrex::ignore_unused(j,k);
+                GpuArray<Real,AMREX_SPACEDIM> x{AMREX_D_DECL(problo[0]+(i+0.5_rt)*dx[0],
+                                                             problo[1]+(j+0.5_rt)*dx[1],
+                                                             problo[2]+(k+0.5_rt)*dx[2])};
+                for (int n = 0; n < 3; ++n) {
+                    const Real c = 0.25_rt + 0.25_rt*n;
+                    const Real r = 0.1_rt + 0.05_rt*n;
+                    Real d2 = 0._rt;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        d2 += (x[idim]-c)*(x[idim]-c);
+                    }
+                    if (std::abs(std::sqrt(d2)-r) < width) {
+                        tag(i,j,k) = TagBox::SET;
+                    }
+                }
+            });
+        }
+    }
+
+    // Check that the grids at each level are disjoint and cover the tags
+    // on the level below.  The tags are not buffered here.
+    int check ()
+    {
+        int nfail = 0;
+        for (int lev = 1; lev <= finest_level; ++lev) {
+            if (!grids[lev].isDisjoint()) { ++nfail; }
+            TagBoxArray tags(grids[lev-1], dmap[lev-1]);
+            ErrorEst(lev-1, tags, 0._rt, 0);
+            Gpu::PinnedVector<IntVect> tagvec;
+            tags.local_collate(tagvec);
+            BoxArray cba = amrex::coarsen(grids[lev], ref_ratio[lev-1]);
+            for (auto const& iv : tagvec) {
+                if (!cba.contains(iv)) { ++nfail; }
+            }
+        }
+        ParallelDescriptor::ReduceIntSum(nfail);
+        return nfail;
+    }
+};
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_level = 2;
+        int max_grid_size = 32;
+        int blocking_factor = 8;
+        int nrepeat = 3;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_level", max_level);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("blocking_factor", blocking_factor);
+            pp.query("nrepeat", nrepeat);
+        }
+
+        Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                      RealBox({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)}),
+                      CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+        AmrInfo info;
+        info.max_level = max_level;
+        info.max_grid_size = {IntVect(max_grid_size)};
+        info.blocking_factor = {IntVect(blocking_factor)};
+        info.n_error_buf = {IntVect(2)};
+
+        int nfail = 0;
+        for (bool parallel : {false, true}) {
+            info.use_parallel_cluster = parallel;
+            ShellMesh mesh(geom, info);
+            ParallelDescriptor::Barrier();
+            double t0 = amrex::second();
+            mesh.MakeNewGrids(0._rt);
+            double t1 = amrex::second();
+            nfail += mesh.check();
+
+            // Regrid all the levels above level 0 without changing them.
+            ParallelDescriptor::Barrier();
+            double t2 = amrex::second();
+            for (int irep = 0; irep < nrepeat; ++irep) {
+                int new_finest;
+                Vector<BoxArray> new_grids(mesh.maxLevel()+1);
+                mesh.MakeNewGrids(0, 0._rt, new_finest, new_grids);
+            }
+            double t3 = amrex::second();
+
+            amrex::Print() << (parallel ? "parallel" : "serial  ") << " clustering: initial grids "
+                           << t1-t0 << " s, regrid " << (t3-t2)/nrepeat << " s\n";
+            for (int lev = 1; lev <= mesh.finestLevel(); ++lev) {
+                amrex::Print() << "    level " << lev << ": " << mesh.boxArray(lev).size()
+                               << " boxes, " << mesh.boxArray(lev).numPts() << " cells\n";
+            }
+        }
+
+        amrex::Print() << "Checking the grids: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,217 @@
+#include <AMReX.H>
+#include <AMReX_CArena.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_TArena.H>
+#include <AMReX_ThreadCacheArena.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+#include <random>
+
+using namespace amrex;
+
+namespace {
+
+struct Op
+{
+    int id;             // index of the live slot
+    std::size_t nbytes; // 0 means free
+};
+
+// FAB-like sizes: (n+2*ng)^3 cells with a few components of Real.
+std::size_t fab_size (std::mt19937& gen)
+{
+    static const int n[] = {8, 16, 32, 64};
+    std::uniform_int_distribution<int> dn(0, 3);
+    std::uniform_int_distribution<int> dng(0, 4);
+    std::uniform_int_distribution<int> dnc(1, 8);
+    std::size_t len = n[dn(gen)] + 2*dng(gen);
+    return len*len*len*dnc(gen)*sizeof(Real);
+}
+
+// Small temporaries, e.g., tags, masks and Gpu::DeviceVector growth.
+std::size_t small_size (std::mt19937& gen)
+{
+    std::uniform_int_distribution<std::size_t> d(1, 4096);
+    return d(gen);
+}
+
+Vector<Op> make_ops (std::string const& dist, int nops, int max_live, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+
+    Vector<Op> ops;
+    ops.reserve(nops);
+    Vector<int> live;
+    Vector<int> slots(max_live);
+    for (int i = 0; i < max_live; ++i) { slots[i] = max_live-1-i; }
+
+    for (int iop = 0; iop < nops; ++iop) {
+        bool do_alloc = live.empty() || (!slots.empty() && u(gen) < 0.5);
+        if (do_alloc) {
+            std::size_t nbytes;
+            if (dist == "fab") {
+                nbytes = fab_size(gen);
+            } else if (dist == "small") {
+                nbytes = small_size(gen);
+            } else {
+                nbytes = (u(gen) < 0.8) ? small_size(gen) : fab_size(gen);
+            }
+            int id = slots.back();
+            slots.pop_back();
+            live.push_back(id);
+            ops.push_back(Op{id, nbytes});
+        } else {
+            std::uniform_int_distribution<int> d(0, static_cast<int>(live.size())-1);
+            int k = d(gen);
+            int id = live[k];
+            live[k] = live.back();
+            live.pop_back();
+            slots.push_back(id);
+            ops.push_back(Op{id, 0});
+        }
+    }
+    for (int id : live) {
+        ops.push_back(Op{id, 0});
+    }
+    return ops;
+}
+
+template <class A>
+void run (A& arena, std::string const& name, Vector<Op> const& ops, int max_live, bool check)
+{
+    Vector<void*> ptrs(max_live, nullptr);
+    Vector<std::size_t> sizes(max_live, 0);
+    std::size_t peak_used = 0, peak_actually_used = 0;
+
+    double t0 = amrex::second();
+    for (auto const& op : ops) {
+        if (op.nbytes > 0) {
+            void* p = arena.alloc(op.nbytes);
+            ptrs[op.id] = p;
+            sizes[op.id] = op.nbytes;
+            if (check) {
+                // Only touch both ends so that we do not time page faults.
+                auto* pc = static_cast<unsigned char*>(p);
+                pc[0] = pc[op.nbytes-1] = static_cast<unsigned char>(op.id % 256);
+            }
+            peak_used = std::max(peak_used, arena.heap_space_used());
+            peak_actually_used = std::max(peak_actually_used, arena.heap_space_actually_used());
+        } else {
+            if (check) {
+                auto const* p = static_cast<unsigned char const*>(ptrs[op.id]);
+                auto const c = static_cast<unsigned char>(op.id % 256);
+                AMREX_ALWAYS_ASSERT(p[0] == c && p[sizes[op.id]-1] == c);
+                AMREX_ALWAYS_ASSERT(arena.sizeOf(ptrs[op.id]) >= sizes[op.id]);
+            }
+            arena.free(ptrs[op.id]);
+            ptrs[op.id] = nullptr;
+        }
+    }
+    double t1 = amrex::second();
+
+    AMREX_ALWAYS_ASSERT(arena.heap_space_actually_used() == 0);
+
+    amrex::Print() << "    " << name << ": " << ops.size()/(t1-t0)/1.e6 << " Mops/s, "
+                   << "peak heap (MB) " << double(peak_used)/(1024.*1024.)
+                   << ", peak in use (MB) " << double(peak_actually_used)/(1024.*1024.)
+                   << ", fragmentation overhead "
+                   << (peak_actually_used > 0
+                       ? double(peak_used)/double(peak_actually_used) - 1.0 : 0.0)
+                   << "\n";
+}
+
+
+#ifdef AMREX_USE_OMP
+// Mimic MFIter loops building a few tile temporaries per tile.
+void run_threaded (Arena& arena, std::string const& name, int ntiles)
+{
+    // Tiles come in a few different sizes only.
+    std::mt19937 gen(42);
+    Vector<std::size_t> tile_bytes{fab_size(gen), fab_size(gen), fab_size(gen)};
+    const int nsizes = tile_bytes.size();
+
+    double t0 = amrex::second();
+#pragma omp parallel
+    {
+#pragma omp for schedule(dynamic)
+        for (int itile = 0; itile < ntiles; ++itile) {
+            std::size_t nbytes = tile_bytes[itile % nsizes];
+            void* p0 = arena.alloc(nbytes);
+            void* p1 = arena.alloc(nbytes);
+            void* p2 = arena.alloc(2*nbytes);
+            static_cast<char*>(p0)[0] = static_cast<char*>(p1)[0] = static_cast<char*>(p2)[0] = 0;
+            arena.free(p2);
+            arena.free(p1);
+            arena.free(p0);
+        }
+    }
+    double t1 = amrex::second();
+    amrex::Print() << "    " << name << ": " << 6.0*ntiles/(t1-t0)/1.e6 << " Mops/s with "
+                   << OpenMP::get_max_threads() << " threads\n";
+}
+#endif
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int nops = 200000;
+        int max_live = 500;
+        bool check = true;
+        unsigned seed = 42;
+        Vector<std::string> dists{"small", "fab", "mixed"};
+        {
+            ParmParse pp;
+            pp.query("nops", nops);
+            pp.query("max_live", max_live);
+            pp.query("check", check);
+            pp.queryarr("dists", dists);
+        }
+
+        for (auto const& dist : dists) {
+            amrex::Print() << "Distribution " << dist << " with " << nops << " ops and at most "
+                           << max_live << " live blocks\n";
+            auto ops = make_ops(dist, nops, max_live, seed);
+            {
+                CArena arena(0, ArenaInfo{}.SetCpuMemory());
+                run(arena, "CArena", ops, max_live, check);
+            }
+            {
+                TArena arena(0, ArenaInfo{}.SetCpuMemory());
+                run(arena, "TArena", ops, max_live, check);
+                arena.freeUnused();
+                AMREX_ALWAYS_ASSERT(arena.heap_space_used() == 0);
+            }
+        }
+
+#ifdef AMREX_USE_OMP
+        int ntiles = 100000;
+        {
+            ParmParse pp;
+            pp.query("ntiles", ntiles);
+        }
+        amrex::Print() << "Tile temporaries in OpenMP parallel region with " << ntiles << " tiles\n";
+        {
+            CArena arena(0, ArenaInfo{}.SetCpuMemory());
+            run_threaded(arena, "CArena", ntiles);
+        }
+        {
+            CArena parent(0, ArenaInfo{}.SetCpuMemory());
+            {
+                ThreadCacheArena arena(&parent);
+                run_threaded(arena, "ThreadCacheArena", ntiles);
+                arena.PrintUsage("ThreadCacheArena");
+            }
+            AMREX_ALWAYS_ASSERT(parent.heap_space_actually_used() == 0);
+        }
+#endif
+    }
+    amrex::Finalize();
+}
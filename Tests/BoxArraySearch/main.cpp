@@ -0,0 +1,258 @@
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+using namespace amrex;
+
+namespace {
+
+// Boxes of size box_size covering a cube of about nboxes boxes.  If
+// one_big_box is true, the boxes in the low corner of the cube are replaced
+// by a single box of half its size, as an extreme case of boxes of widely
+// varying sizes.
+BoxArray make_ba (Long nboxes, int box_size, bool one_big_box)
+{
+    const int nb = std::max(2, static_cast<int>(std::lround(std::pow(double(nboxes), 1./AMREX_SPACEDIM))));
+    const int n_cell = (nb/2)*2*box_size;
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(box_size);
+    if (!one_big_box) { return ba; }
+
+    const Box big(IntVect(0), IntVect(n_cell/2-1));
+    BoxList bl;
+    bl.push_back(big);
+    for (int i = 0; i < ba.size(); ++i) {
+        if (!big.contains(ba[i])) {
+            bl.push_back(ba[i]);
+        }
+    }
+    return BoxArray(std::move(bl));
+}
+
+// The boxes of size box_size covering a sphere in a cube of n_cell cells.
+BoxArray make_sphere_ba (int n_cell, int box_size)
+{
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(box_size);
+    BoxList bl;
+    const Real c = 0.5_rt*n_cell;
+    for (int i = 0; i < ba.size(); ++i) {
+        const Box& b = ba[i];
+        Real r2 = 0.0_rt;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const Real x = 0.5_rt*(b.smallEnd(idim)+b.bigEnd(idim)+1) - c;
+            r2 += x*x;
+        }
+        if (r2 < c*c) {
+            bl.push_back(b);
+        }
+    }
+    return BoxArray(std::move(bl));
+}
+
+using Isects = std::vector<std::pair<int,Box> >;
+
+bool same (Isects a, Isects b)
+{
+    auto comp = [] (std::pair<int,Box> const& x, std::pair<int,Box> const& y)
+    {
+        return x.first < y.first;
+    };
+    std::sort(a.begin(), a.end(), comp);
+    std::sort(b.begin(), b.end(), comp);
+    return a == b;
+}
+
+// Check that the hash map and either the BVH or the compact storage give
+// the same intersections.  make_ba() must return a new BoxArray that does
+// not share its data.
+template <typename F>
+int check (F const& make_ba, int nquery, IntVect const& ng, bool compact = false)
+{
+    BoxArray hash_ba = make_ba();
+    hash_ba.setSearchIndex(BoxArray::SearchIndex::hash);
+    BoxArray bvh_ba = make_ba();
+    if (compact) {
+        if (!bvh_ba.compact()) { return 1; }
+    } else {
+        bvh_ba.setSearchIndex(BoxArray::SearchIndex::bvh);
+    }
+    AMREX_ALWAYS_ASSERT(!BoxArray::SameRefs(hash_ba, bvh_ba));
+    const BoxArray& ba = hash_ba;
+
+    int nfail = 0;
+    if (hash_ba != bvh_ba || !hash_ba.CellEqual(bvh_ba) ||
+        hash_ba.minimalBox() != bvh_ba.minimalBox() ||
+        hash_ba.numPts() != bvh_ba.numPts()) {
+        ++nfail;
+    }
+    const int stride = std::max(1, static_cast<int>(ba.size()) / nquery);
+    Isects h, b;
+    for (int i = 0; i < ba.size(); i += stride) {
+        if (hash_ba[i] != bvh_ba[i]) { ++nfail; }
+        Box q = amrex::grow(ba[i], 2);
+        q.shift(IntVect(1));
+        hash_ba.intersections(q, h, false, ng);
+        bvh_ba.intersections(q, b, false, ng);
+        if (!same(h, b)) { ++nfail; }
+        hash_ba.intersections(q, h, true, ng);
+        bvh_ba.intersections(q, b, true, ng);
+        if (h.size() != b.size()) { ++nfail; }
+        if (BoxArray(hash_ba.complementIn(q)).numPts() !=
+            BoxArray(bvh_ba.complementIn(q)).numPts()) { ++nfail; }
+    }
+    return nfail;
+}
+
+void bench (BoxArray const& ba, int nquery)
+{
+    // One query per box, for a sample of the boxes.
+    const int stride = std::max(1, static_cast<int>(ba.size()) / nquery);
+    Vector<Box> queries;
+    for (int i = 0; i < ba.size(); i += stride) {
+        queries.push_back(amrex::grow(ba[i], 1));
+    }
+
+    for (auto si : {BoxArray::SearchIndex::hash, BoxArray::SearchIndex::bvh}) {
+        BoxArray sba(ba.boxList());
+        sba.setSearchIndex(si);
+        Isects isects;
+        double t0 = amrex::second();
+        sba.intersects(queries[0]); // build the index
+        double t1 = amrex::second();
+        Long nisects = 0;
+        for (auto const& q : queries) {
+            sba.intersections(q, isects);
+            nisects += isects.size();
+        }
+        double t2 = amrex::second();
+        amrex::Print() << "    " << ((si == BoxArray::SearchIndex::hash) ? "hash" : "bvh ")
+                       << ": build " << t1-t0 << " s, "
+                       << (t2-t1)/queries.size()*1.e6 << " us/query, "
+                       << double(sba.searchIndexBytes())/double(ba.size()) << " bytes/box, "
+                       << double(nisects)/queries.size() << " intersections/query\n";
+    }
+}
+
+
+void bench_compact (BoxArray const& ba, int nquery)
+{
+    BoxArray cba(ba.boxList());
+    cba.compact();
+    AMREX_ALWAYS_ASSERT(cba.isCompact());
+
+    const int stride = std::max(1, static_cast<int>(ba.size()) / nquery);
+    Vector<Box> queries;
+    for (int i = 0; i < ba.size(); i += stride) {
+        queries.push_back(amrex::grow(ba[i], 1));
+    }
+
+    amrex::Print() << ba.size() << " boxes covering a sphere\n";
+    for (BoxArray const* pba : {&ba, static_cast<BoxArray const*>(&cba)}) {
+        Isects isects;
+        double t0 = amrex::second();
+        Long npts = 0;
+        for (int i = 0; i < pba->size(); ++i) {
+            npts += (*pba)[i].numPts();
+        }
+        double t1 = amrex::second();
+        for (auto const& q : queries) {
+            pba->intersections(q, isects);
+        }
+        double t2 = amrex::second();
+        AMREX_ALWAYS_ASSERT(npts == ba.numPts());
+        const Long bytes = pba->boxStorageBytes() + pba->searchIndexBytes();
+        amrex::Print() << "    " << (pba->isCompact() ? "compact" : "usual  ")
+                       << ": " << double(bytes)/double(ba.size()) << " bytes/box, "
+                       << (t1-t0)/ba.size()*1.e9 << " ns/operator[], "
+                       << (t2-t1)/queries.size()*1.e6 << " us/query\n";
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Long max_boxes = 100000;
+        int nquery = 2000;
+        {
+            ParmParse pp;
+            pp.query("max_boxes", max_boxes);
+            pp.query("nquery", nquery);
+        }
+
+        int nfail = 0;
+        for (bool one_big_box : {false, true}) {
+            auto cc = [=] () { return make_ba(4096, 8, one_big_box); };
+            auto nd = [=] () { return amrex::convert(make_ba(4096, 8, one_big_box), IntVect(1)); };
+            auto cr = [=] () { return amrex::coarsen(make_ba(4096, 8, one_big_box), 2); };
+            nfail += check(cc, 500, IntVect(0));
+            nfail += check(cc, 500, IntVect(2));
+            nfail += check(nd, 500, IntVect(1));
+            nfail += check(cr, 500, IntVect(0));
+        }
+        amrex::Print() << "Comparing the hash map with the BVH: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+
+        {
+            auto cc = [=] () { return make_ba(4096, 8, false); };
+            auto sp = [=] () { return make_sphere_ba(64, 8); };
+            auto nd = [=] () { return amrex::convert(make_sphere_ba(64, 8), IntVect(1)); };
+            auto cr = [=] () { return amrex::coarsen(make_sphere_ba(64, 8), 2); };
+            // Several boxes chopped by maxSize, with boxes of different sizes.
+            auto mb = [=] () {
+                BoxList bl;
+                bl.push_back(Box(IntVect(0), IntVect(37)));
+                bl.push_back(Box(IntVect(AMREX_D_DECL(38,0,0)), IntVect(AMREX_D_DECL(63,37,37))));
+                bl.maxSize(8);
+                return BoxArray(std::move(bl));
+            };
+            nfail += check(cc, 500, IntVect(0), true);
+            nfail += check(sp, 500, IntVect(0), true);
+            nfail += check(sp, 500, IntVect(2), true);
+            nfail += check(nd, 500, IntVect(1), true);
+            nfail += check(cr, 500, IntVect(0), true);
+            nfail += check(mb, 500, IntVect(1), true);
+
+            // Boxes that are not the cells of a grid are not compacted.
+            if (make_ba(4096, 8, true).compact()) { ++nfail; }
+
+            // Modifying a compact BoxArray gives the same result as before.
+            BoxArray ba = make_sphere_ba(64, 8);
+            BoxArray cba = make_sphere_ba(64, 8);
+            cba.compact();
+            BoxArray cba2 = cba;
+            cba2.refine(2);
+            if (!cba.isCompact() || cba2.isCompact() ||
+                BoxArray(ba).refine(2) != cba2 || ba != cba) {
+                ++nfail;
+            }
+        }
+        amrex::Print() << "Comparing the hash map with the compact storage: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+
+        for (Long nboxes = 1000; nboxes <= max_boxes; nboxes *= 10) {
+            bench_compact(make_sphere_ba(static_cast<int>(std::lround(std::pow(nboxes/0.5236, 1./AMREX_SPACEDIM)))*8, 8),
+                          nquery);
+        }
+
+        for (bool one_big_box : {false, true}) {
+            for (Long nboxes = 1000; nboxes <= max_boxes; nboxes *= 10) {
+                BoxArray ba = make_ba(nboxes, 8, one_big_box);
+                amrex::Print() << ba.size() << " boxes" << (one_big_box ? " and one big box\n" : "\n");
+                bench(ba, nquery);
+            }
+        }
+    }
+    amrex::Finalize();
+}
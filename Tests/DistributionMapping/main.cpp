@@ -0,0 +1,188 @@
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace amrex;
+
+namespace {
+
+// Boxes covering a sphere, as a refined level would.
+BoxArray make_sphere_ba (int n_cell, int max_grid_size)
+{
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    BoxList bl;
+    const Real c = 0.5_rt*n_cell;
+    for (int i = 0; i < ba.size(); ++i) {
+        const Box& b = ba[i];
+        Real r2 = 0.0_rt;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const Real x = 0.5_rt*(b.smallEnd(idim)+b.bigEnd(idim)+1) - c;
+            r2 += x*x;
+        }
+        if (r2 < 0.16_rt*n_cell*n_cell) {
+            bl.push_back(b);
+        }
+    }
+    return BoxArray(std::move(bl));
+}
+
+void compare (BoxArray const& ba, int nprocs, int nghost)
+{
+    Vector<Long> wgts(ba.size());
+    for (int i = 0; i < ba.size(); ++i) {
+        wgts[i] = ba[i].numPts();
+    }
+
+    auto report = [&] (std::string const& name, std::vector<std::vector<int> > const& parts,
+                       double t)
+    {
+        Vector<int> pmap(ba.size(), -1);
+        Long max_wgt = 0, sum_wgt = 0;
+        for (int p = 0; p < nprocs; ++p) {
+            Long w = 0;
+            for (int ibox : parts[p]) {
+                pmap[ibox] = p;
+                w += wgts[ibox];
+            }
+            max_wgt = std::max(max_wgt, w);
+            sum_wgt += w;
+        }
+        AMREX_ALWAYS_ASSERT(std::find(pmap.begin(), pmap.end(), -1) == pmap.end());
+        DistributionMapping dm(std::move(pmap));
+        Long vol = DistributionMapping::ComputeCommunicationVolume(ba, dm, IntVect(nghost));
+        amrex::Print() << "    " << name << ": efficiency " << double(sum_wgt)/(double(nprocs)*max_wgt)
+                       << ", communication volume " << vol << ", time " << t << " s\n";
+        return vol;
+    };
+
+    double t0 = amrex::second();
+    auto sfc = DistributionMapping::makeSFC(ba, true, nprocs);
+    double t1 = amrex::second();
+    auto graph = DistributionMapping::makeGraph(ba, true, nprocs);
+    double t2 = amrex::second();
+
+    report("SFC  ", sfc, t1-t0);
+    report("GRAPH", graph, t2-t1);
+}
+
+Real efficiency (Vector<int> const& pmap, Vector<Real> const& cost, int nprocs)
+{
+    Vector<Real> load(nprocs, 0.0_rt);
+    for (int i = 0; i < pmap.size(); ++i) {
+        load[pmap[i]] += cost[i];
+    }
+    return std::accumulate(load.begin(), load.end(), 0.0_rt)
+        / (nprocs * *std::max_element(load.begin(), load.end()));
+}
+
+// Start from a balanced SFC mapping, then make the work in a corner of the
+// domain more expensive and compare rebalancing from scratch with
+// incremental rebalancing under different migration budgets.
+void rebalance (BoxArray const& ba, int nprocs, int n_cell)
+{
+    const Long bytes_per_cell = 5*sizeof(Real);
+    Vector<Long> box_bytes(ba.size());
+    Vector<Real> cost(ba.size());
+    for (int i = 0; i < ba.size(); ++i) {
+        box_bytes[i] = ba[i].numPts() * bytes_per_cell;
+        Real r2 = 0.0_rt;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const Real x = Real(ba[i].smallEnd(idim)) / n_cell;
+            r2 += x*x;
+        }
+        cost[i] = ba[i].numPts() * (1.0_rt + std::exp(-10.0_rt*r2));
+    }
+    const Long total_bytes = std::accumulate(box_bytes.begin(), box_bytes.end(), Long(0));
+
+    auto sfc = DistributionMapping::makeSFC(ba, true, nprocs);
+    Vector<int> pmap(ba.size());
+    for (int p = 0; p < nprocs; ++p) {
+        for (int ibox : sfc[p]) { pmap[ibox] = p; }
+    }
+    DistributionMapping dm(pmap);
+
+    amrex::Print() << "    Current efficiency " << efficiency(pmap, cost, nprocs) << "\n";
+
+    // Greedy largest-cost-first from scratch, similar to knapsack.
+    {
+        Vector<int> idx(ba.size());
+        std::iota(idx.begin(), idx.end(), 0);
+        std::sort(idx.begin(), idx.end(), [&] (int a, int b) { return cost[a] > cost[b]; });
+        Vector<Real> load(nprocs, 0.0_rt);
+        Vector<int> new_pmap(ba.size());
+        for (int ibox : idx) {
+            const int p = static_cast<int>(std::min_element(load.begin(), load.end()) - load.begin());
+            new_pmap[ibox] = p;
+            load[p] += cost[ibox];
+        }
+        Real eff = efficiency(new_pmap, cost, nprocs);
+        Long moved = DistributionMapping::ComputeMigrationBytes(dm, DistributionMapping(new_pmap),
+                                                                box_bytes);
+        amrex::Print() << "    From scratch: efficiency " << eff << ", moved "
+                       << double(moved)/double(total_bytes)*100. << "% of the data\n";
+    }
+
+    for (double budget : {0.01, 0.05, 0.2, 1.0}) {
+        Real current_eff, proposed_eff;
+        Long moved;
+        auto new_dm = DistributionMapping::makeRebalance(dm, cost, box_bytes,
+                                                         Long(budget*double(total_bytes)),
+                                                         current_eff, proposed_eff, moved, nprocs);
+        AMREX_ALWAYS_ASSERT(moved == DistributionMapping::ComputeMigrationBytes(dm, new_dm, box_bytes));
+        AMREX_ALWAYS_ASSERT(moved <= Long(budget*double(total_bytes)));
+        AMREX_ALWAYS_ASSERT(proposed_eff >= current_eff);
+        amrex::Print() << "    Rebalance with a budget of " << budget*100. << "%: efficiency "
+                       << proposed_eff << ", moved "
+                       << double(moved)/double(total_bytes)*100. << "% of the data\n";
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 256;
+        int max_grid_size = 32;
+        int nghost = 1;
+        Vector<int> nprocs{8, 27, 64};
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nghost", nghost);
+            pp.queryarr("nprocs", nprocs);
+        }
+
+        BoxArray cube(Box(IntVect(0), IntVect(n_cell-1)));
+        cube.maxSize(max_grid_size);
+        BoxArray cube_small(Box(IntVect(0), IntVect(n_cell-1)));
+        cube_small.maxSize(max_grid_size/2);
+        BoxArray sphere = make_sphere_ba(n_cell, max_grid_size/2);
+
+        for (int np : nprocs) {
+            amrex::Print() << "Cube with " << cube.size() << " boxes on " << np << " processes\n";
+            compare(cube, np, nghost);
+            amrex::Print() << "Cube with " << cube_small.size() << " boxes on " << np << " processes\n";
+            compare(cube_small, np, nghost);
+            amrex::Print() << "Sphere with " << sphere.size() << " boxes on " << np << " processes\n";
+            compare(sphere, np, nghost);
+        }
+
+        for (int np : nprocs) {
+            amrex::Print() << "Rebalancing " << cube_small.size() << " boxes on " << np << " processes\n";
+            rebalance(cube_small, np, n_cell);
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,131 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+// Compare the classification of boxes of several sizes with and without
+// interval bounds.  The bounds may only classify more boxes as mixed.
+template <class F>
+int check_box_type (std::string const& name, F const& f, Geometry const& geom)
+{
+    auto gshop = EB2::makeShop(f);
+    static_assert(EB2::IsIntervalBoundable<F>::value, "F must support interval bounds");
+    const Box bounding_box = amrex::surroundingNodes(geom.Domain());
+    int nfail = 0, nboxes = 0, nconservative = 0;
+    for (int box_size : {4, 16, 64}) {
+        BoxList bl(geom.Domain());
+        bl.maxSize(box_size);
+        for (auto const& b : bl) {
+            const Box gbx = amrex::surroundingNodes(amrex::grow(b,1)) & bounding_box;
+            EB2::use_interval_bounds = true;
+            const int t_bounds = gshop.getBoxType(gbx, geom, RunOn::Cpu);
+            EB2::use_interval_bounds = false;
+            const int t_sample = gshop.getBoxType(gbx, geom, RunOn::Cpu);
+            ++nboxes;
+            if (t_bounds != t_sample) {
+                if (t_bounds == gshop.mixedcells) {
+                    ++nconservative;
+                } else {
+                    ++nfail;
+                }
+            }
+        }
+    }
+    EB2::use_interval_bounds = true;
+    amrex::Print() << "    " << name << ": " << nboxes << " boxes, " << nfail
+                   << " failures, " << nconservative << " more conservative\n";
+    return nfail;
+}
+
+// Build the EB with and without interval bounds, and compare the cut
+// boxes and their volume fractions.
+template <class F>
+int bench_build (F const& f, Geometry const& geom)
+{
+    int nfail = 0;
+    Vector<BoxArray> grids;
+    Vector<Real> vol;
+    for (bool use_bounds : {false, true}) {
+        EB2::use_interval_bounds = use_bounds;
+        double t0 = amrex::second();
+        EB2::Build(EB2::makeShop(f), geom, 0, 0);
+        double t1 = amrex::second();
+        const EB2::Level& level = EB2::IndexSpace::top().getLevel(geom);
+        grids.push_back(level.boxArray());
+        MultiFab vfrac(level.boxArray(), level.DistributionMap(), 1, 0);
+        level.fillVolFrac(vfrac, geom);
+        vol.push_back(vfrac.sum());
+        EB2::IndexSpace::clear();
+        amrex::Print() << "    " << (use_bounds ? "interval bounds" : "sampling       ")
+                       << ": EB2::Build " << t1-t0 << " s, "
+                       << level.boxArray().size() << " cut boxes\n";
+    }
+    EB2::use_interval_bounds = true;
+    if (grids[0] != grids[1] || vol[0] != vol[1]) { ++nfail; }
+    return nfail;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int n_cell_bench = 256;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("n_cell_bench", n_cell_bench);
+        }
+
+        auto make_geom = [] (int n)
+        {
+            return Geometry(Box(IntVect(0), IntVect(n-1)),
+                            RealBox({AMREX_D_DECL(0._rt,0._rt,0._rt)},
+                                    {AMREX_D_DECL(1._rt,1._rt,1._rt)}),
+                            CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        };
+        Geometry geom = make_geom(n_cell);
+
+        EB2::SphereIF sphere(0.3_rt, {AMREX_D_DECL(0.51_rt,0.49_rt,0.5_rt)}, false);
+        EB2::BoxIF box({AMREX_D_DECL(0.2_rt,0.3_rt,0.25_rt)},
+                       {AMREX_D_DECL(0.6_rt,0.45_rt,0.7_rt)}, false);
+        EB2::CylinderIF cylinder(0.2_rt, 0.6_rt, 1, {AMREX_D_DECL(0.5_rt,0.5_rt,0.5_rt)}, false);
+        EB2::PlaneIF plane({AMREX_D_DECL(0.5_rt,0.5_rt,0.5_rt)},
+                           {AMREX_D_DECL(1._rt,-0.5_rt,0.25_rt)}, false);
+        EB2::EllipsoidIF ellipsoid({AMREX_D_DECL(0.1_rt,0.2_rt,0.15_rt)},
+                                   {AMREX_D_DECL(0.5_rt,0.5_rt,0.5_rt)}, false);
+
+        int nfail = 0;
+        amrex::Print() << "Comparing box types with interval bounds and sampling\n";
+        nfail += check_box_type("sphere", sphere, geom);
+        nfail += check_box_type("union", EB2::makeUnion(sphere, box), geom);
+        nfail += check_box_type("cylinder and plane",
+                                EB2::makeIntersection(cylinder, EB2::makeComplement(plane)), geom);
+        nfail += check_box_type("transformed",
+                                EB2::translate(EB2::rotate(EB2::scale(EB2::makeDifference(box, ellipsoid),
+                                                                      {AMREX_D_DECL(1.2_rt,0.8_rt,1.1_rt)}),
+                                                           0.3_rt, 2),
+                                               {AMREX_D_DECL(0.05_rt,-0.1_rt,0.02_rt)}), geom);
+        amrex::Print() << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+
+        // A small body in a large domain
+        Geometry geom_bench = make_geom(n_cell_bench);
+        EB2::SphereIF small_sphere(0.05_rt, {AMREX_D_DECL(0.51_rt,0.49_rt,0.5_rt)}, false);
+        amrex::Print() << "Sphere of radius 0.05 in a domain of " << n_cell_bench << " cells\n";
+        nfail += bench_build(small_sphere, geom_bench);
+        amrex::Print() << "Comparing the cut boxes and volume fractions: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,154 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EB_STL_utils.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+// Write a binary STL file of a sphere with about ntri triangles.  The
+// bands at the poles are fans of triangles, and the other bands are
+// quadrilaterals split into two triangles.  The data are written in the
+// native byte order, which is assumed to be little endian.
+Long write_sphere_stl (std::string const& fname, Long ntri, XDim3 const& center,
+                       Real radius)
+{
+    const int ntheta = std::max(3, static_cast<int>(std::lround(std::sqrt(ntri/4.))));
+    const int nphi = 2*ntheta;
+    const Long num_tri = 2*Long(nphi)*(ntheta-1);
+    if (!ParallelDescriptor::IOProcessor()) { return num_tri; }
+
+    auto vertex = [&] (int it, int ip) -> XDim3
+    {
+        const double theta = M_PI*it/ntheta;
+        const double phi = 2.*M_PI*(ip%nphi)/nphi;
+        return XDim3{Real(center.x + radius*std::sin(theta)*std::cos(phi)),
+                     Real(center.y + radius*std::sin(theta)*std::sin(phi)),
+                     Real(center.z + radius*std::cos(theta))};
+    };
+
+    std::ofstream ofs(fname, std::ios::binary);
+    char header[80] = {};
+    ofs.write(header, 80);
+    auto n = static_cast<std::uint32_t>(num_tri);
+    ofs.write((char const*)&n, sizeof(n));
+
+    auto write_tri = [&] (XDim3 const& a, XDim3 b, XDim3 c)
+    {
+        // The normal must point outward.
+        const XDim3 u{b.x-a.x, b.y-a.y, b.z-a.z};
+        const XDim3 v{c.x-b.x, c.y-b.y, c.z-b.z};
+        const XDim3 nrm{u.y*v.z-u.z*v.y, u.z*v.x-u.x*v.z, u.x*v.y-u.y*v.x};
+        if (nrm.x*(a.x-center.x) + nrm.y*(a.y-center.y) + nrm.z*(a.z-center.z) < 0._rt) {
+            std::swap(b, c);
+        }
+        float buf[12] = {0.f, 0.f, 0.f,
+                         float(a.x), float(a.y), float(a.z),
+                         float(b.x), float(b.y), float(b.z),
+                         float(c.x), float(c.y), float(c.z)};
+        ofs.write((char const*)buf, sizeof(buf));
+        std::uint16_t attr = 0;
+        ofs.write((char const*)&attr, sizeof(attr));
+    };
+
+    for (int ip = 0; ip < nphi; ++ip) {
+        write_tri(vertex(0,0), vertex(1,ip), vertex(1,ip+1));
+        for (int it = 1; it < ntheta-1; ++it) {
+            write_tri(vertex(it,ip), vertex(it+1,ip), vertex(it+1,ip+1));
+            write_tri(vertex(it,ip), vertex(it+1,ip+1), vertex(it,ip+1));
+        }
+        write_tri(vertex(ntheta,0), vertex(ntheta-1,ip+1), vertex(ntheta-1,ip));
+    }
+    return num_tri;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        Long max_triangles = 100000;
+        Long max_brute_force = 10000;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("max_triangles", max_triangles);
+            pp.query("max_brute_force", max_brute_force);
+        }
+
+        Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                      RealBox({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)}),
+                      CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(geom.Domain());
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const XDim3 center{0.51_rt, 0.49_rt, 0.5_rt};
+        const Real radius = 0.3_rt;
+        const std::string fname("sphere.stl");
+
+        int nfail = 0;
+        for (Long ntri = 1000; ntri <= max_triangles; ntri *= 10) {
+            const Long num_tri = write_sphere_stl(fname, ntri, center, radius);
+            ParallelDescriptor::Barrier();
+            amrex::Print() << num_tri << " triangles\n";
+
+            Vector<MultiFab> levelset;
+            for (bool use_bvh : {false, true}) {
+                if (!use_bvh && num_tri > max_brute_force) { continue; }
+
+                double t0 = amrex::second();
+                STLtools stl;
+                stl.setUseBVH(use_bvh);
+                stl.read_stl_file(fname, 1._rt, {0._rt,0._rt,0._rt}, 0);
+                double t1 = amrex::second();
+                levelset.emplace_back(amrex::convert(ba,IntVect(1)), dm, 1, 0);
+                stl.fill(levelset.back(), IntVect(0), geom);
+                double t2 = amrex::second();
+
+                ParmParse pp("eb2");
+                pp.add("geom_type", std::string("stl"));
+                pp.add("stl_file", fname);
+                pp.add("stl_use_bvh", use_bvh);
+                EB2::Build(geom, 0, 0);
+                double t3 = amrex::second();
+
+                // The volume inside the sphere
+                auto factory = makeEBFabFactory(geom, ba, dm, {1,1,1}, EBSupport::volume);
+                Real vol = (geom.Domain().d_numPts() - factory->getVolFrac().sum())
+                    * AMREX_D_TERM(geom.CellSize(0),*geom.CellSize(1),*geom.CellSize(2));
+                Real exact = 4._rt/3._rt*Real(M_PI)*radius*radius*radius;
+                if (std::abs(vol-exact) > 0.05_rt*exact) { ++nfail; }
+                factory.reset();
+                EB2::IndexSpace::clear();
+
+                amrex::Print() << "    " << (use_bvh ? "bvh" : "all")
+                               << ": read " << t1-t0 << " s, fill " << t2-t1
+                               << " s, EB2::Build " << t3-t2 << " s, volume error "
+                               << (vol-exact)/exact << "\n";
+            }
+
+            if (levelset.size() == 2) {
+                MultiFab::Subtract(levelset[0], levelset[1], 0, 0, 1, 0);
+                if (levelset[0].norm0() != 0._rt) { ++nfail; }
+            }
+        }
+
+        amrex::Print() << "Comparing the BVH with testing all triangles: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
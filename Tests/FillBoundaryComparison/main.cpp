@@ -1,6 +1,7 @@
 #include <AMReX_Utility.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_FabArrayCommPlan.H>
 #include <AMReX_ParmParse.H>
 
 #include <algorithm>
@@ -162,6 +163,126 @@ main (int argc, char* argv[])
         std::cout << "ignore this line " << err << std::endl;
     }
 
+    // Number of FillBoundary calls per timing loop, for reporting latency.
+    const double ncalls = double(nrounds)*4*nlevels;
+    if (ParallelDescriptor::IOProcessor()) {
+        std::cout << "Fill Boundary Latency (us): " << (wt1-wt0)/ncalls*1.e6 << std::endl;
+        std::cout << "----------------------------------------------" << std::endl;
+    }
+
+    //
+    // Now do the same with MPI_Ineighbor_alltoallv.
+    //
+    const bool fb_neighbor_collective = FabArrayBase::fb_neighbor_collective;
+    FabArrayBase::fb_neighbor_collective = true;
+
+    ParallelDescriptor::Barrier();
+    wt0 = ParallelDescriptor::second();
+
+    for (int iround = 0; iround < nrounds; ++iround) {
+        for (int c=0; c<2; ++c) {
+            for (int lev = 0; lev < nlevels; ++lev) {
+                mfs[lev]->FillBoundary_nowait();
+                mfs[lev]->FillBoundary_finish();
+            }
+            for (int lev = nlevels-1; lev >= 0; --lev) {
+                mfs[lev]->FillBoundary_nowait();
+                mfs[lev]->FillBoundary_finish();
+            }
+        }
+        Real e = double(iround+ParallelDescriptor::MyProc());
+        ParallelDescriptor::ReduceRealMax(e);
+        err += e;
+    }
+
+    ParallelDescriptor::Barrier();
+    wt1 = ParallelDescriptor::second();
+
+    FabArrayBase::fb_neighbor_collective = fb_neighbor_collective;
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::cout << "Fill Boundary Time with neighbor collective: " << wt1-wt0 << std::endl;
+        std::cout << "Fill Boundary Latency (us) with neighbor collective: "
+                  << (wt1-wt0)/ncalls*1.e6 << std::endl;
+        std::cout << "----------------------------------------------" << std::endl;
+    }
+
+    //
+    // Now do the same with persistent plans that are set up only once.
+    //
+    Vector<std::unique_ptr<FillBoundaryPlan<FArrayBox> > > plans(nlevels);
+    for (int lev = 0; lev < nlevels; ++lev) {
+        plans[lev] = std::make_unique<FillBoundaryPlan<FArrayBox> >
+            (*mfs[lev], 0, mfs[lev]->nComp(), mfs[lev]->nGrowVect());
+    }
+
+    ParallelDescriptor::Barrier();
+    wt0 = ParallelDescriptor::second();
+
+    for (int iround = 0; iround < nrounds; ++iround) {
+        for (int c=0; c<2; ++c) {
+            for (int lev = 0; lev < nlevels; ++lev) {
+                plans[lev]->FillBoundary_nowait();
+                plans[lev]->FillBoundary_finish();
+            }
+            for (int lev = nlevels-1; lev >= 0; --lev) {
+                plans[lev]->FillBoundary_nowait();
+                plans[lev]->FillBoundary_finish();
+            }
+        }
+        Real e = double(iround+ParallelDescriptor::MyProc());
+        ParallelDescriptor::ReduceRealMax(e);
+        err += e;
+    }
+
+    ParallelDescriptor::Barrier();
+    wt1 = ParallelDescriptor::second();
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::cout << "Fill Boundary Time with plans: " << wt1-wt0 << std::endl;
+        std::cout << "Fill Boundary Latency (us) with plans: " << (wt1-wt0)/ncalls*1.e6 << std::endl;
+        std::cout << "----------------------------------------------" << std::endl;
+    }
+
+    // Check that the neighbor collective and the plan give the same answer
+    // as FillBoundary.
+    {
+        MultiFab& mf = *mfs[0];
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            auto const& a = mf.array(mfi);
+            amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                a(i,j,k) = Real(i) + Real(j)*1.e3 + Real(k)*1.e6;
+            });
+        }
+        mf.setBndry(-1.0);
+        mf.FillBoundary();
+        MultiFab mf2(mf.boxArray(), mf.DistributionMap(), mf.nComp(), mf.nGrowVect());
+        MultiFab::Copy(mf2, mf, 0, 0, mf.nComp(), mf.nGrowVect());
+
+        FabArrayBase::fb_neighbor_collective = true;
+        mf.setBndry(-1.0);
+        mf.FillBoundary();
+        FabArrayBase::fb_neighbor_collective = fb_neighbor_collective;
+        MultiFab mf3(mf.boxArray(), mf.DistributionMap(), mf.nComp(), mf.nGrowVect());
+        MultiFab::Copy(mf3, mf, 0, 0, mf.nComp(), mf.nGrowVect());
+        MultiFab::Subtract(mf3, mf2, 0, 0, mf.nComp(), mf.nGrowVect());
+        Real diff_nbr = mf3.norm0(0, mf.nComp(), mf.nGrowVect());
+
+        mf.setBndry(-1.0);
+        plans[0]->FillBoundary();
+        MultiFab::Subtract(mf2, mf, 0, 0, mf.nComp(), mf.nGrowVect());
+        Real diff = mf2.norm0(0, mf.nComp(), mf.nGrowVect());
+        if (ParallelDescriptor::IOProcessor()) {
+            std::cout << "Max difference between FillBoundary and neighbor collective: "
+                      << diff_nbr << std::endl;
+            std::cout << "Max difference between FillBoundary and plan: " << diff << std::endl;
+        }
+        AMREX_ALWAYS_ASSERT(diff_nbr == 0.0 && diff == 0.0);
+    }
+
+    plans.clear();
+
     //
     // When MPI3 shared memory is used, the dtor of MultiFab calls MPI
     // functions.  Because the scope of mfs is beyond the call to
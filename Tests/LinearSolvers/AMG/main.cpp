@@ -0,0 +1,192 @@
+#include <AMReX.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <utility>
+
+using namespace amrex;
+
+namespace {
+
+void init_rhs (MultiFab& rhs, Geometry const& geom)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = rhs.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = problo[idim] + (iv[idim]+0.5_rt)*dx[idim];
+                f *= std::cos(2._rt*Real(M_PI)*x) + 0.5_rt*std::sin(Real(M_PI)*x);
+            }
+            a(i,j,k) = f;
+        });
+    }
+}
+
+// The coefficient jumps by a factor of jump across the faces of a cube in
+// the middle of the domain.
+void init_bcoef (MultiFab& bcoef, Geometry const& geom, Real jump)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const IntVect nodal = bcoef.ixType().toIntVect();
+    for (MFIter mfi(bcoef); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = bcoef.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            bool inside = true;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = problo[idim] + (iv[idim]+0.5_rt*(1-nodal[idim]))*dx[idim];
+                inside = inside && x > 0.3_rt && x < 0.7_rt;
+            }
+            a(i,j,k) = inside ? jump : 1._rt;
+        });
+    }
+}
+
+// Solve with bicgstab and AMG as the bottom solver, and compare the
+// solutions, the number of bottom iterations and the bottom time.
+template <class LinOp>
+int compare_bottom_solvers (std::string const& name, LinOp& linop,
+                            MultiFab& sol, MultiFab const& rhs, int nrepeat,
+                            int verbose, int bottom_verbose)
+{
+    const Vector<std::pair<BottomSolver,std::string>> bottom_solvers
+        {{BottomSolver::bicgstab, "bicgstab"},
+         {BottomSolver::amg,      "amg     "}};
+
+    amrex::Print() << name << "\n";
+    int nfail = 0;
+    MultiFab sol0(sol.boxArray(), sol.DistributionMap(), 1, 0);
+    for (auto const& bs : bottom_solvers) {
+        double t = 0., tbottom = 0.;
+        Long nbottom = 0;
+        int niters = 0;
+        for (int irep = 0; irep < nrepeat; ++irep) {
+            sol.setVal(0.0);
+            MLMG mlmg(linop);
+            mlmg.setBottomSolver(bs.first);
+            mlmg.setBottomMaxIter(1000);
+            mlmg.setVerbose(verbose);
+            mlmg.setBottomVerbose(bottom_verbose);
+            ParallelDescriptor::Barrier();
+            double t0 = amrex::second();
+            mlmg.solve({&sol}, {&rhs}, 1.e-10, 0.0);
+            t += amrex::second() - t0;
+            tbottom += mlmg.getBottomTime();
+            auto const& niters_cg = mlmg.getNumCGIters();
+            nbottom += std::accumulate(niters_cg.begin(), niters_cg.end(), Long(0));
+            niters = mlmg.getNumIters();
+        }
+        ParallelDescriptor::ReduceRealMax(t);
+        ParallelDescriptor::ReduceRealMax(tbottom);
+        amrex::Print() << "    " << bs.second << ": " << niters << " MLMG iterations, "
+                       << nbottom/nrepeat << " bottom iterations, "
+                       << t/nrepeat << " s per solve, "
+                       << tbottom/nrepeat << " s in bottom solves\n";
+        if (bs.first == BottomSolver::bicgstab) {
+            MultiFab::Copy(sol0, sol, 0, 0, 1, 0);
+        } else {
+            // The solution of the singular problem is unique up to a constant.
+            MultiFab::Subtract(sol, sol0, 0, 0, 1, 0);
+            sol.plus(-sol.sum()/Real(sol.boxArray().numPts()), 0, 1);
+            if (sol.norm0() > 1.e-8_rt*sol0.norm0()) { ++nfail; }
+        }
+    }
+    return nfail;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int max_coarsening_level = 2;
+        int nrepeat = 2;
+        int verbose = 0;
+        int bottom_verbose = 0;
+        Real jump = 1.e3;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("max_coarsening_level", max_coarsening_level);
+            pp.query("nrepeat", nrepeat);
+            pp.query("verbose", verbose);
+            pp.query("bottom_verbose", bottom_verbose);
+            pp.query("jump", jump);
+        }
+
+        const RealBox rb({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)});
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        // Stop coarsening early so that the bottom solve dominates.
+        LPInfo info;
+        info.setMaxCoarseningLevel(max_coarsening_level);
+        info.setAgglomeration(false);
+        info.setConsolidation(false);
+
+        MultiFab sol(ba, dm, 1, 1);
+        MultiFab rhs(ba, dm, 1, 0);
+
+        int nfail = 0;
+        {
+            Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+            init_rhs(rhs, geom);
+            const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                                    LinOpBCType::Dirichlet,
+                                                                    LinOpBCType::Neumann)};
+            Array<MultiFab,AMREX_SPACEDIM> bcoef;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+                init_bcoef(bcoef[idim], geom, jump);
+            }
+            MLABecLaplacian linop({geom}, {ba}, {dm}, info);
+            linop.setDomainBC(bc, bc);
+            linop.setLevelBC(0, nullptr);
+            linop.setScalars(0.0, 1.0);
+            linop.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+            nfail += compare_bottom_solvers("ABecLaplacian with a coefficient jump", linop, sol, rhs,
+                                            nrepeat, verbose, bottom_verbose);
+        }
+        {
+            // Singular, and periodic in the first direction
+            Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(1,0,0)});
+            init_rhs(rhs, geom);
+            const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Periodic,
+                                                                    LinOpBCType::Neumann,
+                                                                    LinOpBCType::Neumann)};
+            MLPoisson linop({geom}, {ba}, {dm}, info);
+            linop.setDomainBC(bc, bc);
+            linop.setLevelBC(0, nullptr);
+            nfail += compare_bottom_solvers("Singular Poisson", linop, sol, rhs,
+                                            nrepeat, verbose, bottom_verbose);
+        }
+
+        amrex::Print() << "Comparing the solutions: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
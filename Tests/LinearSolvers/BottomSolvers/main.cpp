@@ -0,0 +1,162 @@
+#include <AMReX.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLNodeLaplacian.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <utility>
+
+using namespace amrex;
+
+namespace {
+
+void init_rhs (MultiFab& rhs, Geometry const& geom)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const IntVect nodal = rhs.ixType().toIntVect();
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = rhs.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = problo[idim] + (iv[idim]+0.5_rt*(1-nodal[idim]))*dx[idim];
+                f *= std::sin(Real(M_PI)*x) + 0.5_rt*std::sin(Real(3.*M_PI)*x);
+            }
+            a(i,j,k) = f;
+        });
+    }
+}
+
+// Solve with each bottom solver and compare the solutions, the number of
+// bottom iterations and the time per bottom iteration.
+template <class LinOp>
+int compare_bottom_solvers (std::string const& name, LinOp& linop,
+                            MultiFab& sol, MultiFab const& rhs, int nrepeat,
+                            int verbose, int bottom_verbose)
+{
+    const Vector<std::pair<BottomSolver,std::string>> bottom_solvers
+        {{BottomSolver::bicgstab,     "bicgstab    "},
+         {BottomSolver::pipebicgstab, "pipebicgstab"},
+         {BottomSolver::cg,           "cg          "},
+         {BottomSolver::pipecg,       "pipecg      "}};
+
+    amrex::Print() << name << "\n";
+    int nfail = 0;
+    MultiFab sol0(sol.boxArray(), sol.DistributionMap(), 1, 0);
+    for (auto const& bs : bottom_solvers) {
+        double t = 0., tbottom = 0.;
+        Long nbottom = 0;
+        int niters = 0;
+        for (int irep = 0; irep < nrepeat; ++irep) {
+            sol.setVal(0.0);
+            MLMG mlmg(linop);
+            mlmg.setBottomSolver(bs.first);
+            mlmg.setBottomMaxIter(1000);
+            mlmg.setVerbose(verbose);
+            mlmg.setBottomVerbose(bottom_verbose);
+            ParallelDescriptor::Barrier();
+            double t0 = amrex::second();
+            mlmg.solve({&sol}, {&rhs}, 1.e-10, 0.0);
+            t += amrex::second() - t0;
+            tbottom += mlmg.getBottomTime();
+            auto const& niters_cg = mlmg.getNumCGIters();
+            nbottom += std::accumulate(niters_cg.begin(), niters_cg.end(), Long(0));
+            niters = mlmg.getNumIters();
+        }
+        ParallelDescriptor::ReduceRealMax(t);
+        ParallelDescriptor::ReduceRealMax(tbottom);
+        amrex::Print() << "    " << bs.second << ": " << niters << " MLMG iterations, "
+                       << nbottom/nrepeat << " bottom iterations, "
+                       << t/nrepeat << " s per solve, "
+                       << tbottom/amrex::max(nbottom,Long(1)) << " s per bottom iteration\n";
+        if (bs.first == BottomSolver::bicgstab) {
+            MultiFab::Copy(sol0, sol, 0, 0, 1, 0);
+        } else {
+            MultiFab::Subtract(sol, sol0, 0, 0, 1, 0);
+            if (sol.norm0() > 1.e-8_rt*sol0.norm0()) { ++nfail; }
+        }
+    }
+    return nfail;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int max_coarsening_level = 2;
+        int nrepeat = 2;
+        int verbose = 0;
+        int bottom_verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("max_coarsening_level", max_coarsening_level);
+            pp.query("nrepeat", nrepeat);
+            pp.query("verbose", verbose);
+            pp.query("bottom_verbose", bottom_verbose);
+        }
+
+        Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                      RealBox({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)}),
+                      CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(geom.Domain());
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        // Stop coarsening early so that the bottom solve dominates.
+        LPInfo info;
+        info.setMaxCoarseningLevel(max_coarsening_level);
+        info.setAgglomeration(false);
+        info.setConsolidation(false);
+
+        const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                                LinOpBCType::Dirichlet,
+                                                                LinOpBCType::Dirichlet)};
+        int nfail = 0;
+        {
+            MLPoisson linop({geom}, {ba}, {dm}, info);
+            // The operator is symmetric with linear extrapolation at the
+            // Dirichlet boundaries.
+            linop.setMaxOrder(2);
+            linop.setDomainBC(bc, bc);
+            linop.setLevelBC(0, nullptr);
+            MultiFab sol(ba, dm, 1, 1);
+            MultiFab rhs(ba, dm, 1, 0);
+            init_rhs(rhs, geom);
+            nfail += compare_bottom_solvers("Cell-centered Poisson", linop, sol, rhs, nrepeat,
+                                            verbose, bottom_verbose);
+        }
+        {
+            const BoxArray& nba = amrex::convert(ba, IntVect(1));
+            MLNodeLaplacian linop({geom}, {ba}, {dm}, info);
+            linop.setDomainBC(bc, bc);
+            MultiFab sigma(ba, dm, 1, 1);
+            sigma.setVal(1.0);
+            linop.setSigma(0, sigma);
+            MultiFab sol(nba, dm, 1, 1);
+            MultiFab rhs(nba, dm, 1, 0);
+            init_rhs(rhs, geom);
+            nfail += compare_bottom_solvers("Nodal Poisson", linop, sol, rhs, nrepeat,
+                                            verbose, bottom_verbose);
+        }
+
+        amrex::Print() << "Comparing the solutions: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
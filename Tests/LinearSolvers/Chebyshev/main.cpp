@@ -0,0 +1,147 @@
+#include <AMReX.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <string>
+#include <utility>
+
+using namespace amrex;
+
+namespace {
+
+void init_mf (MultiFab& mf, Geometry const& geom, Real a0, Real a1, Real freq)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const IntVect nodal = mf.ixType().toIntVect();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = problo[idim] + (iv[idim]+0.5_rt*(1-nodal[idim]))*dx[idim];
+                f *= std::sin(freq*Real(M_PI)*x);
+            }
+            a(i,j,k) = a0 + a1*f;
+        });
+    }
+}
+
+// Solve with red-black Gauss-Seidel and Chebyshev smoothers, and compare
+// the solutions and the number of digits of residual reduction per second.
+template <class LinOp>
+int compare_smoothers (std::string const& name, LinOp& linop, MultiFab& sol,
+                       MultiFab const& rhs, int nrepeat, int verbose)
+{
+    const Vector<std::pair<int,std::string>> smoothers
+        {{0, "gsrb       "}, {2, "chebyshev 2"}, {3, "chebyshev 3"}, {4, "chebyshev 4"}};
+
+    amrex::Print() << name << "\n";
+    int nfail = 0;
+    MultiFab sol0(sol.boxArray(), sol.DistributionMap(), 1, 0);
+    for (auto const& s : smoothers) {
+        double t = 0.;
+        int niters = 0;
+        Real reduction = 0.;
+        for (int irep = 0; irep < nrepeat; ++irep) {
+            sol.setVal(0.0);
+            MLMG mlmg(linop);
+            if (s.first > 0) {
+                mlmg.setSmoother(LinOpSmoother::chebyshev);
+                mlmg.setChebyshevDegree(s.first);
+            }
+            mlmg.setVerbose(verbose);
+            ParallelDescriptor::Barrier();
+            double t0 = amrex::second();
+            mlmg.solve({&sol}, {&rhs}, 1.e-10, 0.0);
+            t += amrex::second() - t0;
+            niters = mlmg.getNumIters();
+            auto const& hist = mlmg.getResidualHistory();
+            reduction = hist.back();
+        }
+        ParallelDescriptor::ReduceRealMax(t);
+        t /= nrepeat;
+        amrex::Print() << "    " << s.second << ": " << niters << " MLMG iterations, "
+                       << "convergence factor " << std::pow(reduction, 1._rt/niters) << ", "
+                       << t << " s per solve, "
+                       << -std::log10(reduction)/t << " digits per second\n";
+        if (s.first == 0) {
+            MultiFab::Copy(sol0, sol, 0, 0, 1, 0);
+        } else {
+            MultiFab::Subtract(sol, sol0, 0, 0, 1, 0);
+            if (sol.norm0() > 1.e-8_rt*sol0.norm0()) { ++nfail; }
+        }
+    }
+    return nfail;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int nrepeat = 2;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nrepeat", nrepeat);
+            pp.query("verbose", verbose);
+        }
+
+        Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                      RealBox({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)}),
+                      CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(geom.Domain());
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                                LinOpBCType::Neumann,
+                                                                LinOpBCType::Dirichlet)};
+        MultiFab sol(ba, dm, 1, 1);
+        MultiFab rhs(ba, dm, 1, 0);
+        init_mf(rhs, geom, 0._rt, 1._rt, 1._rt);
+
+        int nfail = 0;
+        {
+            MLPoisson linop({geom}, {ba}, {dm});
+            linop.setDomainBC(bc, bc);
+            linop.setLevelBC(0, nullptr);
+            nfail += compare_smoothers("Poisson", linop, sol, rhs, nrepeat, verbose);
+        }
+        {
+            MultiFab acoef(ba, dm, 1, 0);
+            init_mf(acoef, geom, 1._rt, 0.5_rt, 2._rt);
+            Array<MultiFab,AMREX_SPACEDIM> bcoef;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+                init_mf(bcoef[idim], geom, 1._rt, 0.9_rt, 3._rt);
+            }
+            MLABecLaplacian linop({geom}, {ba}, {dm});
+            linop.setDomainBC(bc, bc);
+            linop.setLevelBC(0, nullptr);
+            linop.setScalars(1.0, 1.0);
+            linop.setACoeffs(0, acoef);
+            linop.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+            nfail += compare_smoothers("ABecLaplacian", linop, sol, rhs, nrepeat, verbose);
+        }
+
+        amrex::Print() << "Comparing the solutions: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
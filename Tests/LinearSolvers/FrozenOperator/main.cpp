@@ -0,0 +1,134 @@
+#include <AMReX.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <memory>
+
+using namespace amrex;
+
+namespace {
+
+void init_mf (MultiFab& mf, Geometry const& geom, Real a0, Real a1, Real freq)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const IntVect nodal = mf.ixType().toIntVect();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = problo[idim] + (iv[idim]+0.5_rt*(1-nodal[idim]))*dx[idim];
+                f *= std::sin(freq*Real(M_PI)*x);
+            }
+            a(i,j,k) = a0 + a1*f;
+        });
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int nsteps = 6;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nsteps", nsteps);
+            pp.query("verbose", verbose);
+        }
+
+        Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                      RealBox({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)}),
+                      CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(geom.Domain());
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                                LinOpBCType::Neumann,
+                                                                LinOpBCType::Dirichlet)};
+
+        MultiFab acoef(ba, dm, 1, 0);
+        init_mf(acoef, geom, 1._rt, 0.5_rt, 2._rt);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+            init_mf(bcoef[idim], geom, 1._rt, 0.9_rt, 3._rt);
+        }
+
+        // The same sequence of solves with a new MLMG in every step, once
+        // with the setup rebuilt every time and once with a frozen operator.
+        // The coefficients are set again in every step, and they change
+        // halfway through.
+        const bool frozen[2] = {false, true};
+        std::unique_ptr<MLABecLaplacian> linop[2];
+        MultiFab sol[2];
+        double tsetup[2] = {0., 0.};
+        double tsolve[2] = {0., 0.};
+        for (int i = 0; i < 2; ++i) {
+            LPInfo info;
+            info.setMaxCoarseningLevel(2);
+            info.setFrozenOperator(frozen[i]);
+            linop[i] = std::make_unique<MLABecLaplacian>(Vector<Geometry>{geom},
+                                                         Vector<BoxArray>{ba},
+                                                         Vector<DistributionMapping>{dm},
+                                                         info);
+            linop[i]->setDomainBC(bc, bc);
+            linop[i]->setLevelBC(0, nullptr);
+            sol[i].define(ba, dm, 1, 1);
+            sol[i].setVal(0.0);
+        }
+
+        MultiFab rhs(ba, dm, 1, 0);
+        int nfail = 0;
+        for (int step = 0; step < nsteps; ++step) {
+            if (step == nsteps/2) {
+                for (auto& b : bcoef) { b.mult(2.0); }
+            }
+            init_mf(rhs, geom, 0._rt, 1._rt+Real(step), 1._rt);
+            for (int i = 0; i < 2; ++i) {
+                linop[i]->setScalars(1.0, 1.0);
+                linop[i]->setACoeffs(0, acoef);
+                linop[i]->setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+                MLMG mlmg(*linop[i]);
+                mlmg.setBottomSolver(BottomSolver::amg);
+                mlmg.setVerbose(verbose);
+                ParallelDescriptor::Barrier();
+                double t0 = amrex::second();
+                mlmg.solve({&sol[i]}, {&rhs}, 1.e-10, 0.0);
+                tsolve[i] += amrex::second() - t0;
+                tsetup[i] += mlmg.getSetupTime();
+            }
+            MultiFab::Subtract(sol[1], sol[0], 0, 0, 1, 0);
+            if (sol[1].norm0() > 1.e-8_rt*sol[0].norm0()) { ++nfail; }
+            MultiFab::Copy(sol[1], sol[0], 0, 0, 1, 0);
+        }
+
+        for (int i = 0; i < 2; ++i) {
+            ParallelDescriptor::ReduceRealMax(tsetup[i]);
+            ParallelDescriptor::ReduceRealMax(tsolve[i]);
+            amrex::Print() << (frozen[i] ? "frozen  " : "rebuilt ") << ": "
+                           << tsetup[i]/nsteps << " s setup, "
+                           << tsolve[i]/nsteps << " s per solve\n";
+        }
+
+        amrex::Print() << "Comparing the solutions: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
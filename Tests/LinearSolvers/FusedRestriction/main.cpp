@@ -0,0 +1,191 @@
+#include <AMReX.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <memory>
+
+using namespace amrex;
+
+namespace {
+
+AMREX_GPU_HOST_DEVICE
+Real smooth_fn (GpuArray<Real,AMREX_SPACEDIM> const& x, Real k) noexcept
+{
+    Real f = 1._rt;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        f *= std::sin(k*Real(M_PI)*x[idim]);
+    }
+    return f;
+}
+
+void init_mf (MultiFab& mf, Geometry const& geom, Real a0, Real a1, Real k)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const IntVect nodal = mf.ixType().toIntVect();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k_) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k_));
+            GpuArray<Real,AMREX_SPACEDIM> x;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                x[idim] = problo[idim] + (iv[idim]+0.5_rt*(1-nodal[idim]))*dx[idim];
+            }
+            a(i,j,k_) = a0 + a1*smooth_fn(x, k);
+        });
+    }
+}
+
+// Modeled memory traffic of computing the residual of the correction and
+// restricting it to the next coarser MG level, for ncells fine cells.
+// ncoef is the number of coefficient arrays read by the operator per cell.
+// Ghost cells and caches are ignored.
+double modeled_bytes (Long ncells, int ncoef, bool fused)
+{
+    const double n = static_cast<double>(ncells);
+    const double ncrse = n / AMREX_D_TERM(2.,*2.,*2.);
+    if (fused) {
+        // read cor, res and coefficients; write the coarse res
+        return ((2.+ncoef)*n + ncrse) * sizeof(Real);
+    } else {
+        // apply: read cor and coefficients, write rescor
+        // xpay: read rescor and res, write rescor
+        // restriction: read rescor, write the coarse res
+        return ((2.+ncoef)*n + 3.*n + n + ncrse) * sizeof(Real);
+    }
+}
+
+// Time the residual and restriction on the finest MG level alone
+double time_restriction (MLLinOp& linop, MultiFab& cor, MultiFab const& res, bool fused,
+                         int nrepeat)
+{
+    BoxArray const& ba = cor.boxArray();
+    DistributionMapping const& dm = cor.DistributionMap();
+    MultiFab rescor(ba, dm, 1, 0);
+    MultiFab crse_res(amrex::coarsen(ba,2), dm, 1, 0);
+    ParallelDescriptor::Barrier();
+    double t0 = amrex::second();
+    for (int irep = 0; irep < nrepeat; ++irep) {
+        if (fused) {
+            bool r = linop.correctionResidualRestriction(0, 0, crse_res, cor, res);
+            AMREX_ALWAYS_ASSERT(r);
+        } else {
+            linop.correctionResidual(0, 0, rescor, cor, res, MLLinOp::BCMode::Homogeneous);
+            linop.restriction(0, 1, crse_res, rescor);
+        }
+    }
+    double t = amrex::second() - t0;
+    ParallelDescriptor::ReduceRealMax(t);
+    return t / nrepeat;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int ncycles = 10;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncycles", ncycles);
+            pp.query("verbose", verbose);
+        }
+
+        Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                      RealBox({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)}),
+                      CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(geom.Domain());
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab rhs(ba, dm, 1, 0);
+        init_mf(rhs, geom, 0._rt, 1._rt, 1._rt);
+        MultiFab acoef(ba, dm, 1, 0);
+        init_mf(acoef, geom, 1._rt, 0.5_rt, 2._rt);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+            init_mf(bcoef[idim], geom, 1._rt, 0.9_rt, 3._rt);
+        }
+
+        const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                                LinOpBCType::Neumann,
+                                                                LinOpBCType::Dirichlet)};
+
+        int nfail = 0;
+        for (int iop = 0; iop < 2; ++iop) {
+            std::unique_ptr<MLLinOp> linop;
+            int ncoef;
+            if (iop == 0) {
+                auto abeclap = std::make_unique<MLABecLaplacian>(Vector<Geometry>{geom},
+                                                                 Vector<BoxArray>{ba},
+                                                                 Vector<DistributionMapping>{dm});
+                abeclap->setDomainBC(bc, bc);
+                abeclap->setLevelBC(0, nullptr);
+                abeclap->setScalars(1.0, 1.0);
+                abeclap->setACoeffs(0, acoef);
+                abeclap->setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+                linop = std::move(abeclap);
+                ncoef = 1 + AMREX_SPACEDIM;
+                amrex::Print() << "MLABecLaplacian\n";
+            } else {
+                auto poisson = std::make_unique<MLPoisson>(Vector<Geometry>{geom},
+                                                           Vector<BoxArray>{ba},
+                                                           Vector<DistributionMapping>{dm});
+                poisson->setDomainBC(bc, bc);
+                poisson->setLevelBC(0, nullptr);
+                linop = std::move(poisson);
+                ncoef = 0;
+                amrex::Print() << "MLPoisson\n";
+            }
+
+            MultiFab sol0(ba, dm, 1, 0);
+            for (bool fused : {false, true}) {
+                MultiFab sol(ba, dm, 1, 1);
+                sol.setVal(0.0);
+                MLMG mlmg(*linop);
+                mlmg.setVerbose(verbose);
+                mlmg.setFixedIter(ncycles);
+                mlmg.setFuseKernels(fused);
+                ParallelDescriptor::Barrier();
+                double t0 = amrex::second();
+                mlmg.solve({&sol}, {&rhs}, 1.e-12, 0.0);
+                double t = amrex::second() - t0;
+                ParallelDescriptor::ReduceRealMax(t);
+
+                // The solution is a good enough correction for the timing
+                const double tr = time_restriction(*linop, sol, rhs, fused, ncycles);
+                const double gb = modeled_bytes(ba.numPts(), ncoef, fused) / 1.e9;
+                amrex::Print() << (fused ? "    fused:   " : "    unfused: ")
+                               << t/ncycles << " s per V-cycle; residual and restriction on "
+                               << "the finest level: " << tr << " s, " << gb*1.e3 << " MB, "
+                               << gb/tr << " GB/s\n";
+
+                if (fused) {
+                    MultiFab::Subtract(sol, sol0, 0, 0, 1, 0);
+                    if (sol.norm0() > 1.e-10_rt*sol0.norm0()) { ++nfail; }
+                } else {
+                    MultiFab::Copy(sol0, sol, 0, 0, 1, 0);
+                }
+            }
+        }
+
+        amrex::Print() << "Comparing the solutions: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
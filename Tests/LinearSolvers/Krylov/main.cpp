@@ -0,0 +1,209 @@
+#include <AMReX.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLKrylovSolver.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void init_rhs (MultiFab& rhs, Geometry const& geom)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = rhs.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = problo[idim] + (iv[idim]+0.5_rt)*dx[idim];
+                f *= std::sin(2._rt*Real(M_PI)*x);
+            }
+            a(i,j,k) = f;
+        });
+    }
+}
+
+// Inclusions where the coefficient is larger by a factor of jump
+void init_bcoef (MultiFab& bcoef, Geometry const& geom, Real jump)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const IntVect nodal = bcoef.ixType().toIntVect();
+    for (MFIter mfi(bcoef); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = bcoef.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = problo[idim] + (iv[idim]+0.5_rt*(1-nodal[idim]))*dx[idim];
+                f *= std::sin(6._rt*Real(M_PI)*x);
+            }
+            a(i,j,k) = (f > 0.3_rt) ? jump : 1._rt;
+        });
+    }
+}
+
+// Inhomogeneous Dirichlet boundary values in the ghost cells
+void init_bcdata (MultiFab& bcdata, Geometry const& geom)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(bcdata); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.fabbox();
+        Array4<Real> const& a = bcdata.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                f += problo[idim] + (iv[idim]+0.5_rt)*dx[idim];
+            }
+            a(i,j,k) = f;
+        });
+    }
+}
+
+// Solve with stand-alone MLMG (if it converges for this problem), and with
+// MLMG preconditioned FGMRES and CG.  Compare the solutions and the number
+// of iterations.
+int solve_problem (Real jump, bool with_mlmg, int n_cell, int max_grid_size, int verbose)
+{
+    amrex::Print() << "Coefficient jump of " << jump << "\n";
+
+    // Two AMR levels, the fine one covering the middle of the domain
+    const int nlevels = 2;
+    const int ref_ratio = 2;
+    Vector<Geometry> geom(nlevels);
+    Vector<BoxArray> grids(nlevels);
+    Vector<DistributionMapping> dmap(nlevels);
+    {
+        const RealBox rb({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)});
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        geom[0].define(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        geom[1].define(amrex::refine(domain, ref_ratio), rb, CoordSys::cartesian,
+                       {AMREX_D_DECL(0,0,0)});
+        grids[0].define(domain);
+        grids[1].define(amrex::refine(Box(IntVect(n_cell/4), IntVect(3*n_cell/4-1)), ref_ratio));
+        for (int lev = 0; lev < nlevels; ++lev) {
+            grids[lev].maxSize(max_grid_size);
+            dmap[lev].define(grids[lev]);
+        }
+    }
+
+    const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                            LinOpBCType::Neumann,
+                                                            LinOpBCType::Dirichlet)};
+    MLABecLaplacian linop(geom, grids, dmap);
+    linop.setDomainBC(bc, bc);
+    linop.setScalars(0.0, 1.0);
+
+    Vector<MultiFab> sol(nlevels), rhs(nlevels), res(nlevels), sol0(nlevels);
+    for (int lev = 0; lev < nlevels; ++lev) {
+        sol[lev].define(grids[lev], dmap[lev], 1, 1);
+        sol0[lev].define(grids[lev], dmap[lev], 1, 0);
+        rhs[lev].define(grids[lev], dmap[lev], 1, 0);
+        res[lev].define(grids[lev], dmap[lev], 1, 0);
+        init_rhs(rhs[lev], geom[lev]);
+
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(grids[lev], IntVect::TheDimensionVector(idim)),
+                               dmap[lev], 1, 0);
+            init_bcoef(bcoef[idim], geom[lev], jump);
+        }
+        linop.setBCoeffs(lev, amrex::GetArrOfConstPtrs(bcoef));
+    }
+    MultiFab bcdata(grids[0], dmap[0], 1, 1);
+    init_bcdata(bcdata, geom[0]);
+    linop.setLevelBC(0, &bcdata);
+    linop.setLevelBC(1, nullptr);
+
+    MLMG mlmg(linop);
+    mlmg.setVerbose(verbose);
+    mlmg.setMaxIter(200);
+
+    const Real tol = 1.e-10;
+    int nfail = 0;
+    bool has_reference = false;
+    for (int isolver = with_mlmg ? 0 : 1; isolver < 3; ++isolver) {
+        for (auto& mf : sol) { mf.setVal(0.0); }
+        ParallelDescriptor::Barrier();
+        double t0 = amrex::second();
+        int niters;
+        std::string name;
+        if (isolver == 0) {
+            name = "MLMG  ";
+            mlmg.solve(amrex::GetVecOfPtrs(sol), amrex::GetVecOfConstPtrs(rhs), tol, 0.0);
+            niters = mlmg.getNumIters();
+        } else {
+            name = (isolver == 1) ? "FGMRES" : "CG    ";
+            MLKrylovSolver krylov(mlmg, (isolver == 1) ? MLKrylovSolver::Type::FGMRES
+                                                       : MLKrylovSolver::Type::CG);
+            krylov.setVerbose(verbose);
+            krylov.solve(amrex::GetVecOfPtrs(sol), amrex::GetVecOfConstPtrs(rhs), tol, 0.0);
+            niters = krylov.getNumIters();
+        }
+        double t = amrex::second() - t0;
+        ParallelDescriptor::ReduceRealMax(t);
+
+        mlmg.compResidual(amrex::GetVecOfPtrs(res), amrex::GetVecOfPtrs(sol),
+                          amrex::GetVecOfConstPtrs(rhs));
+        amrex::Print() << "    " << name << ": " << niters << " iterations, " << t << " s, "
+                       << "fine residual " << res[1].norm0() << "\n";
+
+        if (!has_reference) {
+            for (int lev = 0; lev < nlevels; ++lev) {
+                MultiFab::Copy(sol0[lev], sol[lev], 0, 0, 1, 0);
+            }
+            has_reference = true;
+        } else {
+            for (int lev = 0; lev < nlevels; ++lev) {
+                MultiFab::Subtract(sol[lev], sol0[lev], 0, 0, 1, 0);
+                if (sol[lev].norm0() > 1.e-6_rt*sol0[lev].norm0()) { ++nfail; }
+            }
+        }
+    }
+    return nfail;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("verbose", verbose);
+        }
+
+        int nfail = 0;
+        nfail += solve_problem(10._rt, true, n_cell, max_grid_size, verbose);
+        // Stand-alone MLMG diverges for this one.
+        nfail += solve_problem(100._rt, false, n_cell, max_grid_size, verbose);
+
+        amrex::Print() << "Comparing the solutions: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
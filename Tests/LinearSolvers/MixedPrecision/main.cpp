@@ -0,0 +1,132 @@
+#include <AMReX.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+AMREX_GPU_HOST_DEVICE
+Real smooth_fn (GpuArray<Real,AMREX_SPACEDIM> const& x, Real k) noexcept
+{
+    Real f = 1._rt;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        f *= std::sin(k*Real(M_PI)*x[idim]);
+    }
+    return f;
+}
+
+void init_mf (MultiFab& mf, Geometry const& geom, Real a0, Real a1, Real k)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const IntVect nodal = mf.ixType().toIntVect();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k_) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k_));
+            GpuArray<Real,AMREX_SPACEDIM> x;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                x[idim] = problo[idim] + (iv[idim]+0.5_rt*(1-nodal[idim]))*dx[idim];
+            }
+            a(i,j,k_) = a0 + a1*smooth_fn(x, k);
+        });
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int nrepeat = 2;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nrepeat", nrepeat);
+            pp.query("verbose", verbose);
+        }
+
+        Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                      RealBox({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)}),
+                      CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(geom.Domain());
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab rhs(ba, dm, 1, 0);
+        init_mf(rhs, geom, 0._rt, 1._rt, 1._rt);
+        MultiFab acoef(ba, dm, 1, 0);
+        init_mf(acoef, geom, 1._rt, 0.5_rt, 2._rt);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+            init_mf(bcoef[idim], geom, 1._rt, 0.9_rt, 3._rt);
+        }
+
+        const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                                LinOpBCType::Neumann,
+                                                                LinOpBCType::Dirichlet)};
+
+        MultiFab sol0(ba, dm, 1, 0);
+        int nfail = 0;
+        for (bool mixed_precision : {false, true}) {
+            MultiFab sol(ba, dm, 1, 1);
+            ResetTotalBytesAllocatedInFabsHWM();
+            const Long mem0 = TotalBytesAllocatedInFabs();
+
+            LPInfo info;
+            info.setMixedPrecision(mixed_precision);
+            MLABecLaplacian linop({geom}, {ba}, {dm}, info);
+            linop.setDomainBC(bc, bc);
+            linop.setLevelBC(0, nullptr);
+            linop.setScalars(1.0, 1.0);
+            linop.setACoeffs(0, acoef);
+            linop.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+
+            double t = 0.;
+            int niters = 0;
+            for (int irep = 0; irep < nrepeat; ++irep) {
+                sol.setVal(0.0);
+                MLMG mlmg(linop);
+                mlmg.setVerbose(verbose);
+                ParallelDescriptor::Barrier();
+                double t0 = amrex::second();
+                mlmg.solve({&sol}, {&rhs}, 1.e-10, 0.0);
+                t += amrex::second() - t0;
+                niters = mlmg.getNumIters();
+            }
+
+            Long mem = TotalBytesAllocatedInFabsHWM() - mem0;
+            ParallelDescriptor::ReduceLongSum(mem);
+            ParallelDescriptor::ReduceRealMax(t);
+            amrex::Print() << (mixed_precision ? "mixed precision: " : "double:          ")
+                           << niters << " MLMG iterations, " << t/nrepeat << " s per solve, "
+                           << static_cast<double>(mem)/(1024.*1024.) << " MB in fabs\n";
+
+            if (mixed_precision) {
+                MultiFab::Subtract(sol, sol0, 0, 0, 1, 0);
+                if (sol.norm0() > 1.e-8_rt*sol0.norm0()) { ++nfail; }
+            } else {
+                MultiFab::Copy(sol0, sol, 0, 0, 1, 0);
+            }
+        }
+
+        amrex::Print() << "Comparing the solutions: " << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
@@ -1,11 +1,13 @@
 #include <AMReX.H>
 #include <AMReX_Parser.H>
 #include <AMReX_IParser.H>
+#include <AMReX_Utility.H>
 #include <map>
 
 using namespace amrex;
 
 static int max_stack_size = 0;
+static int max_num_registers = 0;
 static int test_number = 0;
 
 template <typename F>
@@ -24,6 +26,7 @@ int test1 (std::string const& f,
     parser.registerVariables(variables);
     auto const exe = parser.compile<1>();
     max_stack_size = std::max(max_stack_size, parser.maxStackSize());
+    max_num_registers = std::max(max_num_registers, parser.numRegisters());
 
     GpuArray<Real,1> dx{(hi[0]-lo[0]) / (N-1)};
 
@@ -68,6 +71,7 @@ int test3 (std::string const& f,
     parser.registerVariables(variables);
     auto const exe = parser.compile<3>();
     max_stack_size = std::max(max_stack_size, parser.maxStackSize());
+    max_num_registers = std::max(max_num_registers, parser.numRegisters());
 
     GpuArray<Real,3> dx{(hi[0]-lo[0]) / (N-1),
                         (hi[1]-lo[1]) / (N-1),
@@ -114,6 +118,7 @@ int test4 (std::string const& f,
     parser.registerVariables(variables);
     auto const exe = parser.compile<4>();
     max_stack_size = std::max(max_stack_size, parser.maxStackSize());
+    max_num_registers = std::max(max_num_registers, parser.numRegisters());
 
     GpuArray<Real,4> dx{(hi[0]-lo[0]) / (N-1),
                         (hi[1]-lo[1]) / (N-1),
@@ -147,6 +152,111 @@ int test4 (std::string const& f,
     }
 }
 
+// Compare the evaluations per second of the stack and register bytecode.
+int bench3 (std::string const& f,
+            std::map<std::string,Real> const& constants,
+            Array<Real,3> const& lo, Array<Real,3> const& hi,
+            int N, bool has_stack_bytecode = true)
+{
+    amrex::Print() << test_number++ << ". Benchmarking \"" << f << "\"\n";
+
+    Parser stack_parser(f);
+    Parser reg_parser(f);
+    stack_parser.setRegisterBytecode(false);
+    for (auto const& kv : constants) {
+        stack_parser.setConstant(kv.first, kv.second);
+        reg_parser.setConstant(kv.first, kv.second);
+    }
+    stack_parser.registerVariables({"x","y","z"});
+    reg_parser.registerVariables({"x","y","z"});
+
+    GpuArray<Real,3> dx{(hi[0]-lo[0]) / (N-1),
+                        (hi[1]-lo[1]) / (N-1),
+                        (hi[2]-lo[2]) / (N-1)};
+
+    auto run = [&] (auto const& exe, Vector<double>& result) -> double
+    {
+        double tmin = std::numeric_limits<double>::max();
+        for (int itry = 0; itry < 3; ++itry) {
+            double t0 = amrex::second();
+            for (int k = 0; k < N; ++k) {
+            for (int j = 0; j < N; ++j) {
+            for (int i = 0; i < N; ++i) {
+                result[(k*N+j)*N+i] = exe(lo[0]+i*dx[0], lo[1]+j*dx[1], lo[2]+k*dx[2]);
+            }}}
+            tmin = std::min(tmin, amrex::second()-t0);
+        }
+        return tmin;
+    };
+
+    auto run_batch = [&] (auto const& exe, Vector<double>& result) -> double
+    {
+        // The points are numbered along the first direction so that this
+        // works for any AMREX_SPACEDIM.
+        const Box bx(IntVect(0), IntVect(AMREX_D_DECL(N*N*N-1,0,0)));
+        Array4<double> a(result.data(), amrex::begin(bx), amrex::end(bx), 1);
+        double tmin = std::numeric_limits<double>::max();
+        for (int itry = 0; itry < 3; ++itry) {
+            double t0 = amrex::second();
+            exe.evalBatch(bx, a, [&] (int m, int, int) -> GpuArray<double,3>
+            {
+                const int i = m % N;
+                const int j = (m / N) % N;
+                const int k = m / (N*N);
+                return {lo[0]+i*dx[0], lo[1]+j*dx[1], lo[2]+k*dx[2]};
+            });
+            tmin = std::min(tmin, amrex::second()-t0);
+        }
+        return tmin;
+    };
+
+    auto count_failures = [&] (Vector<double> const& r1, Vector<double> const& r2) -> int
+    {
+        int nfail = 0;
+        for (int i = 0; i < N*N*N; ++i) {
+            double abserror = std::abs(r1[i]-r2[i]);
+            double relerror = abserror / (1.e-50 + std::max(std::abs(r1[i]),
+                                                             std::abs(r2[i])));
+            if (abserror > 1.e-15 && relerror > 1.e-13) { ++nfail; }
+        }
+        return nfail;
+    };
+
+    const double neval = double(N)*double(N)*double(N);
+    Vector<double> reg_result(N*N*N);
+    auto const reg_exe = reg_parser.compileHost<3>();
+    double treg = run(reg_exe, reg_result);
+
+    Vector<double> batch_result(N*N*N);
+    double tbatch = run_batch(reg_exe, batch_result);
+    int nfail = count_failures(reg_result, batch_result);
+
+    if (!has_stack_bytecode) {
+        amrex::Print() << "    registers: " << neval/treg << " evals/s, batched: "
+                       << neval/tbatch << " evals/s, "
+                       << reg_parser.numRegisters() << " registers";
+    } else {
+        Vector<double> stack_result(N*N*N);
+        auto const stack_exe = stack_parser.compileHost<3>();
+        double tstack = run(stack_exe, stack_result);
+        nfail += count_failures(reg_result, stack_result);
+
+        amrex::Print() << "    stack: " << neval/tstack << " evals/s, registers: "
+                       << neval/treg << " evals/s, speedup " << tstack/treg << "\n"
+                       << "    batched: " << neval/tbatch << " evals/s, speedup "
+                       << tstack/tbatch << "\n"
+                       << "    max stack size " << stack_parser.maxStackSize() << ", "
+                       << reg_parser.numRegisters() << " registers";
+    }
+    if (nfail > 0) {
+        amrex::Print() << "\n    failed " << nfail << " times\n";
+        return 1;
+    } else {
+        amrex::Print() << "    pass\n";
+        return 0;
+    }
+}
+
 int main (int argc, char* argv[])
 {
     amrex::Initialize(argc, argv);
@@ -356,7 +466,56 @@ int main (int argc, char* argv[])
                         {0.e-6, 0.0, -20.e-6}, {20.e-6, 1.e-10, 20.e-6}, 100,
                         1.e-12, 1.e-15);
 
+        nerror += bench3("r=sqrt((z-zc)*(z-zc)+(y-yc)*(y-yc)+(x-xc)*(x-xc)); if(r < (r_star-dR), 0.0, if(r <= r_star, dens, 0.0))",
+                         {{"xc", 0.1}, {"yc", -1.0}, {"zc", 0.2}, {"r_star", 0.73}, {"dR", 0.57}, {"dens", 12.}},
+                         {-1., -1., -1.0}, {1.0, 1.0, 1.0}, 64);
+
+        nerror += bench3("if( ((z-zc)*(z-zc)+(y-yc)*(y-yc)+(x-xc)*(x-xc))^(0.5) < (r_star-dR), 0.0, if(((z-zc)*(z-zc)+(y-yc)*(y-yc)+(x-xc)*(x-xc))^(0.5) <= r_star, dens, 0.0))",
+                         {{"xc", 0.1}, {"yc", -1.0}, {"zc", 0.2}, {"r_star", 0.73}, {"dR", 0.57}, {"dens", 12.}},
+                         {-1., -1., -1.0}, {1.0, 1.0, 1.0}, 64);
+
+        nerror += bench3("( ((( (z-zc)*(z-zc) + (y-yc)*(y-yc) + (x-xc)*(x-xc) )^(0.5))<=r_star) * ((( (z-zc)*(z-zc) + (y-yc)*(y-yc) + (x-xc)*(x-xc) )^(0.5))>=(r_star-dR)) )*dens",
+                         {{"xc", 0.1}, {"yc", -1.0}, {"zc", 0.2}, {"r_star", 0.73}, {"dR", 0.57}, {"dens", 12.}},
+                         {-1., -1., -1.0}, {1.0, 1.0, 1.0}, 64);
+
+        nerror += bench3("sqrt(x*x+y*y)*cos(sqrt(x*x+y*y)) + exp(-sqrt(x*x+y*y))*z",
+                         {}, {-1., -1., -1.0}, {1.0, 1.0, 1.0}, 64);
+
+        nerror += bench3("(x-a)**4 + (y-b)**6 - 0.3*(z-c)**5 + 2*x**2*y**2",
+                         {{"a", 0.1}, {"b", -0.2}, {"c", 0.3}},
+                         {-1., -1., -1.0}, {1.0, 1.0, 1.0}, 64);
+
+        nerror += bench3("epsilon/kp*2*x/w0**2*exp(-(x**2+y**2)/w0**2)*sin(k0*z)",
+                         {{"epsilon",0.01},{"kp",3.5},{"w0",5.e-6},{"k0",3.e5}},
+                         {0.e-6, 0.0, -20.e-6}, {20.e-6, 1.e-10, 20.e-6}, 64);
+
+        {
+            // More local variables than AMREX_PARSER_STACK_SIZE
+            std::string f;
+            for (int i = 0; i < 24; ++i) {
+                f += "a" + std::to_string(i) + "=" + ((i == 0) ? std::string("x")
+                                                       : "a" + std::to_string(i-1))
+                    + "*y+z; ";
+            }
+            f += "a23";
+            Parser parser(f);
+            parser.registerVariables({"x","y","z"});
+            auto const exe = parser.compile<3>();
+            Real x = 0.3, y = 0.7, z = -0.2;
+            Real a = x;
+            for (int i = 0; i < 24; ++i) { a = a*y+z; }
+            amrex::Print() << test_number++ << ". Testing 24 local variables   ";
+            if (std::abs(exe(x,y,z)-a) > 1.e-14*std::abs(a)) {
+                amrex::Print() << "\n    f = " << exe(x,y,z) << ", " << a << "\n";
+                ++nerror;
+            } else {
+                amrex::Print() << "    pass\n";
+            }
+            nerror += bench3(f, {}, {-1., -1., -1.0}, {1.0, 1.0, 1.0}, 64, false);
+        }
+
         amrex::Print() << "\nMax stack size is " << max_stack_size << "\n";
+        amrex::Print() << "Max number of registers is " << max_num_registers << "\n";
         if (nerror > 0) {
             amrex::Print() << nerror << " tests failed\n";
             amrex::Abort();
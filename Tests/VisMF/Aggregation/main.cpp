@@ -0,0 +1,143 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <cmath>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void init_data (MultiFab& mf, int n_cell)
+{
+    const Real dx = 1._rt / n_cell;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.fabbox();
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt, r2 = 0._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = (iv[idim]+0.5_rt)*dx;
+                f *= std::sin(2._rt*Real(M_PI)*x);
+                r2 += (x-0.5_rt)*(x-0.5_rt);
+            }
+            a(i,j,k,0) = f;
+            a(i,j,k,1) = 1._rt + std::exp(-r2/0.01_rt);
+        });
+    }
+}
+
+// Write mf nwrites times, and return the shortest time
+double time_write (MultiFab const& mf, std::string const& name, int nwrites, Long& bytes)
+{
+    double t = 1.e30;
+    for (int iwrite = 0; iwrite < nwrites; ++iwrite) {
+        ParallelDescriptor::Barrier();
+        double t0 = amrex::second();
+        bytes = VisMF::Write(mf, name);
+        ParallelDescriptor::Barrier();
+        double t1 = amrex::second() - t0;
+        ParallelDescriptor::ReduceRealMax(t1);
+        t = std::min(t, t1);
+    }
+    ParallelDescriptor::ReduceLongSum(bytes);
+    return t;
+}
+
+// The number of cells, including the ghost cells, that differ from mf after reading name
+Long read_mismatches (MultiFab const& mf, std::string const& name)
+{
+    MultiFab rd(mf.boxArray(), mf.DistributionMap(), mf.nComp(), mf.nGrowVect());
+    VisMF::Read(rd, name);
+    Long nfail = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const auto& a = mf.const_array(mfi);
+        const auto& b = rd.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [=,&nfail] (int i, int j, int k, int n)
+        {
+            if (a(i,j,k,n) != b(i,j,k,n)) { ++nfail; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(nfail);
+    return nfail;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int nwrites = 3;
+        int nfiles = 64;
+        Vector<int> naggregators{1};
+        Long buffer_size = VisMF::GetAggregatorBufferSize();
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nwrites", nwrites);
+            pp.query("nfiles", nfiles);
+            pp.queryarr("naggregators", naggregators);
+            pp.query("buffer_size", buffer_size);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        MultiFab mf(ba, DistributionMapping(ba), 2, 1);
+        init_data(mf, n_cell);
+
+        const std::string dir("vismf_aggregation");
+        amrex::UtilCreateCleanDirectory(dir, true);
+
+        VisMF::SetNOutFiles(nfiles);
+        VisMF::SetAggregatorBufferSize(buffer_size);
+
+        amrex::Print() << ParallelDescriptor::NProcs() << " processes, " << ba.size()
+                       << " grids, " << VisMF::GetAggregatorBufferSize() << " bytes blocks\n";
+
+        Long nfail = 0;
+        for (auto version : {VisMF::Header::Version_v1,
+                             VisMF::Header::NoFabHeader_v1,
+                             VisMF::Header::Compressed_v1})
+        {
+            VisMF::SetHeaderVersion(version);
+            amrex::Print() << "Header version " << version << ":\n";
+
+            VisMF::SetAggregateWrites(false);
+            std::string name = dir + "/nfiles_v" + std::to_string(version);
+            Long bytes = 0;
+            double t = time_write(mf, name, nwrites, bytes);
+            Long nf = read_mismatches(mf, name);
+            amrex::Print() << "    " << VisMF::GetNOutFiles() << " files: " << bytes/1.e6
+                           << " MB in " << t << " s (" << bytes/t/1.e9 << " GB/s), "
+                           << nf << " mismatches\n";
+            nfail += nf;
+
+            VisMF::SetAggregateWrites(true);
+            for (int naggr : naggregators) {
+                VisMF::SetNAggregatorsPerNode(naggr);
+                name = dir + "/aggr" + std::to_string(naggr) + "_v" + std::to_string(version);
+                t = time_write(mf, name, nwrites, bytes);
+                nf = read_mismatches(mf, name);
+                amrex::Print() << "    " << naggr << " aggregators per node: " << bytes/1.e6
+                               << " MB in " << t << " s (" << bytes/t/1.e9 << " GB/s), "
+                               << nf << " mismatches\n";
+                nfail += nf;
+            }
+        }
+
+        amrex::Print() << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
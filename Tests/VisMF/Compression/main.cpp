@@ -0,0 +1,182 @@
+#include <AMReX.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <cmath>
+#include <memory>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+// A smooth field, a Gaussian blob that is flat far away, a piecewise
+// constant field and noise.
+void init_data (MultiFab& mf, int n_cell)
+{
+    const Real dx = 1._rt / n_cell;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt, r2 = 0._rt, h = 0._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = (iv[idim]+0.5_rt)*dx;
+                f *= std::sin(2._rt*Real(M_PI)*x);
+                r2 += (x-0.5_rt)*(x-0.5_rt);
+                h += iv[idim]*Real(12.9898 + 25.*idim);
+            }
+            a(i,j,k,0) = f;
+            a(i,j,k,1) = 1._rt + std::exp(-r2/0.01_rt);
+            a(i,j,k,2) = (r2 < 0.1_rt) ? 1._rt : 0.125_rt;
+            h = std::sin(h)*43758.5453_rt;
+            a(i,j,k,3) = h - std::floor(h);
+        });
+    }
+    mf.FillBoundary();
+}
+
+// The max error of the read data in each component, including the ghost cells
+Vector<Real> read_error (MultiFab const& mf, std::string const& name, int ngrow)
+{
+    MultiFab rd(mf.boxArray(), mf.DistributionMap(), mf.nComp(), ngrow);
+    VisMF::Read(rd, name);
+    MultiFab::Subtract(rd, mf, 0, 0, mf.nComp(), ngrow);
+    Vector<Real> err(mf.nComp());
+    for (int n = 0; n < mf.nComp(); ++n) {
+        err[n] = rd.norm0(n, ngrow);
+    }
+    return err;
+}
+
+// Check the single component reads against reading the whole fabs
+int check_component_reads (MultiFab const& mf, std::string const& name)
+{
+    int nfail = 0;
+    VisMF vmf(name);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        std::unique_ptr<FArrayBox> whole(vmf.readFAB(mfi.index(), name));
+        for (int n = 0; n < mf.nComp(); ++n) {
+            std::unique_ptr<FArrayBox> one(vmf.readFAB(mfi.index(), n));
+            one->minus<RunOn::Host>(*whole, n, 0, 1);
+            if (one->norm<RunOn::Host>(0) != 0._rt) { ++nfail; }
+        }
+    }
+    ParallelDescriptor::ReduceIntSum(nfail);
+    return nfail;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int nwrites = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nwrites", nwrites);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        const int ncomp = 4;
+        const int ngrow = 1;
+        MultiFab mf(ba, dm, ncomp, ngrow);
+        mf.setVal(0.0);
+        init_data(mf, n_cell);
+
+        const Real tol = VisMF::GetCompressionTolerance();
+        Vector<Real> bound(ncomp);
+        for (int n = 0; n < ncomp; ++n) {
+            bound[n] = tol * (mf.max(n) - mf.min(n));
+        }
+
+        const std::string dir("vismf_compression");
+        amrex::UtilCreateCleanDirectory(dir, true);
+
+        const Vector<VisMF::Header::Version> versions{VisMF::Header::Version_v1,
+                                                      VisMF::Header::NoFabHeader_v1,
+                                                      VisMF::Header::Compressed_v1,
+                                                      VisMF::Header::CompressedLossy_v1};
+        double raw_bytes = 0.;
+        for (int i = 0; i < ba.size(); ++i) {
+            raw_bytes += double(amrex::grow(ba[i],ngrow).numPts()) * ncomp * sizeof(Real);
+        }
+
+        int nfail = 0;
+        for (auto version : versions) {
+            VisMF::SetHeaderVersion(version);
+            const std::string name = dir + "/mf_v" + std::to_string(version);
+
+            Long bytes = 0;
+            double t = 1.e30;
+            for (int iwrite = 0; iwrite < nwrites; ++iwrite) {
+                ParallelDescriptor::Barrier();
+                double t0 = amrex::second();
+                bytes = VisMF::Write(mf, name);
+                double t1 = amrex::second() - t0;
+                ParallelDescriptor::ReduceRealMax(t1);
+                t = std::min(t, t1);
+            }
+            ParallelDescriptor::ReduceLongSum(bytes);
+
+            Vector<Real> err = read_error(mf, name, ngrow);
+            amrex::Print() << "Header version " << version << ": "
+                           << bytes/1.e6 << " MB, compression ratio " << raw_bytes/bytes
+                           << ", write " << t << " s (" << raw_bytes/t/1.e9 << " GB/s)\n"
+                           << "    max error:";
+            for (int n = 0; n < ncomp; ++n) {
+                amrex::Print() << " " << err[n];
+                if (version == VisMF::Header::CompressedLossy_v1) {
+                    if (err[n] > bound[n]) { ++nfail; }
+                } else {
+                    if (err[n] != 0._rt) { ++nfail; }
+                }
+            }
+            amrex::Print() << "\n";
+
+            nfail += check_component_reads(mf, name);
+        }
+
+        if (AsyncOut::UseAsyncOut()) {
+            // The valid cells only
+            for (auto version : {VisMF::Header::Compressed_v1, VisMF::Header::CompressedLossy_v1}) {
+                VisMF::SetHeaderVersion(version);
+                const std::string name = dir + "/mf_async_v" + std::to_string(version);
+                VisMF::AsyncWrite(mf, name, true);
+                AsyncOut::Finish();
+                ParallelDescriptor::Barrier();
+
+                Vector<Real> err = read_error(mf, name, 0);
+                amrex::Print() << "AsyncWrite with header version " << version << ", max error:";
+                for (int n = 0; n < ncomp; ++n) {
+                    amrex::Print() << " " << err[n];
+                    if (err[n] > ((version == VisMF::Header::Compressed_v1) ? 0._rt : bound[n])) {
+                        ++nfail;
+                    }
+                }
+                amrex::Print() << "\n";
+                nfail += check_component_reads(mf, name);
+            }
+        }
+
+        amrex::Print() << "Error bound of the lossy compression:";
+        for (int n = 0; n < ncomp; ++n) { amrex::Print() << " " << bound[n]; }
+        amrex::Print() << "\n" << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
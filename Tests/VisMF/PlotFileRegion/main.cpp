@@ -0,0 +1,163 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <cmath>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void init_data (MultiFab& mf, Geometry const& geom)
+{
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real f = 1._rt, r2 = 0._rt;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = (iv[idim]+0.5_rt)*dx[idim];
+                f *= std::sin(2._rt*Real(M_PI)*x);
+                r2 += (x-0.5_rt)*(x-0.5_rt);
+            }
+            a(i,j,k,0) = f;
+            a(i,j,k,1) = 1._rt + std::exp(-r2/0.01_rt);
+        });
+    }
+}
+
+// Compare a region read against the data of the whole level read by get(level,varname).
+int check_region (PlotFileData& pf, MultiFab const& full, int level, Box const& region,
+                  std::string const& varname)
+{
+    int nfail = 0;
+    const FArrayBox& fab = pf.get(level, region, varname);
+    const auto& r = fab.const_array();
+    for (MFIter mfi(full); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox() & region;
+        if (bx.ok()) {
+            const auto& a = full.const_array(mfi);
+            amrex::LoopOnCpu(bx, [=,&nfail] (int i, int j, int k)
+            {
+                if (r(i,j,k) != a(i,j,k)) { ++nfail; }
+            });
+        }
+    }
+    ParallelDescriptor::ReduceIntSum(nfail);
+    return nfail;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        // Two levels, the fine level covers the middle of the domain.
+        const int nlevs = 2;
+        const IntVect ratio(2);
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Vector<Geometry> geom(nlevs);
+        geom[0].define(Box(IntVect(0), IntVect(n_cell-1)), rb, CoordSys::cartesian,
+                       {AMREX_D_DECL(0,0,0)});
+        geom[1].define(amrex::refine(geom[0].Domain(), ratio), rb, CoordSys::cartesian,
+                       {AMREX_D_DECL(0,0,0)});
+
+        Vector<BoxArray> ba(nlevs);
+        ba[0].define(geom[0].Domain());
+        ba[1].define(Box(IntVect(n_cell/2), IntVect(3*n_cell/2-1)));
+        Vector<MultiFab> mf(nlevs);
+        for (int lev = 0; lev < nlevs; ++lev) {
+            ba[lev].maxSize(max_grid_size);
+            mf[lev].define(ba[lev], DistributionMapping(ba[lev]), 2, 0);
+            init_data(mf[lev], geom[lev]);
+        }
+
+        const Vector<std::string> varnames{"f", "g"};
+        const std::string dir("plotfile_region");
+        amrex::UtilCreateCleanDirectory(dir, true);
+
+        const Real tol = VisMF::GetCompressionTolerance();
+        int nfail = 0;
+        for (auto version : {VisMF::Header::Version_v1,
+                             VisMF::Header::NoFabHeader_v1,
+                             VisMF::Header::NoFabHeaderFAMinMax_v1,
+                             VisMF::Header::Compressed_v1,
+                             VisMF::Header::CompressedLossy_v1})
+        {
+            VisMF::SetHeaderVersion(version);
+            const std::string name = dir + "/plt_v" + std::to_string(version);
+            amrex::WriteMultiLevelPlotfile(name, nlevs, amrex::GetVecOfConstPtrs(mf), varnames,
+                                           geom, 0.0, Vector<int>(nlevs,0),
+                                           Vector<IntVect>(nlevs-1,ratio));
+
+            PlotFileData pf(name);
+            amrex::Print() << "Header version " << version << ":\n";
+            for (int lev = 0; lev < nlevs; ++lev) {
+                const Box& domain = pf.probDomain(lev);
+                const IntVect mid = domain.smallEnd() + domain.length()/2;
+
+                // A line along x and a plane normal to z through the middle
+                Box line(mid, mid);
+                line.setSmall(0, domain.smallEnd(0));
+                line.setBig(0, domain.bigEnd(0));
+                Box plane = domain;
+                plane.setSmall(AMREX_SPACEDIM-1, mid[AMREX_SPACEDIM-1]);
+                plane.setBig(AMREX_SPACEDIM-1, mid[AMREX_SPACEDIM-1]);
+
+                for (int icomp = 0; icomp < 2; ++icomp) {
+                    ParallelDescriptor::Barrier();
+                    double t0 = amrex::second();
+                    const MultiFab& full = pf.get(lev, varnames[icomp]);
+                    double tfull = amrex::second() - t0;
+
+                    ParallelDescriptor::Barrier();
+                    t0 = amrex::second();
+                    FArrayBox planefab = pf.get(lev, plane, varnames[icomp]);
+                    double tplane = amrex::second() - t0;
+                    ParallelDescriptor::ReduceRealMax(tfull);
+                    ParallelDescriptor::ReduceRealMax(tplane);
+
+                    const int nf = check_region(pf, full, lev, line, varnames[icomp])
+                        +          check_region(pf, full, lev, plane, varnames[icomp]);
+
+                    // The header min and max are those of the data before the
+                    // lossy compression.
+                    const auto mm = pf.minmax(lev, varnames[icomp]);
+                    const Real mn = full.min(0);
+                    const Real mx = full.max(0);
+                    const Real eps = (version == VisMF::Header::CompressedLossy_v1)
+                        ? tol*(mx-mn) : 0._rt;
+                    const bool mmfail = std::abs(mm.first-mn) > eps || std::abs(mm.second-mx) > eps;
+
+                    amrex::Print() << "    level " << lev << " " << varnames[icomp]
+                                   << ": get(level) " << tfull << " s, get(level,plane) "
+                                   << tplane << " s, min " << mm.first << " max " << mm.second
+                                   << ", " << nf << " mismatches\n";
+                    nfail += nf + static_cast<int>(mmfail);
+                }
+            }
+        }
+
+        amrex::Print() << nfail << " failures\n";
+        AMREX_ALWAYS_ASSERT(nfail == 0);
+    }
+    amrex::Finalize();
+}
@@ -1,6 +1,9 @@
 #include <AMReX.H>
 #include <AMReX_Print.H>
+#include <AMReX_ParallelReduce.H>
 #include <AMReX_PlotFileUtil.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_ValLocPair.H>
 #include <algorithm>
 #include <limits>
 #include <cmath>
@@ -24,7 +27,7 @@ void PrintUsage()
         << " variable.\n"
         << "\n"
         << " usage:\n"
-        << "    fcompare [-n|--norm num] [-d|--diffvar var] [-z|--zone_info var] [-a|--allow_diff_grids] [-r|rel_tol] [--abs_tol] file1 file2\n"
+        << "    fcompare [-n|--norm num] [-d|--diffvar var] [-z|--zone_info var] [-a|--allow_diff_grids] [-r|rel_tol] [--abs_tol] [-e|--early_exit] file1 file2\n"
         << "\n"
         << " optional arguments:\n"
         << "    -n|--norm num         : what norm to use (default is 0 for inf norm)\n"
@@ -35,6 +38,8 @@ void PrintUsage()
         << "    -a|--allow_diff_grids : allow different BoxArrays covering the same domain\n"
         << "    -r|--rel_tol rtol     : relative tolerance (default is 0)\n"
         << "    --abs_tol atol        : absolute tolerance (default is 0)\n"
+        << "    -e|--early_exit       : stop at the first variable that has NaNs or\n"
+        << "                            exceeds the tolerances\n"
         << std::endl;
 }
 
@@ -60,6 +65,7 @@ int main_main()
     std::string zone_info_var_name;
     Vector<std::string> plot_names(1);
     bool abort_if_not_all_found = false;
+    bool early_exit = false;
 
     int farg = 1;
     while (farg <= narg) {
@@ -87,6 +93,8 @@ int main_main()
             atol = std::stod(amrex::get_command_argument(++farg));
         } else if (fname == "--abort_if_not_all_found") {
             abort_if_not_all_found = true;
+        } else if (fname == "-e" || fname == "--early_exit") {
+            early_exit = true;
         } else {
             break;
         }
@@ -206,80 +214,108 @@ int main_main()
             }
         }
 
+        // Only one component of one grid of each file is in memory at a time.
+        const BoxArray& ba = pf_a.boxArray(ilev);
+        const DistributionMapping& dmap = pf_a.DistributionMap(ilev);
+        Vector<int> local_grids;
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            if (dmap[i] == ParallelDescriptor::MyProc()) { local_grids.push_back(i); }
+        }
+        const int nlocal = local_grids.size();
+
+        Real dv = 1.0;
+        for (int idim = 0; idim < dm; ++idim) {
+            dv *= pf_a.cellSize(ilev)[idim];
+        }
+
+        amrex::Print() << " level = " << ilev << "\n";
+
         Vector<Real> aerror(ncomp_a, 0.0);
         Vector<Real> rerror(ncomp_a, 0.0);
-        Vector<Real> rerror_denom(ncomp_a, 0.0);
         Vector<int> has_nan_a(ncomp_a, false);
         Vector<int> has_nan_b(ncomp_a, false);
         for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
-            if (ivar_b[icomp_a] >= 0) {
-                const MultiFab& mf_a = pf_a.get(ilev, names_a[icomp_a]);
-                MultiFab mf_b;
-                if (grids_match) {
-                    mf_b = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
-                } else {
-                    mf_b.define(mf_a.boxArray(), mf_a.DistributionMap(), 1, 0);
-                    MultiFab tmp = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
-                    mf_b.ParallelCopy(tmp);
-                }
-                has_nan_a[icomp_a] = mf_a.contains_nan();
-                has_nan_b[icomp_a] = mf_b.contains_nan();
-                MultiFab::Subtract(mf_b,mf_a,0,0,1,0); // b = b - a
-                Real max_err = mf_b.norm0();
-                if (norm == 1) {
-                    aerror[icomp_a] = mf_b.norm1();
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm1();
-                } else if (norm == 2) {
-                    aerror[icomp_a] = mf_b.norm2();
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm2();
-                } else {
-                    aerror[icomp_a] = max_err;
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm0();
-                }
+            if (ivar_b[icomp_a] < 0) {
+                amrex::Print() << " " << std::setw(24) << std::left << names_a[icomp_a]
+                               << "  " << std::setw(50)
+                               << "< variable not present in both files > \n";
+                continue;
+            }
 
-                if (norm == 0) {
-                    rerror[icomp_a] /= rerror_denom[icomp_a];
-                } else {
-                    const auto& dx = pf_a.cellSize(ilev);
-                    Real dv = 1.0;
-                    for (int idim = 0; idim < dm; ++idim) {
-                        dv *= dx[idim];
-                    }
-                    aerror[icomp_a] *= std::pow(dv,1./static_cast<Real>(norm));
-                    rerror[icomp_a] = rerror[icomp_a]/rerror_denom[icomp_a];
-                }
+            // max|B-A|, sum|B-A|, sum(B-A)^2, max|A|, sum|A|, sum A^2, NaN in A, NaN in B
+            ReduceOps<ReduceOpMax, ReduceOpSum, ReduceOpSum,
+                      ReduceOpMax, ReduceOpSum, ReduceOpSum,
+                      ReduceOpLogicalOr, ReduceOpLogicalOr> reduce_op;
+            ReduceData<Real, Real, Real, Real, Real, Real, int, int> reduce_data(reduce_op);
+            using ReduceTuple = typename decltype(reduce_data)::Type;
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic) if (Gpu::notInLaunchRegion())
+#endif
+            for (int igrid = 0; igrid < nlocal; ++igrid) {
+                const int gid = local_grids[igrid];
+                const Box& bx = ba[gid];
+                const FArrayBox& fab_a = pf_a.get(ilev, bx, icomp_a, 1);
+                // If the grids differ, this reads the parts of B's grids covering bx.
+                FArrayBox fab_b = pf_b.get(ilev, bx, ivar_b[icomp_a], 1);
+                const auto& a = fab_a.const_array();
+                const auto& b = fab_b.const_array();
+                reduce_op.eval(bx, reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                {
+                    const Real va = a(i,j,k);
+                    const Real d = std::abs(b(i,j,k) - va);
+                    return {d, d, d*d, std::abs(va), std::abs(va), va*va,
+                            int(amrex::isnan(va)), int(amrex::isnan(b(i,j,k)))};
+                });
 
                 if (icomp_a == save_var_a || icomp_a == zone_info_var_a) {
-                    mf_b.abs(0,1);
+                    fab_b.minus<RunOn::Host>(fab_a);
+                    fab_b.abs<RunOn::Host>();
                 }
 
                 if (icomp_a == save_var_a) {
-                    MultiFab::Copy(mf_array[ilev], mf_b, 0, 0, 1, 0);
+                    mf_array[ilev][gid].copy<RunOn::Host>(fab_b);
                 }
 
                 if (icomp_a == zone_info_var_a) {
-                    if (max_err > err_zone.max_abs_err) {
-                        err_zone.max_abs_err = max_err;
+                    const IntVect cell = fab_b.maxIndex<RunOn::Host>(bx, 0);
+                    const Real err = fab_b(cell);
+#ifdef AMREX_USE_OMP
+#pragma omp critical (fcompare_zone_info)
+#endif
+                    if (err > err_zone.max_abs_err) {
+                        err_zone.max_abs_err = err;
                         err_zone.level = ilev;
-                        err_zone.cell = mf_b.maxIndex(0);
-                        auto isects = pf_a.boxArray(ilev).intersections
-                            (Box(err_zone.cell,err_zone.cell), true, 0);
-                        err_zone.grid_index = isects[0].first;
+                        err_zone.cell = cell;
+                        err_zone.grid_index = gid;
                     }
                 }
             }
-        }
 
-        amrex::Print() << " level = " << ilev << "\n";
-        for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
-            if (ivar_b[icomp_a] < 0) {
-                amrex::Print() << " " << std::setw(24) << std::left << names_a[icomp_a]
-                               << "  " << std::setw(50)
-                               << "< variable not present in both files > \n";
-            } else if (has_nan_a[icomp_a] && has_nan_b[icomp_a]) {
+            auto hv = reduce_data.value(reduce_op);
+            Array<Real,2> maxs{amrex::get<0>(hv), amrex::get<3>(hv)};
+            Array<Real,4> sums{amrex::get<1>(hv), amrex::get<2>(hv),
+                               amrex::get<4>(hv), amrex::get<5>(hv)};
+            Array<int,2> nans{amrex::get<6>(hv), amrex::get<7>(hv)};
+            ParallelDescriptor::ReduceRealMax(maxs.data(), 2);
+            ParallelDescriptor::ReduceRealSum(sums.data(), 4);
+            ParallelDescriptor::ReduceIntMax(nans.data(), 2);
+            has_nan_a[icomp_a] = nans[0];
+            has_nan_b[icomp_a] = nans[1];
+
+            if (norm == 1) {
+                aerror[icomp_a] = sums[0] * dv;
+                rerror[icomp_a] = sums[0] / sums[2];
+            } else if (norm == 2) {
+                aerror[icomp_a] = std::sqrt(sums[1]) * std::sqrt(dv);
+                rerror[icomp_a] = std::sqrt(sums[1]) / std::sqrt(sums[3]);
+            } else {
+                aerror[icomp_a] = maxs[0];
+                rerror[icomp_a] = maxs[0] / maxs[1];
+            }
+
+            if (has_nan_a[icomp_a] && has_nan_b[icomp_a]) {
                 amrex::Print() << " " << std::setw(24) << std::left << names_a[icomp_a]
                                << "  " << std::setw(50)
                                << "< NaN present in both A and B > \n";
@@ -309,6 +345,14 @@ int main_main()
                                << "  " << std::setw(24) << std::setprecision(10) << rerr
                                << "\n";
             }
+
+            if (early_exit && (has_nan_a[icomp_a] || has_nan_b[icomp_a] ||
+                               !(aerror[icomp_a] <= atol || rerror[icomp_a] <= rtol)))
+            {
+                amrex::Print() << " PLOTFILE DISAGREE: stopping at the first variable"
+                               << " exceeding the tolerances" << std::endl;
+                return EXIT_FAILURE;
+            }
         }
 
         global_error = std::max(global_error,
@@ -340,21 +384,21 @@ int main_main()
     }
 
     if (zone_info) {
-        if (err_zone.max_abs_err > 0.) {
+        ValLocPair<Real,int> vl{err_zone.max_abs_err, ParallelDescriptor::MyProc()};
+        ParallelAllReduce::Max(vl, ParallelDescriptor::Communicator());
+        if (vl.value > 0.) {
             ParallelDescriptor::Barrier();
-            const DistributionMapping& dmap = pf_a.DistributionMap(err_zone.level);
-            bool owner_proc = ParallelDescriptor::MyProc() == dmap[err_zone.grid_index];
+            bool owner_proc = ParallelDescriptor::MyProc() == vl.index;
 
             if (owner_proc) {
                 amrex::AllPrint() << std::endl
                                   << " maximum error in " << zone_info_var_name << "\n"
                                   << "   level = " << err_zone.level << " (i,j,k) = " << err_zone.cell << "\n";
-            }
 
-            for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
-                const MultiFab& mf = pf_a.get(err_zone.level,names_a[icomp_a]);
-                if (owner_proc) {
-                    Real v = mf[err_zone.grid_index](err_zone.cell);
+                const FArrayBox& fab = pf_a.get(err_zone.level, Box(err_zone.cell,err_zone.cell),
+                                                0, ncomp_a);
+                for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
+                    Real v = fab(err_zone.cell, icomp_a);
                     amrex::AllPrint() << " " << std::setw(24)
                                       << names_a[icomp_a] << "  "
                                       << std::setw(24) << std::right
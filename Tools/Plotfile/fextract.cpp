@@ -4,6 +4,7 @@
 #include <AMReX_MultiFabUtil.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <limits>
+#include <memory>
 #include <iterator>
 #include <fstream>
 
@@ -217,69 +218,48 @@ void main_main()
 
         Array<Real,AMREX_SPACEDIM> dx = pf.cellSize(ilev);
 
+        std::unique_ptr<iMultiFab> mask;
+        IntVect ratio{1};
         if (ilev < fine_level) {
-            IntVect ratio{pf.refRatio(ilev)};
+            ratio = IntVect{pf.refRatio(ilev)};
             for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
                 ratio[idim] = 1;
             }
-            const iMultiFab mask = makeFineMask(pf.boxArray(ilev), pf.DistributionMap(ilev),
-                                                pf.boxArray(ilev+1), ratio);
+            mask = std::make_unique<iMultiFab>(makeFineMask(pf.boxArray(ilev), pf.DistributionMap(ilev),
+                                                            pf.boxArray(ilev+1), ratio));
+        }
+
+        // Only the grids intersecting the slice are read, each by its owner.
+        const DistributionMapping& dm = pf.DistributionMap(ilev);
+        for (auto const& is : pf.boxArray(ilev).intersections(slice_box)) {
+            const int gid = is.first;
+            if (dm[gid] != ParallelDescriptor::MyProc()) { continue; }
+            const Box& bx = is.second;
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
             for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                    const Box& bx = mfi.validbox() & slice_box;
-                    if (bx.ok()) {
-                        const auto& m = mask.array(mfi);
-                        const auto& fab = mf.array(mfi);
-                        const auto lo = amrex::lbound(bx);
-                        const auto hi = amrex::ubound(bx);
-                        for         (int k = lo.z; k <= hi.z; ++k) {
-                            for     (int j = lo.y; j <= hi.y; ++j) {
-                                for (int i = lo.x; i <= hi.x; ++i) {
-                                    if (m(i,j,k) == 0) { // not covered by fine
-                                        if (pos.size() == data[ivar].size()) {
-                                            Array<Real,AMREX_SPACEDIM> p
-                                                = {AMREX_D_DECL(problo[0]+static_cast<Real>(i+0.5)*dx[0],
-                                                                problo[1]+static_cast<Real>(j+0.5)*dx[1],
-                                                                problo[2]+static_cast<Real>(k+0.5)*dx[2])};
-                                            pos.push_back(p[idir]);
-                                        }
-                                        data[ivar].push_back(fab(i,j,k));
-                                    }
-                                }
+                const FArrayBox& fab = pf.get(ilev, bx, var_names[ivar]);
+                const auto& a = fab.const_array();
+                for         (int k = lo.z; k <= hi.z; ++k) {
+                    for     (int j = lo.y; j <= hi.y; ++j) {
+                        for (int i = lo.x; i <= hi.x; ++i) {
+                            if (mask && (*mask)[gid](IntVect(AMREX_D_DECL(i,j,k))) != 0) {
+                                continue; // covered by fine
                             }
-                        }
-                    }
-                }
-            }
-            rr *= ratio;
-        } else {
-            for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                    const Box& bx = mfi.validbox() & slice_box;
-                    if (bx.ok()) {
-                        const auto& fab = mf.array(mfi);
-                        const auto lo = amrex::lbound(bx);
-                        const auto hi = amrex::ubound(bx);
-                        for         (int k = lo.z; k <= hi.z; ++k) {
-                            for     (int j = lo.y; j <= hi.y; ++j) {
-                                for (int i = lo.x; i <= hi.x; ++i) {
-                                    if (pos.size() == data[ivar].size()) {
-                                        Array<Real,AMREX_SPACEDIM> p
-                                            = {AMREX_D_DECL(problo[0]+static_cast<Real>(i+0.5)*dx[0],
-                                                            problo[1]+static_cast<Real>(j+0.5)*dx[1],
-                                                            problo[2]+static_cast<Real>(k+0.5)*dx[2])};
-                                        pos.push_back(p[idir]);
-                                    }
-                                    data[ivar].push_back(fab(i,j,k));
-                                }
+                            if (pos.size() == data[ivar].size()) {
+                                Array<Real,AMREX_SPACEDIM> p
+                                    = {AMREX_D_DECL(problo[0]+static_cast<Real>(i+0.5)*dx[0],
+                                                    problo[1]+static_cast<Real>(j+0.5)*dx[1],
+                                                    problo[2]+static_cast<Real>(k+0.5)*dx[2])};
+                                pos.push_back(p[idir]);
                             }
+                            data[ivar].push_back(a(i,j,k));
                         }
                     }
                 }
             }
         }
+        rr *= ratio;
     }
 
 #ifdef BL_USE_MPI
@@ -1,7 +1,7 @@
 #include <AMReX.H>
 #include <AMReX_Print.H>
 #include <AMReX_PlotFileUtil.H>
-#include <AMReX_MultiFabUtil.H>
+#include <AMReX_Reduce.H>
 #include <algorithm>
 #include <limits>
 #include <cmath>
@@ -64,40 +64,56 @@ void main_main()
 
         const int dim = pf.spaceDim();
 
+        for (int ivar = 0; ivar < var_names.size(); ++ivar) {
+            vvmin[ivar] = std::numeric_limits<Real>::max();
+            vvmax[ivar] = std::numeric_limits<Real>::lowest();
+        }
+
         for (int ilev = pf.finestLevel(); ilev >= 0; --ilev) {
-            if (ilev == pf.finestLevel()) {
-                for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                    const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                    vvmin[ivar] = mf.min(0,0,false);
-                    vvmax[ivar] = mf.max(0,0,false);
-                }
-            } else {
+            // The parts of the local grids not covered by the next finer level
+            const BoxArray& ba = pf.boxArray(ilev);
+            const DistributionMapping& dm = pf.DistributionMap(ilev);
+            BoxArray cfba;
+            if (ilev < pf.finestLevel()) {
                 IntVect ratio{pf.refRatio(ilev)};
                 for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
                     ratio[idim] = 1;
                 }
-                iMultiFab mask = makeFineMask(pf.boxArray(ilev), pf.DistributionMap(ilev),
-                                              pf.boxArray(ilev+1), ratio);
-                for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                    const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                        const Box& bx = mfi.validbox();
-                        const auto lo = amrex::lbound(bx);
-                        const auto hi = amrex::ubound(bx);
-                        const auto& ifab = mask.array(mfi);
-                        const auto& fab = mf.array(mfi);
-                        for         (int k = lo.z; k <= hi.z; ++k) {
-                            for     (int j = lo.y; j <= hi.y; ++j) {
-                                for (int i = lo.x; i <= hi.x; ++i) {
-                                    if (ifab(i,j,k) == 0) {
-                                        vvmin[ivar] = std::min(fab(i,j,k),vvmin[ivar]);
-                                        vvmax[ivar] = std::max(fab(i,j,k),vvmax[ivar]);
-                                    }
-                                }
-                            }
-                        }
+                cfba = amrex::coarsen(pf.boxArray(ilev+1), ratio);
+            }
+            Vector<int> local_grids;
+            Vector<BoxList> uncovered;
+            for (int i = 0, N = ba.size(); i < N; ++i) {
+                if (dm[i] == ParallelDescriptor::MyProc()) {
+                    local_grids.push_back(i);
+                    uncovered.push_back(cfba.empty() ? BoxList(ba[i]) : cfba.complementIn(ba[i]));
+                }
+            }
+            const int nlocal = local_grids.size();
+
+            // Only one component of one grid is in memory at a time.
+            for (int ivar = 0; ivar < var_names.size(); ++ivar) {
+                ReduceOps<ReduceOpMin, ReduceOpMax> reduce_op;
+                ReduceData<Real, Real> reduce_data(reduce_op);
+                using ReduceTuple = typename decltype(reduce_data)::Type;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic) if (Gpu::notInLaunchRegion())
+#endif
+                for (int igrid = 0; igrid < nlocal; ++igrid) {
+                    if (uncovered[igrid].isEmpty()) { continue; }
+                    const FArrayBox& fab = pf.get(ilev, ba[local_grids[igrid]], var_names[ivar]);
+                    const auto& a = fab.const_array();
+                    for (const Box& bx : uncovered[igrid]) {
+                        reduce_op.eval(bx, reduce_data,
+                        [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                        {
+                            return {a(i,j,k), a(i,j,k)};
+                        });
                     }
                 }
+                auto hv = reduce_data.value(reduce_op);
+                vvmin[ivar] = std::min(vvmin[ivar], amrex::get<0>(hv));
+                vvmax[ivar] = std::max(vvmax[ivar], amrex::get<1>(hv));
             }
         }
 
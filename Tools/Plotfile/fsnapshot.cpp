@@ -198,65 +198,61 @@ void main_main()
     Real gmx = std::numeric_limits<Real>::lowest();
     Real gmn = std::numeric_limits<Real>::max();
 
+    // Only the planes are read from the plotfile.  The min and max come
+    // from the VisMF headers if they are there.
     for (int ilev = 0; ilev <= max_level; ++ilev) {
-        const MultiFab& pltmf = pf.get(ilev, compname);
-        gmx = std::max(gmx, pltmf.max(0));
-        gmn = std::min(gmn, pltmf.min(0));
+        const auto mm = pf.minmax(ilev, compname);
+        gmn = std::min(gmn, mm.first);
+        gmx = std::max(gmx, mm.second);
+        IntVect ratio{1};
         if (ilev < max_level) {
-            IntVect ratio{pf.refRatio(ilev)};
+            ratio = IntVect{pf.refRatio(ilev)};
             for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
                 ratio[idim] = 1;
             }
-            const iMultiFab mask = makeFineMask(pltmf, pf.boxArray(ilev+1), ratio);
-            for (MFIter mfi(pltmf); mfi.isValid(); ++mfi) {
-                const auto& m = mask.array(mfi);
-                const auto& plt = pltmf.array(mfi);
-                const Box& bx = mfi.validbox();
-                IntVect rrlev {rr[ilev]};
-                for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
-                    rrlev[idim] = 1;
-                }
-                for (int idir = ndir_begin; idir < ndir_end; ++idir) {
-                    const Box& crsebox = amrex::coarsen(finebox[idir], rrlev);
-                    const Box& ibox = bx & crsebox;
-                    if (ibox.ok()) {
-                        const auto& data = datamf[idir].array(0); // there is only one box
-                        IntVect rrslice = rrlev;
-                        rrslice[idir] = 1;
-                        amrex::For(ibox, [=] AMREX_GPU_DEVICE (int i, int j, int k)
-                        {
-                            if (m(i,j,k) == 0) { // not covered by fine
-                                const Real d = plt(i,j,k);
-                                for         (int koff = 0; koff < rrslice[2]; ++koff) {
-                                    int kk = k*rrlev[2] + koff;
-                                    for     (int joff = 0; joff < rrslice[1]; ++joff) {
-                                        int jj = j*rrlev[1] + joff;
-                                        for (int ioff = 0; ioff < rrslice[0]; ++ioff) {
-                                            int ii = i*rrlev[0] + ioff;
-                                            data(ii,jj,kk) = d;
-                                        }
-                                    }
-                                }
-                            }
-                        });
-                    }
+        }
+        IntVect rrlev {rr[ilev]};
+        for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
+            rrlev[idim] = 1;
+        }
+        for (int idir = ndir_begin; idir < ndir_end; ++idir) {
+            const Box& crsebox = amrex::coarsen(finebox[idir], rrlev);
+            const FArrayBox& pltfab = pf.get(ilev, crsebox, compname);
+            BaseFab<int> maskfab(crsebox, 1);
+            maskfab.setVal<RunOn::Host>(1); // 1: not covered by any grid on this level
+            for (auto const& is : pf.boxArray(ilev).intersections(crsebox)) {
+                maskfab.setVal<RunOn::Host>(0, is.second);
+            }
+            if (ilev < max_level) {
+                const BoxArray& cfba = amrex::coarsen(pf.boxArray(ilev+1), ratio);
+                for (auto const& is : cfba.intersections(crsebox)) {
+                    maskfab.setVal<RunOn::Host>(1, is.second);
                 }
             }
-        } else {
-            for (MFIter mfi(pltmf); mfi.isValid(); ++mfi) {
-                const auto& plt = pltmf.array(mfi);
-                const Box& bx = mfi.validbox();
-                for (int idir = ndir_begin; idir < ndir_end; ++idir) {
-                    const Box& ibox = bx & finebox[idir];
-                    if (ibox.ok()) {
-                        const auto& data = datamf[idir].array(0); // there is only one box
-                        amrex::ParallelFor(ibox, [=] AMREX_GPU_DEVICE (int i, int j, int k)
-                        {
-                            data(i,j,k) = plt(i,j,k);
-                        });
+            const auto& m = maskfab.const_array();
+            const auto& plt = pltfab.const_array();
+            const auto& data = datamf[idir].array(0); // there is only one box
+            IntVect rrslice = rrlev;
+            rrslice[idir] = 1;
+            // The plane is not necessarily at the low end of the coarse cells.
+            IntVect off{0};
+            off[idir] = finebox[idir].smallEnd(idir) - crsebox.smallEnd(idir)*rrlev[idir];
+            amrex::LoopOnCpu(crsebox, [=] (int i, int j, int k)
+            {
+                if (m(i,j,k) == 0) { // valid and not covered by fine
+                    const Real d = plt(i,j,k);
+                    for         (int koff = 0; koff < rrslice[2]; ++koff) {
+                        int kk = k*rrlev[2] + koff + off[2];
+                        for     (int joff = 0; joff < rrslice[1]; ++joff) {
+                            int jj = j*rrlev[1] + joff + off[1];
+                            for (int ioff = 0; ioff < rrslice[0]; ++ioff) {
+                                int ii = i*rrlev[0] + ioff + off[0];
+                                data(ii,jj,kk) = d;
+                            }
+                        }
                     }
                 }
-            }
+            });
         }
     }
 
@@ -1,7 +1,7 @@
 #include <AMReX.H>
 #include <AMReX_Print.H>
 #include <AMReX_PlotFileUtil.H>
-#include <AMReX_MultiFabUtil.H>
+#include <AMReX_Reduce.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <limits>
 #include <iterator>
@@ -95,100 +95,73 @@ void main_main()
 
         Array<Real,AMREX_SPACEDIM> dx = pf.cellSize(ilev);
 
+        // The parts of the local grids not covered by the next finer level
+        const BoxArray& ba = pf.boxArray(ilev);
+        const DistributionMapping& dm = pf.DistributionMap(ilev);
+        BoxArray cfba;
         if (ilev < fine_level) {
             IntVect ratio{pf.refRatio(ilev)};
             for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
                 ratio[idim] = 1;
             }
-            const iMultiFab mask = makeFineMask(pf.boxArray(ilev), pf.DistributionMap(ilev),
-                                                pf.boxArray(ilev+1), ratio);
-            const MultiFab& mf = pf.get(ilev, var_name);
-            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                const Box& bx = mfi.validbox();
-                if (bx.ok()) {
-                    const auto& m = mask.array(mfi);
-                    const auto& fab = mf.array(mfi);
-                    const auto lo = amrex::lbound(bx);
-                    const auto hi = amrex::ubound(bx);
-                    for (int k = lo.z; k <= hi.z; ++k) {
-                        for (int j = lo.y; j <= hi.y; ++j) {
-                            for (int i = lo.x; i <= hi.x; ++i) {
-                                if (m(i,j,k) == 0) { // not covered by fine
-                                    Array<Real,AMREX_SPACEDIM> p
-                                        = {AMREX_D_DECL(problo[0]+static_cast<Real>(i+0.5)*dx[0],
-                                                        problo[1]+static_cast<Real>(j+0.5)*dx[1],
-                                                        problo[2]+static_cast<Real>(k+0.5)*dx[2])};
-
-                                    // compute the volume
-                                    Real vol = std::numeric_limits<Real>::quiet_NaN();
-                                    if (coord == 0) {
-                                        // Cartesian
-                                        vol = 1.0_rt;
-                                        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-                                            vol *= dx[idim];
-                                        }
-                                    } else if (coord == 1) {
-                                        // axisymmetric V = pi (r_r**2 - r_l**2) * dz
-                                        //                = pi dr * dz * (r_r + r_l)
-                                        //                = 2 pi r dr dz
-                                        vol = 2 * pi * p[0] * dx[0] * dx[1];
-                                    } else if (coord == 2) {
-                                        // 1-d spherical V = 4/3 pi (r_r**3 - r_l**3)
-                                        Real r_r = problo[0]+static_cast<Real>(i+1)*dx[0];
-                                        Real r_l = problo[0]+static_cast<Real>(i)*dx[0];
-                                        vol = (4.0_rt/3.0_rt) * pi * dx[0] * (r_r*r_r + r_l*r_r + r_l*r_l);
-                                    }
-
-                                    lsum += fab(i,j,k) * vol;
-                                }
-                            }
-                        }
-                    }
-                }
+            cfba = amrex::coarsen(pf.boxArray(ilev+1), ratio);
+        }
+        Vector<int> local_grids;
+        Vector<BoxList> uncovered;
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            if (dm[i] == ParallelDescriptor::MyProc()) {
+                local_grids.push_back(i);
+                uncovered.push_back(cfba.empty() ? BoxList(ba[i]) : cfba.complementIn(ba[i]));
             }
-        } else {
-            const MultiFab& mf = pf.get(ilev, var_name);
-            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                const Box& bx = mfi.validbox();
-                if (bx.ok()) {
-                    const auto& fab = mf.array(mfi);
-                    const auto lo = amrex::lbound(bx);
-                    const auto hi = amrex::ubound(bx);
-                    for (int k = lo.z; k <= hi.z; ++k) {
-                        for (int j = lo.y; j <= hi.y; ++j) {
-                            for (int i = lo.x; i <= hi.x; ++i) {
-                                Array<Real,AMREX_SPACEDIM> p
-                                    = {AMREX_D_DECL(problo[0]+static_cast<Real>(i+0.5)*dx[0],
-                                                    problo[1]+static_cast<Real>(j+0.5)*dx[1],
-                                                    problo[2]+static_cast<Real>(k+0.5)*dx[2])};
-
-                                    // compute the volume
-                                    Real vol = std::numeric_limits<Real>::quiet_NaN();
-                                    if (coord == 0) {
-                                        // Cartesian
-                                        vol = 1.0_rt;
-                                        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-                                            vol *= dx[idim];
-                                        }
-                                    } else if (coord == 1) {
-                                        // axisymmetric V = pi (r_r**2 - r_l**2) * dz
-                                        //                = pi dr * dz * (r_r + r_l)
-                                        //                = 2 pi r dr dz
-                                        vol = 2 * pi * p[0] * dx[0] * dx[1];
-                                    } else if (coord == 2) {
-                                        // 1-d spherical V = 4/3 pi (r_r**3 - r_l**3)
-                                        Real r_r = problo[0]+static_cast<Real>(i+1)*dx[0];
-                                        Real r_l = problo[0]+static_cast<Real>(i)*dx[0];
-                                        vol = (4.0_rt/3.0_rt) * pi * dx[0] * (r_r*r_r + r_l*r_r + r_l*r_l);
-                                    }
-
-                                    lsum += fab(i,j,k) * vol;
-                            }
+        }
+        const int nlocal = local_grids.size();
+
+        // Only one grid is in memory at a time.
+        ReduceOps<ReduceOpSum> reduce_op;
+        ReduceData<Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic) if (Gpu::notInLaunchRegion())
+#endif
+        for (int igrid = 0; igrid < nlocal; ++igrid) {
+            if (uncovered[igrid].isEmpty()) { continue; }
+            const FArrayBox& fab = pf.get(ilev, ba[local_grids[igrid]], var_name);
+            const auto& a = fab.const_array();
+            for (const Box& bx : uncovered[igrid]) {
+                reduce_op.eval(bx, reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                {
+                    amrex::ignore_unused(j,k);
+                    Array<Real,AMREX_SPACEDIM> p
+                        = {AMREX_D_DECL(problo[0]+static_cast<Real>(i+0.5)*dx[0],
+                                        problo[1]+static_cast<Real>(j+0.5)*dx[1],
+                                        problo[2]+static_cast<Real>(k+0.5)*dx[2])};
+
+                    // compute the volume
+                    Real vol = std::numeric_limits<Real>::quiet_NaN();
+                    if (coord == 0) {
+                        // Cartesian
+                        vol = 1.0_rt;
+                        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                            vol *= dx[idim];
                         }
+                    } else if (coord == 1) {
+                        // axisymmetric V = pi (r_r**2 - r_l**2) * dz
+                        //                = pi dr * dz * (r_r + r_l)
+                        //                = 2 pi r dr dz
+                        vol = 2 * pi * p[0] * dx[0] * dx[1];
+                    } else if (coord == 2) {
+                        // 1-d spherical V = 4/3 pi (r_r**3 - r_l**3)
+                        Real r_r = problo[0]+static_cast<Real>(i+1)*dx[0];
+                        Real r_l = problo[0]+static_cast<Real>(i)*dx[0];
+                        vol = (4.0_rt/3.0_rt) * pi * dx[0] * (r_r*r_r + r_l*r_r + r_l*r_l);
                     }
-                }
+
+                    return {a(i,j,k) * vol};
+                });
             }
         }
+        lsum += amrex::get<0>(reduce_data.value(reduce_op));
     }
 
     ParallelDescriptor::ReduceRealSum(lsum);